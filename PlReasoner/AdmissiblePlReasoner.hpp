@@ -36,7 +36,8 @@ using namespace std;
 
 class AdmissiblePlReasoner : public PlReasoner {
 public:
-	AdmissiblePlReasoner(const DungAF& daf, const string& sm_task = "AD", streambuf* osbuff = std::cout.rdbuf()); 
+	AdmissiblePlReasoner(const DungAF& daf, const string& sm_task = "AD", streambuf* osbuff = std::cout.rdbuf(),
+		BackendType backend = CLPB_BACKEND); 
 
 	/**
 	 * Problem [EE-$\sigma$]
@@ -47,6 +48,9 @@ public:
 	void task_EE();
 	void task_EX();
 
+	// Enumerate the extensions, as task_EE() does
+	size_type enumerateExtensions(const ExtensionVisitor& visit);
+
 	/**
 	 * Problem [EC-$\sigma$]
 	 * @brief Given an $\textit{AF}=\left< \mathcal{X}, \mathcal{R}\right>$ and 
@@ -122,6 +126,9 @@ public:
 	 * in each E \in E_\sigma(AF) (i.e., skeptically justified).
 	 */
 	void task_DS(const std::set<string>& argset);
+
+	// Decide the batch concurrently (see PlReasoner::decideBatch())
+	void task_DBatch(const vector< std::set<string> >& queries, bool skeptical);
 protected:
 	string m_predicate;
 };
@@ -129,8 +136,9 @@ protected:
 
 AdmissiblePlReasoner::AdmissiblePlReasoner(
 	const DungAF& daf, const string& sm_task /*= "AD"*/, 
-	streambuf* osbuff /*= std::cout.rdbuf()*/) :
-	PlReasoner(daf, osbuff)
+	streambuf* osbuff /*= std::cout.rdbuf()*/,
+	BackendType backend /*= CLPB_BACKEND*/) :
+	PlReasoner(daf, osbuff, backend, isSparseTask(sm_task))
 {	
 	if (sm_task == "AD") {   // The default predicate
 		m_predicate = "admissible1";
@@ -152,13 +160,22 @@ AdmissiblePlReasoner::AdmissiblePlReasoner(
 	} else
 	if (sm_task == "AD6") {
 		m_predicate = "admissible6";
+	} else
+	if (sm_task == "ADS") {  // The sparse model
+		m_predicate = "admissible_sparse";
 	} else {
 		cerr << "Error: in AdmissiblePlReasoner, unsupported predicate!" << endl;
-		cerr << "  The supported options [AD,AD1,AD2,AD3,AD4,AD5,AD6]" << endl;
+		cerr << "  The supported options [AD,AD1,AD2,AD3,AD4,AD5,AD6,ADS]" << endl;
 		exit(1);
 	}
 }
 
+__inline
+size_type AdmissiblePlReasoner::enumerateExtensions(const ExtensionVisitor& visit)
+{
+	return PlReasoner::enumerateExts(m_predicate, vector<int>(), visit);
+}
+
 __inline
 void AdmissiblePlReasoner::task_EE()
 {
@@ -260,6 +277,16 @@ void AdmissiblePlReasoner::task_DS(const std::set<string>& argset)
 	m_output << STR_NO << endl;
 }
 
+__inline
+void AdmissiblePlReasoner::task_DBatch(const vector< std::set<string> >& queries, bool skeptical)
+{
+	// The problem DS is trivial, see task_DS()
+	if (skeptical)
+		Reasoner::task_DBatch(queries, skeptical);
+	else
+		printDecisions(m_predicate, queries, skeptical);
+}
+
 inline
 void AdmissiblePlReasoner::task_EX()
 {
@@ -0,0 +1,413 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// Solve the constraint models in process with binary decision diagrams
+//=======================================================================
+
+#ifndef ARGUMATRIX_BDD_BACKEND_HPP
+#define ARGUMATRIX_BDD_BACKEND_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+// argumatrix
+#include "config/config.hpp"
+#include "bitmatrix/bitvector.hpp"
+#include "bitmatrix/sparsematrix.hpp"
+#include "ConstraintBackend.hpp"
+#include "BddManager.hpp"
+
+
+namespace argumatrix{
+
+using namespace std;
+
+
+/**
+ * @brief The constraint models of argmat-clpb.pl built and solved in process.
+ * CLP(B) represents the constraints by BDDs as well, so the same formulas are
+ * built here on a BddManager, without converting the attack matrix and the
+ * solutions from and to Prolog terms. Each model is selected by the name of
+ * its Prolog predicate (conflict_free1-3, stable1-2, admissible1-6 and
+ * complete1-6), and the solutions are enumerated in the order of labeling/1.
+ * The fixed entries of a partial assignment are constants in the formulas.
+ */
+class BddBackend : public ConstraintBackend {
+public:
+	/**
+	 * @param atk the attack matrix, whose entry (i,j) is 1 iff j attacks i.
+	 * It must outlive the backend.
+	 */
+	explicit BddBackend(const sparsematrix& atk);
+
+	size_type enumerate(const string& predct, const vector<int>& vecii,
+		const SolutionVisitor& visit);
+	bool isSolution(const string& predct, const bitvector& _bv);
+	bool hasNonempty(const string& predct);
+	bool hasExcluding(const string& predct, const bitvector& _bv);
+	void fetchAll(const string& predct, const SolutionVisitor& visit);
+
+	// Whether the model predct is implemented by this backend
+	static bool isSupported(const string& predct);
+
+private:
+	typedef BddManager::node_type node_type;
+	typedef vector<node_type> bddvec;
+
+	/**
+	 * @brief Clear the manager and create the variables X of the arguments for
+	 * the model predct. The entries 0 and 1 of vecii are constants, the other
+	 * ones (and all of them if vecii is empty) are the variables m_xvars.
+	 */
+	bddvec variables(const string& predct, const vector<int>& vecii);
+
+	/**
+	 * @brief Build the constraint of the model predct on X. The auxiliary
+	 * variables of complete6 are quantified, so the result only depends on X.
+	 */
+	node_type model(const string& predct, const bddvec& X);
+
+	// The rows of the attack matrix times X, i.e., R^+(X)
+	bddvec mvMult(const bddvec& X);
+	// The transpose of the attack matrix times X, i.e., R^-(X)
+	bddvec mvMultT(const bddvec& X);
+	// \neg R^+(X)
+	bddvec neutrality(const bddvec& X);
+	// \neg R^-(X)
+	bddvec nRMinus(const bddvec& X);
+	// Defense(X) = \neg R^+(\neg R^+(X))
+	bddvec defense(const bddvec& X) { return neutrality(neutrality(X)); }
+	bddvec vecNot(const bddvec& X);
+	bddvec vecAnd(const bddvec& X, const bddvec& Y);
+	bddvec vecOr(const bddvec& X, const bddvec& Y);
+
+	// The conjunctions of X_i =< Y_i, X_i =:= Y_i, X_i # Y_i, and X_i
+	node_type allLeq(const bddvec& X, const bddvec& Y);
+	node_type allEqn(const bddvec& X, const bddvec& Y);
+	node_type allXor(const bddvec& X, const bddvec& Y);
+	node_type allSat(const bddvec& X);
+
+	const sparsematrix& m_atk;
+	size_type m_argNum;
+	BddManager m_mgr;
+	vector<size_type> m_xvars;  /**< The BDD variable of each argument */
+};
+
+
+BddBackend::BddBackend(const sparsematrix& atk):
+	m_atk(atk),
+	m_argNum(atk.sizeR())
+{
+
+}
+
+bool BddBackend::isSupported(const string& predct)
+{
+	return predct == "conflict_free1" || predct == "conflict_free2" ||
+		predct == "conflict_free3" ||
+		predct == "stable1" || predct == "stable2" ||
+		predct == "admissible1" || predct == "admissible2" ||
+		predct == "admissible3" || predct == "admissible4" ||
+		predct == "admissible5" || predct == "admissible6" ||
+		predct == "complete1" || predct == "complete2" ||
+		predct == "complete3" || predct == "complete4" ||
+		predct == "complete5" || predct == "complete6" ||
+		predct == "conflict_free_sparse" || predct == "stable_sparse" ||
+		predct == "admissible_sparse" || predct == "complete_sparse";
+}
+
+BddBackend::bddvec BddBackend::variables(const string& predct, const vector<int>& vecii)
+{
+	// complete6 has two auxiliary variables S_i and T_i per argument, which
+	// are placed next to X_i, since the BDDs blow up if they follow all of X
+	size_type _stride = (predct == "complete6") ? 3 : 1;
+	m_mgr.clear(_stride * m_argNum);
+
+	m_xvars.resize(m_argNum);
+	bddvec X(m_argNum);
+	for (size_type i = 0; i < m_argNum; ++i) {
+		m_xvars[i] = _stride * i;
+		if (!vecii.empty() && vecii[i] != 2)
+			X[i] = m_mgr.constant(vecii[i] == 1);
+		else
+			X[i] = m_mgr.ithVar(m_xvars[i]);
+	}
+	return X;
+}
+
+BddBackend::bddvec BddBackend::mvMult(const bddvec& X)
+{
+	bddvec Y(m_argNum);
+	for (size_type i = 0; i < m_argNum; ++i) {
+		node_type _y = BddManager::BDD_FALSE;
+		for (sparsematrix::const_iterator it = m_atk.row_begin(i); it != m_atk.row_end(i); ++it)
+			_y = m_mgr.bddOr(_y, X[*it]);
+		Y[i] = _y;
+	}
+	return Y;
+}
+
+BddBackend::bddvec BddBackend::mvMultT(const bddvec& X)
+{
+	bddvec Y(m_argNum);
+	for (size_type i = 0; i < m_argNum; ++i) {
+		node_type _y = BddManager::BDD_FALSE;
+		for (sparsematrix::const_iterator it = m_atk.col_begin(i); it != m_atk.col_end(i); ++it)
+			_y = m_mgr.bddOr(_y, X[*it]);
+		Y[i] = _y;
+	}
+	return Y;
+}
+
+__inline
+BddBackend::bddvec BddBackend::neutrality(const bddvec& X)
+{
+	return vecNot(mvMult(X));
+}
+
+__inline
+BddBackend::bddvec BddBackend::nRMinus(const bddvec& X)
+{
+	return vecNot(mvMultT(X));
+}
+
+BddBackend::bddvec BddBackend::vecNot(const bddvec& X)
+{
+	bddvec Y(X.size());
+	for (size_type i = 0; i < X.size(); ++i)
+		Y[i] = m_mgr.bddNot(X[i]);
+	return Y;
+}
+
+BddBackend::bddvec BddBackend::vecAnd(const bddvec& X, const bddvec& Y)
+{
+	bddvec Z(X.size());
+	for (size_type i = 0; i < X.size(); ++i)
+		Z[i] = m_mgr.bddAnd(X[i], Y[i]);
+	return Z;
+}
+
+BddBackend::bddvec BddBackend::vecOr(const bddvec& X, const bddvec& Y)
+{
+	bddvec Z(X.size());
+	for (size_type i = 0; i < X.size(); ++i)
+		Z[i] = m_mgr.bddOr(X[i], Y[i]);
+	return Z;
+}
+
+BddBackend::node_type BddBackend::allLeq(const bddvec& X, const bddvec& Y)
+{
+	node_type _f = BddManager::BDD_TRUE;
+	for (size_type i = 0; i < X.size() && _f != BddManager::BDD_FALSE; ++i)
+		_f = m_mgr.bddAnd(_f, m_mgr.bddImp(X[i], Y[i]));
+	return _f;
+}
+
+BddBackend::node_type BddBackend::allEqn(const bddvec& X, const bddvec& Y)
+{
+	node_type _f = BddManager::BDD_TRUE;
+	for (size_type i = 0; i < X.size() && _f != BddManager::BDD_FALSE; ++i)
+		_f = m_mgr.bddAnd(_f, m_mgr.bddEqv(X[i], Y[i]));
+	return _f;
+}
+
+BddBackend::node_type BddBackend::allXor(const bddvec& X, const bddvec& Y)
+{
+	node_type _f = BddManager::BDD_TRUE;
+	for (size_type i = 0; i < X.size() && _f != BddManager::BDD_FALSE; ++i)
+		_f = m_mgr.bddAnd(_f, m_mgr.bddXor(X[i], Y[i]));
+	return _f;
+}
+
+BddBackend::node_type BddBackend::allSat(const bddvec& X)
+{
+	node_type _f = BddManager::BDD_TRUE;
+	for (size_type i = 0; i < X.size() && _f != BddManager::BDD_FALSE; ++i)
+		_f = m_mgr.bddAnd(_f, X[i]);
+	return _f;
+}
+
+BddBackend::node_type BddBackend::model(const string& predct, const bddvec& X)
+{
+	// The same formulas as the predicates of argmat-clpb.pl. The BDDs are
+	// always built from the sparse matrix, so that the sparse models are the
+	// dense ones they encode
+	if (predct == "conflict_free_sparse") {
+		return model("conflict_free2", X);
+	} else
+	if (predct == "stable_sparse") {
+		return model("stable2", X);
+	} else
+	if (predct == "admissible_sparse") {
+		return model("admissible3", X);
+	} else
+	if (predct == "complete_sparse") {
+		return model("complete5", X);
+	} else
+	if (predct == "conflict_free1") {
+		bddvec Y = mvMult(X);
+		node_type N = BddManager::BDD_FALSE;
+		for (size_type i = 0; i < m_argNum; ++i)
+			N = m_mgr.bddOr(N, m_mgr.bddAnd(X[i], Y[i]));
+		return m_mgr.bddNot(N);
+	} else
+	if (predct == "conflict_free2") {
+		return allLeq(X, neutrality(X));
+	} else
+	if (predct == "conflict_free3") {
+		return allSat(vecOr(vecNot(X), neutrality(X)));
+	} else
+	if (predct == "stable1") {
+		return allEqn(X, neutrality(X));
+	} else
+	if (predct == "stable2") {
+		return allXor(X, mvMult(X));
+	} else
+	if (predct == "admissible1") {
+		node_type _cf = model("conflict_free2", X);
+		return m_mgr.bddAnd(_cf, allLeq(X, defense(X)));
+	} else
+	if (predct == "admissible2") {
+		node_type _cf = model("conflict_free2", X);
+		return m_mgr.bddAnd(_cf, allLeq(mvMultT(X), mvMult(X)));
+	} else
+	if (predct == "admissible3") {
+		bddvec Y = neutrality(X);
+		bddvec Z = neutrality(Y);
+		return allLeq(X, vecAnd(Y, Z));
+	} else
+	if (predct == "admissible4") {
+		bddvec Z = vecAnd(X, neutrality(X));
+		return allLeq(X, defense(Z));
+	} else
+	if (predct == "admissible5") {
+		bddvec Z = neutrality(vecOr(X, neutrality(X)));
+		return allSat(vecOr(vecNot(X), Z));
+	} else
+	if (predct == "admissible6") {
+		bddvec Y = mvMult(X);
+		node_type _f = allLeq(Y, vecNot(X));
+		return m_mgr.bddAnd(_f, allLeq(mvMultT(X), Y));
+	} else
+	if (predct == "complete1") {
+		node_type _cf = model("conflict_free2", X);
+		return m_mgr.bddAnd(_cf, allEqn(X, defense(X)));
+	} else
+	if (predct == "complete2") {
+		bddvec Y = neutrality(X);
+		bddvec Z = neutrality(Y);
+		return allEqn(X, vecAnd(Y, Z));
+	} else
+	if (predct == "complete3") {
+		bddvec Z = vecAnd(X, neutrality(X));
+		return allEqn(X, defense(Z));
+	} else
+	if (predct == "complete4") {
+		bddvec Z = vecOr(X, neutrality(X));
+		return allEqn(X, neutrality(Z));
+	} else
+	if (predct == "complete5") {
+		bddvec Z = vecOr(X, neutrality(X));
+		return allXor(mvMult(Z), X);
+	} else
+	if (predct == "complete6") {
+		// The auxiliary sets S and T, see variables()
+		bddvec S(m_argNum), T(m_argNum);
+		vector<bool> _aux(m_mgr.varNum(), true);
+		for (size_type i = 0; i < m_argNum; ++i) {
+			S[i] = m_mgr.ithVar(m_xvars[i] + 1);
+			T[i] = m_mgr.ithVar(m_xvars[i] + 2);
+			_aux[m_xvars[i]] = false;
+		}
+
+		bddvec X1 = nRMinus(X);
+		bddvec X2 = neutrality(X);
+		bddvec Z = neutrality(X2);
+		bddvec Y1 = vecAnd(X1, X2);
+		bddvec Xu = vecAnd(X1, Z);
+		bddvec Yu = vecOr(X1, X2);
+
+		node_type _f = allLeq(S, Xu);
+		_f = m_mgr.bddAnd(_f, allLeq(T, Yu));
+		_f = m_mgr.bddAnd(_f, allLeq(Y1, T));
+		bddvec V3 = defense(vecAnd(vecOr(X, S), T));
+		_f = m_mgr.bddAnd(_f, allEqn(X, V3));
+
+		return m_mgr.exists(_f, _aux);
+	}
+
+	cerr << "Error: in BddBackend, unsupported predicate [" << predct << "]!" << endl;
+	exit(1);
+}
+
+size_type BddBackend::enumerate(const string& predct, const vector<int>& vecii,
+	const SolutionVisitor& visit)
+{
+	node_type _f = model(predct, variables(predct, vecii));
+
+	// The fixed arguments are constants in _f, bind their variables as well,
+	// otherwise both of their values would be enumerated
+	if (!vecii.empty()) {
+		for (size_type i = m_argNum; i-- > 0; ) {
+			if (vecii[i] == 1)
+				_f = m_mgr.bddAnd(_f, m_mgr.ithVar(m_xvars[i]));
+			else if (vecii[i] == 0)
+				_f = m_mgr.bddAnd(_f, m_mgr.bddNot(m_mgr.ithVar(m_xvars[i])));
+		}
+	}
+
+	size_type _num = 0;
+	SolutionVisitor _counter = [&](const bitvector& _bv) {
+		++_num;
+		return visit(_bv);
+	};
+	m_mgr.enumerate(_f, m_xvars, _counter);
+	return _num;
+}
+
+bool BddBackend::isSolution(const string& predct, const bitvector& _bv)
+{
+	vector<int> _vecii(m_argNum);
+	for (size_type i = 0; i < m_argNum; ++i)
+		_vecii[i] = _bv[i] ? 1 : 0;
+
+	return model(predct, variables(predct, _vecii)) != BddManager::BDD_FALSE;
+}
+
+bool BddBackend::hasNonempty(const string& predct)
+{
+	bddvec X = variables(predct, vector<int>());
+	node_type _f = model(predct, X);
+
+	// sat(+X)
+	node_type _nonempty = BddManager::BDD_FALSE;
+	for (size_type i = 0; i < m_argNum; ++i)
+		_nonempty = m_mgr.bddOr(_nonempty, X[i]);
+
+	return m_mgr.bddAnd(_f, _nonempty) != BddManager::BDD_FALSE;
+}
+
+bool BddBackend::hasExcluding(const string& predct, const bitvector& _bv)
+{
+	bddvec X = variables(predct, vector<int>());
+	node_type _f = model(predct, X);
+
+	// c_exclusion(Y, X): some argument of _bv is not in X
+	node_type _excl = BddManager::BDD_FALSE;
+	for (size_type i = _bv.find_first(); i != bitvector::npos; i = _bv.find_next(i))
+		_excl = m_mgr.bddOr(_excl, m_mgr.bddNot(X[i]));
+
+	return m_mgr.bddAnd(_f, _excl) != BddManager::BDD_FALSE;
+}
+
+__inline
+void BddBackend::fetchAll(const string& predct, const SolutionVisitor& visit)
+{
+	enumerate(predct, vector<int>(), visit);
+}
+
+} // namespace argumatrix
+
+#endif  // ARGUMATRIX_BDD_BACKEND_HPP
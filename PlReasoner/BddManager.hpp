@@ -0,0 +1,333 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// A small reduced ordered binary decision diagram (ROBDD) package
+//=======================================================================
+
+#ifndef ARGUMATRIX_BDD_MANAGER_HPP
+#define ARGUMATRIX_BDD_MANAGER_HPP
+
+#include <assert.h>
+#include <vector>
+
+#include "config/config.hpp"
+#include "bitmatrix/bitvector.hpp"
+
+
+namespace argumatrix{
+
+using namespace std;
+
+/**
+ * @brief A reduced ordered binary decision diagram package, which is the data
+ * structure behind the CLP(B) library of SWI-Prolog. The variables are ordered
+ * by their indices, the nodes are hash-consed in a unique table, so that two
+ * equivalent functions are the same node, and the results of the operations
+ * are memorized in a direct-mapped cache. The nodes are never freed, call
+ * clear() to reuse the manager for another problem.
+ * ~~~~~{.cpp}
+ *   BddManager mgr(2);
+ *   BddManager::node_type f = mgr.bddAnd(mgr.ithVar(0), mgr.bddNot(mgr.ithVar(1)));
+ * ~~~~~
+ */
+class BddManager {
+public:
+	typedef unsigned int node_type;
+
+	static const node_type BDD_FALSE = 0;
+	static const node_type BDD_TRUE = 1;
+
+	explicit BddManager(size_type num_vars = 0);
+
+	/**
+	 * @brief Remove all the nodes but the terminals, and set the number of
+	 * variables.
+	 */
+	void clear(size_type num_vars);
+
+	size_type varNum() const { return m_varNum; }
+	size_type nodeNum() const { return m_nodes.size(); }
+
+	// The variable of a node, varNum() for the terminals
+	size_type var(node_type f) const { return m_nodes[f].var; }
+	node_type low(node_type f) const { return m_nodes[f].low; }
+	node_type high(node_type f) const { return m_nodes[f].high; }
+	bool isTerminal(node_type f) const { return f <= BDD_TRUE; }
+
+	// The function of the v-th variable
+	node_type ithVar(size_type v);
+
+	node_type constant(bool b) const { return b ? BDD_TRUE : BDD_FALSE; }
+	node_type bddNot(node_type f) { return apply(OP_XOR, f, BDD_TRUE); }
+	node_type bddAnd(node_type f, node_type g) { return apply(OP_AND, f, g); }
+	node_type bddOr(node_type f, node_type g) { return apply(OP_OR, f, g); }
+	node_type bddXor(node_type f, node_type g) { return apply(OP_XOR, f, g); }
+	// f =< g, i.e., ~f + g
+	node_type bddImp(node_type f, node_type g) { return apply(OP_IMP, f, g); }
+	// f =:= g
+	node_type bddEqv(node_type f, node_type g) { return bddNot(bddXor(f, g)); }
+
+	/**
+	 * @brief The existential quantification of the variables v with quant[v]
+	 * set, i.e., the disjunction of the cofactors of f on them.
+	 */
+	node_type exists(node_type f, const vector<bool>& quant);
+
+	/**
+	 * @brief Enumerate the satisfying assignments of f over the variables vars,
+	 * in the order of the labeling of CLP(B): the variables are assigned in
+	 * the order of vars, and 0 is tried before 1. The variables which f does
+	 * not depend on are enumerated as well.
+	 * @param vars the variables in ascending order, f must not depend on the
+	 * other variables.
+	 * @param visit a functor called with each assignment (a bitvector whose
+	 * bit k is the value of vars[k]), which returns false to stop.
+	 * @return false if the enumeration was stopped by visit.
+	 */
+	template<class Visitor>
+	bool enumerate(node_type f, const vector<size_type>& vars, Visitor& visit) const;
+
+private:
+	enum { OP_AND, OP_OR, OP_XOR, OP_IMP };
+
+	struct Node {
+		size_type var;
+		node_type low;
+		node_type high;
+	};
+
+	struct CacheEntry {
+		int op;
+		node_type f;
+		node_type g;
+		node_type res;
+	};
+
+	// Get the node (v, lo, hi) from the unique table, or create it
+	node_type makeNode(size_type v, node_type lo, node_type hi);
+
+	node_type apply(int op, node_type f, node_type g);
+
+	node_type exists(node_type f, const vector<bool>& quant, vector<node_type>& memo);
+
+	template<class Visitor>
+	bool enumerate(node_type f, const vector<size_type>& vars, size_type k,
+		bitvector& bv, Visitor& visit) const;
+
+	size_type hashNode(size_type v, node_type lo, node_type hi) const;
+	void growTable();
+
+	size_type m_varNum;
+	vector<Node> m_nodes;
+	vector<node_type> m_table;   /**< The unique table, open addressing, 0 is empty */
+	vector<CacheEntry> m_cache;  /**< The computed table */
+};
+
+
+BddManager::BddManager(size_type num_vars /*= 0*/)
+{
+	clear(num_vars);
+}
+
+void BddManager::clear(size_type num_vars)
+{
+	m_varNum = num_vars;
+
+	m_nodes.clear();
+	Node _terminal = { num_vars, BDD_FALSE, BDD_FALSE };
+	m_nodes.push_back(_terminal);   // BDD_FALSE
+	_terminal.low = _terminal.high = BDD_TRUE;
+	m_nodes.push_back(_terminal);   // BDD_TRUE
+
+	m_table.assign(1 << 12, 0);
+	CacheEntry _empty = { -1, 0, 0, 0 };
+	m_cache.assign(1 << 14, _empty);
+}
+
+inline
+BddManager::node_type BddManager::ithVar(size_type v)
+{
+	assert(v < m_varNum);
+	return makeNode(v, BDD_FALSE, BDD_TRUE);
+}
+
+inline
+size_type BddManager::hashNode(size_type v, node_type lo, node_type hi) const
+{
+	size_type _h = v * 12582917u + lo * 4256249u + hi * 741103597u;
+	return (_h ^ (_h >> 15)) & (m_table.size() - 1);
+}
+
+void BddManager::growTable()
+{
+	m_table.assign(m_table.size() * 2, 0);
+	for (node_type k = BDD_TRUE + 1; k < m_nodes.size(); ++k) {
+		size_type _pos = hashNode(m_nodes[k].var, m_nodes[k].low, m_nodes[k].high);
+		while (m_table[_pos] != 0)
+			_pos = (_pos + 1) & (m_table.size() - 1);
+		m_table[_pos] = k;
+	}
+
+	// Keep the cache in proportion to the nodes, up to 2^23 entries
+	if (m_cache.size() < m_table.size() && m_cache.size() < (1 << 23)) {
+		CacheEntry _empty = { -1, 0, 0, 0 };
+		m_cache.assign(m_table.size(), _empty);
+	}
+}
+
+BddManager::node_type BddManager::makeNode(size_type v, node_type lo, node_type hi)
+{
+	if (lo == hi)
+		return lo;
+
+	size_type _pos = hashNode(v, lo, hi);
+	while (m_table[_pos] != 0) {
+		const Node& _nd = m_nodes[m_table[_pos]];
+		if (_nd.var == v && _nd.low == lo && _nd.high == hi)
+			return m_table[_pos];
+		_pos = (_pos + 1) & (m_table.size() - 1);
+	}
+
+	if (m_nodes.size() >= BDD_MAX_NODES) {
+		cerr << "Error: in BddManager, more than " << BDD_MAX_NODES
+			 << " BDD nodes (see BDD_MAX_NODES)!" << endl;
+		exit(1);
+	}
+
+	node_type _k = (node_type)m_nodes.size();
+	Node _nd = { v, lo, hi };
+	m_nodes.push_back(_nd);
+	m_table[_pos] = _k;
+
+	// Keep the load factor under 1/2
+	if (m_nodes.size() * 2 > m_table.size())
+		growTable();
+
+	return _k;
+}
+
+BddManager::node_type BddManager::apply(int op, node_type f, node_type g)
+{
+	// The terminal cases
+	switch (op) {
+	case OP_AND:
+		if (f == BDD_FALSE || g == BDD_FALSE) return BDD_FALSE;
+		if (f == BDD_TRUE || f == g) return g;
+		if (g == BDD_TRUE) return f;
+		break;
+	case OP_OR:
+		if (f == BDD_TRUE || g == BDD_TRUE) return BDD_TRUE;
+		if (f == BDD_FALSE || f == g) return g;
+		if (g == BDD_FALSE) return f;
+		break;
+	case OP_XOR:
+		if (f == g) return BDD_FALSE;
+		if (f == BDD_FALSE) return g;
+		if (g == BDD_FALSE) return f;
+		break;
+	case OP_IMP:
+		if (f == BDD_FALSE || g == BDD_TRUE || f == g) return BDD_TRUE;
+		if (f == BDD_TRUE) return g;
+		break;
+	}
+
+	// The commutative operations
+	if (op != OP_IMP && f > g)
+		std::swap(f, g);
+
+	size_type _slot = (f * 2654435761u + g * 40503u + op) & (m_cache.size() - 1);
+	if (m_cache[_slot].op == op && m_cache[_slot].f == f && m_cache[_slot].g == g)
+		return m_cache[_slot].res;
+
+	size_type _vf = var(f), _vg = var(g);
+	size_type _v = min(_vf, _vg);
+	// The cofactors, note that m_nodes may be reallocated by the recursion
+	node_type _f0 = (_vf == _v) ? low(f) : f;
+	node_type _f1 = (_vf == _v) ? high(f) : f;
+	node_type _g0 = (_vg == _v) ? low(g) : g;
+	node_type _g1 = (_vg == _v) ? high(g) : g;
+
+	node_type _lo = apply(op, _f0, _g0);
+	node_type _hi = apply(op, _f1, _g1);
+	node_type _res = makeNode(_v, _lo, _hi);
+
+	// The cache may have been reallocated by the recursion
+	_slot = (f * 2654435761u + g * 40503u + op) & (m_cache.size() - 1);
+	CacheEntry _ent = { op, f, g, _res };
+	m_cache[_slot] = _ent;
+
+	return _res;
+}
+
+BddManager::node_type BddManager::exists(node_type f, const vector<bool>& quant)
+{
+	// The results of the nodes, BDD_TRUE + 1 if not computed yet
+	vector<node_type> _memo(m_nodes.size(), BDD_TRUE + 1);
+	return exists(f, quant, _memo);
+}
+
+BddManager::node_type BddManager::exists(node_type f, const vector<bool>& quant,
+	vector<node_type>& memo)
+{
+	if (isTerminal(f))
+		return f;
+	if (memo[f] != BDD_TRUE + 1)
+		return memo[f];
+
+	size_type _v = var(f);
+	node_type _hi = high(f);
+	node_type _lo = exists(low(f), quant, memo);
+
+	node_type _res;
+	if (quant[_v]) {
+		// The disjunction of the cofactors, which is BDD_TRUE as soon as one
+		// of them is
+		_res = (_lo == BDD_TRUE) ? BDD_TRUE : bddOr(_lo, exists(_hi, quant, memo));
+	} else {
+		_res = makeNode(_v, _lo, exists(_hi, quant, memo));
+	}
+
+	memo[f] = _res;
+	return _res;
+}
+
+template<class Visitor>
+bool BddManager::enumerate(node_type f, const vector<size_type>& vars, Visitor& visit) const
+{
+	bitvector _bv(vars.size());
+	return enumerate(f, vars, 0, _bv, visit);
+}
+
+template<class Visitor>
+bool BddManager::enumerate(node_type f, const vector<size_type>& vars, size_type k,
+	bitvector& bv, Visitor& visit) const
+{
+	// In a reduced BDD, every node but BDD_FALSE has a satisfying assignment,
+	// so there is no dead end.
+	if (f == BDD_FALSE)
+		return true;
+
+	if (k == vars.size())
+		return visit(bv);
+
+	// The variable is not tested by f, both values are solutions
+	node_type _f0 = f, _f1 = f;
+	if (var(f) == vars[k]) {
+		_f0 = low(f);
+		_f1 = high(f);
+	}
+
+	bv.reset(k);
+	if (!enumerate(_f0, vars, k + 1, bv, visit))
+		return false;
+
+	bv.set(k);
+	bool _continue = enumerate(_f1, vars, k + 1, bv, visit);
+	bv.reset(k);
+	return _continue;
+}
+
+} // namespace argumatrix
+
+#endif  // ARGUMATRIX_BDD_MANAGER_HPP
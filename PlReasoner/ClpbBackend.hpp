@@ -0,0 +1,438 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// Solve the constraint models by the CLP(B) library of SWI-Prolog
+//=======================================================================
+
+#ifndef ARGUMATRIX_CLPB_BACKEND_HPP
+#define ARGUMATRIX_CLPB_BACKEND_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <tuple>
+#include <mutex>
+#include <stdint.h>
+#include <limits.h>
+
+// argumatrix
+#include "config/config.hpp"
+#include "bitmatrix/bitvector.hpp"
+#include "bitmatrix/bitmatrix.hpp"
+#include "bitmatrix/sparsematrix.hpp"
+#include "ConstraintBackend.hpp"
+
+// SWI-prolog
+#include <SWI-cpp.h>
+#include "swipl-util.hpp"
+#include "PlEnginePool.hpp"
+
+
+namespace argumatrix{
+
+using namespace std;
+
+
+// typedef PlTimeQry ClpbQry;
+typedef PlQuery ClpbQry;
+
+
+/**
+ * @brief The attack matrix terms of the frameworks, shared by all the
+ * reasoners (and thus the tasks) of the same framework. A term is built once
+ * per revision of the framework (see DungAF::getRevision()), per engine,
+ * since the terms are local to an engine, and per form, i.e., the 0/1 matrix
+ * of the dense models or the attacker lists of the sparse models. The terms
+ * must be built outside of any foreign frame, and are kept until the
+ * revision is evicted by its owner, e.g., when the framework is unloaded.
+ * ~~~~~{.cpp}
+ *   term_t _mtx = PlMatrixTermCache::instance().get(daf.getRevision(), atk);
+ *   ...
+ *   PlMatrixTermCache::instance().evict(daf.getRevision());
+ * ~~~~~
+ */
+class PlMatrixTermCache {
+public:
+	static PlMatrixTermCache& instance();
+
+	/**
+	 * @brief The term of the attack matrix atk of the framework of the given
+	 * revision, on the engine of the calling thread.
+	 */
+	term_t get(uint64_t revision, const bitmatrix& atk);
+
+	/**
+	 * @brief The term of the attacker lists of atk (see
+	 * sparsematrix2attackerListTerm()), on the engine of the calling thread.
+	 */
+	term_t get(uint64_t revision, const sparsematrix& atk);
+
+	/**
+	 * @brief The term of the 0/1 matrix of atk, the same as get() of its
+	 * bitmatrix, for the frameworks whose bitmatrix is not built.
+	 */
+	term_t getMatrix(uint64_t revision, const sparsematrix& atk);
+
+	/**
+	 * @brief Forget the terms of the framework of the given revision, on all
+	 * the engines. A term can only be reset by its own engine, so that the
+	 * term references are reset by the next get() on their engine, which
+	 * lets the garbage collector of Prolog reclaim the matrices, and then
+	 * reused for the next terms of the engine.
+	 */
+	void evict(uint64_t revision);
+
+private:
+	PlMatrixTermCache() {}
+
+	// The revision, the engine slot (see PlEnginePool), and whether the term
+	// is the attacker lists
+	typedef std::tuple<uint64_t, int, bool> key_type;
+
+	bool find(const key_type& _key, term_t& _term);
+	void insert(const key_type& _key, term_t _term);
+
+	// A term reference of the engine _slot for a new term, a released one
+	// if any; the evicted ones of the engine are reset before
+	term_t newTerm(int _slot);
+
+	std::mutex m_mtx;
+	map< key_type, term_t > m_terms;
+	map< int, vector<term_t> > m_evicted;   /**< The evicted terms by engine */
+	map< int, vector<term_t> > m_released;  /**< The reset references by engine */
+};
+
+
+PlMatrixTermCache& PlMatrixTermCache::instance()
+{
+	static PlMatrixTermCache _cache;
+	return _cache;
+}
+
+bool PlMatrixTermCache::find(const key_type& _key, term_t& _term)
+{
+	std::lock_guard<std::mutex> _lock(m_mtx);
+	map< key_type, term_t >::iterator _itr = m_terms.find(_key);
+	if (_itr == m_terms.end())
+		return false;
+	_term = _itr->second;
+	return true;
+}
+
+void PlMatrixTermCache::insert(const key_type& _key, term_t _term)
+{
+	std::lock_guard<std::mutex> _lock(m_mtx);
+	m_terms[_key] = _term;
+}
+
+void PlMatrixTermCache::evict(uint64_t revision)
+{
+	std::lock_guard<std::mutex> _lock(m_mtx);
+	map< key_type, term_t >::iterator _itr = m_terms.lower_bound(key_type(revision, INT_MIN, false));
+	while (_itr != m_terms.end() && std::get<0>(_itr->first) == revision) {
+		m_evicted[std::get<1>(_itr->first)].push_back(_itr->second);
+		m_terms.erase(_itr++);
+	}
+}
+
+term_t PlMatrixTermCache::newTerm(int _slot)
+{
+	std::lock_guard<std::mutex> _lock(m_mtx);
+	vector<term_t>& _evicted = m_evicted[_slot];
+	vector<term_t>& _released = m_released[_slot];
+	for (size_type k = 0; k < _evicted.size(); ++k) {
+		PL_put_nil(_evicted[k]);  // The matrix is garbage now
+		_released.push_back(_evicted[k]);
+	}
+	_evicted.clear();
+
+	if (_released.empty())
+		return PL_new_term_ref();
+	term_t _term = _released.back();
+	_released.pop_back();
+	return _term;
+}
+
+term_t PlMatrixTermCache::get(uint64_t revision, const bitmatrix& atk)
+{
+	key_type _key(revision, PlEnginePool::currentSlot(), false);
+	term_t _mtx;
+	if (find(_key, _mtx))
+		return _mtx;
+
+	// Only the thread bound to the engine builds its term, out of the lock
+	StatTimerScope _timer(TIMER_TERM_BUILD);
+	_mtx = newTerm(std::get<1>(_key));
+	bitmatrix2plmatrixTerm(atk, _mtx);
+	insert(_key, _mtx);
+	return _mtx;
+}
+
+term_t PlMatrixTermCache::get(uint64_t revision, const sparsematrix& atk)
+{
+	key_type _key(revision, PlEnginePool::currentSlot(), true);
+	term_t _adj;
+	if (find(_key, _adj))
+		return _adj;
+
+	StatTimerScope _timer(TIMER_TERM_BUILD);
+	_adj = newTerm(std::get<1>(_key));
+	sparsematrix2attackerListTerm(atk, _adj);
+	insert(_key, _adj);
+	return _adj;
+}
+
+term_t PlMatrixTermCache::getMatrix(uint64_t revision, const sparsematrix& atk)
+{
+	key_type _key(revision, PlEnginePool::currentSlot(), false);
+	term_t _mtx;
+	if (find(_key, _mtx))
+		return _mtx;
+
+	StatTimerScope _timer(TIMER_TERM_BUILD);
+	_mtx = newTerm(std::get<1>(_key));
+	sparsematrix2plmatrixTerm(atk, _mtx);
+	insert(_key, _mtx);
+	return _mtx;
+}
+
+
+/**
+ * @brief The constraint models solved by the predicates of argmat-clpb.pl. The
+ * attack matrix term is taken from the PlMatrixTermCache, i.e., the attacker
+ * lists for the sparse models (the predicates *_sparse), and the 0/1 matrix
+ * for the others. Each query
+ * builds the term of the variables, calls the predicate, and then the
+ * labeling/1 of CLP(B) to enumerate the solutions, in a PlQueryFrame which
+ * releases its terms when it is done. An exception of Prolog is thrown as a
+ * BackendError. The queries may run concurrently on the engines of the
+ * PlEnginePool.
+ */
+class ClpbBackend : public ConstraintBackend {
+public:
+	/**
+	 * @param atk the dense attack matrix, which may be empty, then the 0/1
+	 * matrix of the dense models is built from spAtk.
+	 * @param spAtk the sparse attack matrix. Both matrices must outlive the
+	 * backend, for the terms of the other engines.
+	 * @param revision the revision of the framework of atk.
+	 */
+	ClpbBackend(const bitmatrix& atk, const sparsematrix& spAtk, uint64_t revision);
+
+	size_type enumerate(const string& predct, const vector<int>& vecii,
+		const SolutionVisitor& visit);
+	bool isSolution(const string& predct, const bitvector& _bv);
+	bool hasNonempty(const string& predct);
+	bool hasExcluding(const string& predct, const bitvector& _bv);
+	void fetchAll(const string& predct, const SolutionVisitor& visit);
+	bool isConcurrent() const { return true; }
+
+private:
+	// Whether predct is a sparse model, which takes the attacker lists
+	static bool isSparseModel(const string& predct);
+
+	// The attack matrix term of the model predct on the engine of the
+	// calling thread, taken before the PlQueryFrame of the query
+	PlTerm atkMatrix(const string& predct);
+
+	/**
+	 * @brief Call labeling/1 on the variables of a solved query, and visit
+	 * the assignments, each in a PlQueryFrame discarded after the visit.
+	 * @return the number of the assignments visited, the enumeration stops
+	 * early when visit returns false.
+	 */
+	size_type labeling(const PlTerm& vars, const SolutionVisitor& visit);
+
+	// The next solution of the query, counted by the RunStats
+	static int nextSolution(ClpbQry& query);
+
+	size_type m_argNum;
+	const bitmatrix& m_atk;
+	const sparsematrix& m_spAtk;
+	uint64_t m_revision;
+};
+
+
+ClpbBackend::ClpbBackend(const bitmatrix& atk, const sparsematrix& spAtk,
+	uint64_t revision):
+	m_argNum(spAtk.sizeR()),
+	m_atk(atk),
+	m_spAtk(spAtk),
+	m_revision(revision)
+{
+	// The terms are built by the first query of each form, since only one of
+	// them is needed by a reasoner
+}
+
+__inline
+bool ClpbBackend::isSparseModel(const string& predct)
+{
+	static const string _suffix = "_sparse";
+	return predct.size() > _suffix.size() &&
+		predct.compare(predct.size() - _suffix.size(), _suffix.size(), _suffix) == 0;
+}
+
+PlTerm ClpbBackend::atkMatrix(const string& predct)
+{
+	try
+	{
+		if (isSparseModel(predct))
+			return PlTerm(PlMatrixTermCache::instance().get(m_revision, m_spAtk));
+
+		if (m_atk.sizeR() != m_argNum)
+			return PlTerm(PlMatrixTermCache::instance().getMatrix(m_revision, m_spAtk));
+		return PlTerm(PlMatrixTermCache::instance().get(m_revision, m_atk));
+	} catch ( PlException &ex ) {
+		throw BackendError((char *) ex);
+	}
+}
+
+__inline
+int ClpbBackend::nextSolution(ClpbQry& query)
+{
+	RunStats::instance().count(COUNTER_NEXT_SOLUTION);
+	return query.next_solution();
+}
+
+size_type ClpbBackend::labeling(const PlTerm& vars, const SolutionVisitor& visit)
+{
+	PlTermv labeling_term(1);
+	labeling_term[0] = vars;
+	ClpbQry labeling_query("clpb", "labeling", labeling_term);
+
+	size_type _num = 0;
+	bitvector _bv(m_argNum);
+	while( nextSolution(labeling_query) ) {
+		// The terms of a solution are released before the next one
+		PlQueryFrame _solution;
+		blListTerm2bv(labeling_term[0].ref, _bv);
+		++_num;
+		if (!visit(_bv))
+			break;
+	}
+	RunStats::instance().count(COUNTER_LABELING_SOLUTIONS, _num);
+	return _num;
+}
+
+size_type ClpbBackend::enumerate(const string& predct, const vector<int>& vecii,
+	const SolutionVisitor& visit)
+{
+	PlTerm _atk = atkMatrix(predct);
+	PlQueryFrame _frame;
+	size_type _num = 0;
+	try
+	{
+		// Building the constraints
+		PlTermv clp_term(2);
+		// The first term is attack matrix
+		clp_term[0] = _atk;
+		// The second term is variable term, output. It is left unbound if
+		// all the arguments are free.
+		if (!vecii.empty())
+			createBlListTerm(vecii, clp_term[1].ref);
+
+		ClpbQry clp_query(predct.c_str(), clp_term);
+
+		if ( nextSolution(clp_query) ) {
+			// Find all assignments
+			_num = labeling(clp_term[1], visit);
+		}
+	} catch ( PlException &ex ) {
+		throw BackendError((char *) ex);
+	}
+	return _num;
+}
+
+bool ClpbBackend::isSolution(const string& predct, const bitvector& _bv)
+{
+	PlTerm _atk = atkMatrix(predct);
+	PlQueryFrame _frame;
+	try
+	{
+		PlTermv clp_term(2);
+		clp_term[0] = _atk;
+		createBlListTerm(_bv, clp_term[1].ref);
+
+		ClpbQry clp_query(predct.c_str(), clp_term);
+		return nextSolution(clp_query) != 0;
+	} catch ( PlException &ex ) {
+		throw BackendError((char *) ex);
+	}
+}
+
+bool ClpbBackend::hasNonempty(const string& predct)
+{
+	PlTerm _atk = atkMatrix(predct);
+	PlQueryFrame _frame;
+	try
+	{
+		PlTermv nonempy_term(3);
+		nonempy_term[0] = PlTerm(predct.c_str());
+		nonempy_term[1] = _atk;
+		ClpbQry nonempy_query("nonempty", nonempy_term);
+		if ( nextSolution(nonempy_query) ) {
+			return labeling(nonempy_term[2], SolutionVisitor(
+				[](const bitvector&) { return false; })) > 0;
+		}
+	} catch ( PlException &ex ) {
+		throw BackendError((char *) ex);
+	}
+	return false;
+}
+
+bool ClpbBackend::hasExcluding(const string& predct, const bitvector& _bv)
+{
+	PlTerm _atk = atkMatrix(predct);
+	PlQueryFrame _frame;
+	try
+	{
+		PlTermv exclusion_term(4);
+		exclusion_term[0] = PlTerm(predct.c_str());
+		exclusion_term[1] = _atk;
+		createBlListTerm(_bv, exclusion_term[2].ref);
+		ClpbQry exclusion_query("exclusion", exclusion_term);
+		if ( nextSolution(exclusion_query) ) {
+			return labeling(exclusion_term[3], SolutionVisitor(
+				[](const bitvector&) { return false; })) > 0;
+		}
+	} catch ( PlException &ex ) {
+		throw BackendError((char *) ex);
+	}
+	return false;
+}
+
+void ClpbBackend::fetchAll(const string& predct, const SolutionVisitor& visit)
+{
+	PlTerm _atk = atkMatrix(predct);
+	PlQueryFrame _frame;
+	try
+	{
+		// extension(complete1, AttM, X), a solution per backtracking
+		// instead of the list of fetchAll(complete1, AttM, E)
+		PlTermv clp_term(3);
+		clp_term[0] = PlTerm(predct.c_str()); // The first term is the goal
+		clp_term[1] = _atk;  // The second term is attack matrix
+
+		ClpbQry clp_query("extension", clp_term);
+
+		bitvector _bv(m_argNum);
+		size_type _num = 0;
+		while ( nextSolution(clp_query) ) {
+			PlQueryFrame _solution;
+			blListTerm2bv(clp_term[2].ref, _bv);
+			++_num;
+			if (!visit(_bv))
+				break;
+		}
+		RunStats::instance().count(COUNTER_LABELING_SOLUTIONS, _num);
+	} catch ( PlException &ex ) {
+		throw BackendError((char *) ex);
+	}
+}
+
+} // namespace argumatrix
+
+#endif  // ARGUMATRIX_CLPB_BACKEND_HPP
@@ -51,7 +51,7 @@ using namespace std;
 class CompletePlReasoner : public PlReasoner {
 public:
 	CompletePlReasoner(const DungAF& daf, const string& sm_task = "CO", 
-		streambuf* osbuff = std::cout.rdbuf()); 
+		streambuf* osbuff = std::cout.rdbuf(), BackendType backend = CLPB_BACKEND); 
 
 	/**
 	 * Problem [EE-$\sigma$]
@@ -62,6 +62,9 @@ public:
 	void task_EE();
 	void task_EX();
 
+	// Enumerate the extensions, as task_EE() does
+	size_type enumerateExtensions(const ExtensionVisitor& visit);
+
 	/**
 	 * Problem [EC-$\sigma$]
 	 * @brief Given an $\textit{AF}=\left< \mathcal{X}, \mathcal{R}\right>$ and 
@@ -137,6 +140,9 @@ public:
 	 * in each E \in E_\sigma(AF) (i.e., skeptically justified).
 	 */
 	void task_DS(const std::set<string>& argset);
+
+	// Decide the batch concurrently (see PlReasoner::decideBatch())
+	void task_DBatch(const vector< std::set<string> >& queries, bool skeptical);
 protected:
 	string m_predicate;
 };
@@ -144,8 +150,9 @@ protected:
 
 CompletePlReasoner::CompletePlReasoner(
 	const DungAF& daf, const string& sm_task /*= "CO"*/, 
-	streambuf* osbuff /*= std::cout.rdbuf()*/) :
-	PlReasoner(daf, osbuff)
+	streambuf* osbuff /*= std::cout.rdbuf()*/,
+	BackendType backend /*= CLPB_BACKEND*/) :
+	PlReasoner(daf, osbuff, backend, isSparseTask(sm_task))
 {	
 	if (sm_task == "CO") {   // The default predicate
 		m_predicate = "complete5";
@@ -164,13 +171,25 @@ CompletePlReasoner::CompletePlReasoner(
 	} else
 	if (sm_task == "CO5") {
 		m_predicate = "complete5";
+	} else
+	if (sm_task == "CO6") {
+		m_predicate = "complete6";
+	} else
+	if (sm_task == "COS") {  // The sparse model
+		m_predicate = "complete_sparse";
 	} else {
 		cerr << "Error: in CompletePlReasoner, unsupported predicate!" << endl;
-		cerr << "  The supported options [CO,CO1,CO2,CO3,CO4,CO5]" << endl;
+		cerr << "  The supported options [CO,CO1,CO2,CO3,CO4,CO5,CO6,COS]" << endl;
 		exit(1);
 	}
 }
 
+__inline
+size_type CompletePlReasoner::enumerateExtensions(const ExtensionVisitor& visit)
+{
+	return PlReasoner::enumerateExts(m_predicate, getGroundedIntVector(), visit);
+}
+
 __inline
 void CompletePlReasoner::task_EE()
 {
@@ -269,6 +288,12 @@ void CompletePlReasoner::task_DS(const std::set<string>& argset)
 	}
 }
 
+__inline
+void CompletePlReasoner::task_DBatch(const vector< std::set<string> >& queries, bool skeptical)
+{
+	printDecisions(m_predicate, queries, skeptical);
+}
+
 inline
 void CompletePlReasoner::task_EX()
 {
@@ -36,7 +36,8 @@ using namespace std;
 
 class ConflictfreePlReasoner : public PlReasoner {
 public:
-	ConflictfreePlReasoner(const DungAF& daf, const string& sm_task = "CF", streambuf* osbuff = std::cout.rdbuf()); 
+	ConflictfreePlReasoner(const DungAF& daf, const string& sm_task = "CF", streambuf* osbuff = std::cout.rdbuf(),
+		BackendType backend = CLPB_BACKEND); 
 
 	/**
 	 * Problem [EE-$\sigma$]
@@ -47,6 +48,9 @@ public:
 	void task_EE();
 	void task_EX();
 
+	// Enumerate the extensions, as task_EE() does
+	size_type enumerateExtensions(const ExtensionVisitor& visit);
+
 	/**
 	 * Problem [EC-$\sigma$]
 	 * @brief Given an $\textit{AF}=\left< \mathcal{X}, \mathcal{R}\right>$ and 
@@ -132,8 +136,9 @@ protected:
 
 ConflictfreePlReasoner::ConflictfreePlReasoner(
 	const DungAF& daf, const string& sm_task /*= "CF"*/, 
-	streambuf* osbuff /*= std::cout.rdbuf()*/) :
-	PlReasoner(daf, osbuff)
+	streambuf* osbuff /*= std::cout.rdbuf()*/,
+	BackendType backend /*= CLPB_BACKEND*/) :
+	PlReasoner(daf, osbuff, backend, isSparseTask(sm_task))
 {	
 	if (sm_task == "CF") {   // The default predicate
 		m_predicate = "conflict_free1";
@@ -146,13 +151,22 @@ ConflictfreePlReasoner::ConflictfreePlReasoner(
 	} else
 	if (sm_task == "CF3") {
 		m_predicate = "conflict_free3";
+	} else
+	if (sm_task == "CFS") {  // The sparse model
+		m_predicate = "conflict_free_sparse";
 	} else {
 		cerr << "Error: in ConflictfreePlReasoner, unsupported predicate!" << endl;
-		cerr << "  The supported options [CF,CF1,CF2,CF3]" << endl;
+		cerr << "  The supported options [CF,CF1,CF2,CF3,CFS]" << endl;
 		exit(1);
 	}
 }
 
+__inline
+size_type ConflictfreePlReasoner::enumerateExtensions(const ExtensionVisitor& visit)
+{
+	return PlReasoner::enumerateExts(m_predicate, vector<int>(), visit);
+}
+
 __inline
 void ConflictfreePlReasoner::task_EE()
 {
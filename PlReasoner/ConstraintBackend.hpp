@@ -0,0 +1,96 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// The interface of the solvers of the Boolean constraint models
+//=======================================================================
+
+#ifndef ARGUMATRIX_CONSTRAINT_BACKEND_HPP
+#define ARGUMATRIX_CONSTRAINT_BACKEND_HPP
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <stdexcept>
+
+#include "config/config.hpp"
+#include "bitmatrix/bitvector.hpp"
+
+
+namespace argumatrix{
+
+using namespace std;
+
+/**
+ * @brief The backends solving the constraint models of the semantics.
+ */
+enum BackendType {
+	CLPB_BACKEND,  /**< The CLP(B) library of SWI-Prolog, see argmat-clpb.pl */
+	BDD_BACKEND    /**< The in-process BDD package, see BddBackend */
+};
+
+/**
+ * @brief Called with each solution of a constraint model, returns false to
+ * stop the enumeration.
+ */
+typedef std::function<bool(const bitvector&)> SolutionVisitor;
+
+/**
+ * @brief The error of a query of a backend, e.g., a resource error of Prolog.
+ * A single run reports it and exits, while the server answers the request
+ * with the error and goes on.
+ */
+class BackendError : public std::runtime_error {
+public:
+	explicit BackendError(const string& _msg): std::runtime_error(_msg) {}
+};
+
+/**
+ * @brief A solver of the Boolean constraint models of argmat-clpb.pl. The
+ * models are selected by the names of their Prolog predicates, e.g.,
+ * "conflict_free1" or "complete5", so that the backends are interchangeable
+ * and give the same results. A solution is a bitvector X whose 1's are the
+ * arguments in the extension. The queries throw a BackendError if the solver
+ * fails.
+ */
+class ConstraintBackend {
+public:
+	virtual ~ConstraintBackend() {}
+
+	/**
+	 * @brief Enumerate the solutions of the model predct which agree with the
+	 * partial assignment vecii, in the order of the labeling of CLP(B).
+	 * @param vecii the entries 0 and 1 are fixed, the entries 2 are free. An
+	 * empty vecii leaves all the arguments free.
+	 * @param visit called with each solution, returns false to stop.
+	 * @return the number of the solutions visited.
+	 */
+	virtual size_type enumerate(const string& predct, const vector<int>& vecii,
+		const SolutionVisitor& visit) = 0;
+
+	// Whether _bv is a solution of the model predct
+	virtual bool isSolution(const string& predct, const bitvector& _bv) = 0;
+
+	// Whether the model predct has a nonempty solution
+	virtual bool hasNonempty(const string& predct) = 0;
+
+	// Whether the model predct has a solution which does not include _bv
+	virtual bool hasExcluding(const string& predct, const bitvector& _bv) = 0;
+
+	/**
+	 * @brief Visit all the solutions of the model predct by a cursor, i.e.,
+	 * the next solution is only computed when the visitor asks for it, so
+	 * that the memory does not grow with the number of the solutions.
+	 */
+	virtual void fetchAll(const string& predct, const SolutionVisitor& visit) = 0;
+
+	/**
+	 * @brief Whether the queries may run concurrently, each thread on its own
+	 * Prolog engine (see PlEnginePool).
+	 */
+	virtual bool isConcurrent() const { return false; }
+};
+
+} // namespace argumatrix
+
+#endif  // ARGUMATRIX_CONSTRAINT_BACKEND_HPP
@@ -0,0 +1,187 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// A pool of SWI-Prolog engines for the worker threads
+//=======================================================================
+
+#ifndef ARGUMATRIX_PL_ENGINE_POOL_HPP
+#define ARGUMATRIX_PL_ENGINE_POOL_HPP
+
+#include <iostream>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+#include "config/config.hpp"
+
+// SWI-prolog
+#include <SWI-cpp.h>
+
+
+namespace argumatrix{
+
+using namespace std;
+
+/**
+ * @brief The Prolog engines of the worker threads. The static
+ * argmatrixPlEngine (see PlReasoner.hpp) is the engine of the main thread, and
+ * a query can only run on the engine bound to the calling thread, so that the
+ * worker threads take an engine of this pool by a PlEngineScope. The engines
+ * are created by PL_create_engine() on demand, and are reused by the later
+ * workers.
+ *
+ * Note that all the engines share the clauses and the modules of the process,
+ * so argmat-clpb.pl, consulted once by argmatrixPlEngine, is visible to the
+ * engines of the pool as well. The terms are local to an engine, e.g., the
+ * attack matrix term of a ClpbBackend is built once per engine.
+ * ~~~~~{.cpp}
+ *   PlEnginePool::instance().reserve(3);
+ *   std::thread _worker([&]() {
+ *       PlEngineScope _scope(PlEnginePool::instance());
+ *       ... // the Prolog queries of this worker
+ *   });
+ * ~~~~~
+ */
+class PlEnginePool {
+public:
+	// The pool of the process, destroyed before argmatrixPlEngine
+	static PlEnginePool& instance();
+
+	// Create engines until there are at least _num of them
+	void reserve(size_type _num);
+
+	size_type size();
+
+	/**
+	 * @brief The slot of the engine bound to the calling thread by a
+	 * PlEngineScope, or -1 for the main engine.
+	 */
+	static int currentSlot() { return tlsSlot(); }
+
+private:
+	friend class PlEngineScope;
+
+	PlEnginePool() {}
+	~PlEnginePool();
+
+	// Not copyable
+	PlEnginePool(const PlEnginePool&);
+	PlEnginePool& operator=(const PlEnginePool&);
+
+	// Take a free engine, and wait if all the engines are taken
+	size_type acquire();
+	void release(size_type _slot);
+
+	static int& tlsSlot() { static thread_local int _slot = -1; return _slot; }
+
+	std::mutex m_mtx;
+	std::condition_variable m_cv;
+	vector<PL_engine_t> m_engines;
+	vector<size_type> m_free;  /**< The slots of the free engines */
+};
+
+/**
+ * @brief Bind an engine of the pool to the calling thread for the lifetime of
+ * the scope, and give it back to the pool afterwards.
+ */
+class PlEngineScope {
+public:
+	explicit PlEngineScope(PlEnginePool& pool);
+	~PlEngineScope();
+
+	size_type slot() const { return m_slot; }
+
+private:
+	PlEngineScope(const PlEngineScope&);
+	PlEngineScope& operator=(const PlEngineScope&);
+
+	PlEnginePool& m_pool;
+	size_type m_slot;
+};
+
+
+PlEnginePool& PlEnginePool::instance()
+{
+	// Constructed after the static argmatrixPlEngine, and thus destroyed
+	// before it calls PL_cleanup()
+	static PlEnginePool _pool;
+	return _pool;
+}
+
+PlEnginePool::~PlEnginePool()
+{
+	for (size_type k = 0; k < m_engines.size(); ++k)
+		PL_destroy_engine(m_engines[k]);
+}
+
+void PlEnginePool::reserve(size_type _num)
+{
+	std::lock_guard<std::mutex> _lock(m_mtx);
+	while (m_engines.size() < _num) {
+		PL_engine_t _engine = PL_create_engine(NULL);
+		if (_engine == NULL) {
+			cerr << "Error: in PlEnginePool, can not create a Prolog engine!" << endl;
+			exit(1);
+		}
+		m_free.push_back(m_engines.size());
+		m_engines.push_back(_engine);
+	}
+	m_cv.notify_all();
+}
+
+size_type PlEnginePool::size()
+{
+	std::lock_guard<std::mutex> _lock(m_mtx);
+	return m_engines.size();
+}
+
+size_type PlEnginePool::acquire()
+{
+	std::unique_lock<std::mutex> _lock(m_mtx);
+	if (m_engines.empty()) {
+		cerr << "Error: in PlEnginePool, no engine (see reserve())!" << endl;
+		exit(1);
+	}
+	m_cv.wait(_lock, [this]() { return !m_free.empty(); });
+	size_type _slot = m_free.back();
+	m_free.pop_back();
+	return _slot;
+}
+
+void PlEnginePool::release(size_type _slot)
+{
+	{
+		std::lock_guard<std::mutex> _lock(m_mtx);
+		m_free.push_back(_slot);
+	}
+	m_cv.notify_one();
+}
+
+PlEngineScope::PlEngineScope(PlEnginePool& pool):
+	m_pool(pool),
+	m_slot(pool.acquire())
+{
+	PL_engine_t _engine;
+	{
+		std::lock_guard<std::mutex> _lock(m_pool.m_mtx);
+		_engine = m_pool.m_engines[m_slot];
+	}
+	if (PL_set_engine(_engine, NULL) != PL_ENGINE_SET) {
+		cerr << "Error: in PlEngineScope, can not bind the Prolog engine!" << endl;
+		exit(1);
+	}
+	PlEnginePool::tlsSlot() = (int)m_slot;
+}
+
+PlEngineScope::~PlEngineScope()
+{
+	// Detach the engine from the thread
+	PL_set_engine(NULL, NULL);
+	PlEnginePool::tlsSlot() = -1;
+	m_pool.release(m_slot);
+}
+
+} // namespace argumatrix
+
+#endif  // ARGUMATRIX_PL_ENGINE_POOL_HPP
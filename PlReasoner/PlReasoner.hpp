@@ -14,19 +14,27 @@
 #include <utility>   
 #include <algorithm>   
 #include <iosfwd>
+#include <vector>
+#include <thread>
+#include <atomic>
 
 // argumatrix
 #include "config/config.hpp"
+#include "config/cptimer.hpp"
 #include "bitmatrix/bitvector.hpp"
 #include "bitmatrix/bitmatrix.hpp"
 #include "dung_theory/DungAF.hpp"
 #include "dung_theory/ArgumentProperty.hpp"
 #include "dung_theory/AttackProperty.hpp"
 #include "dung_theory/Reasoner.hpp"
+#include "ConstraintBackend.hpp"
+#include "BddBackend.hpp"
 
 // SWI-prolog
 #include <SWI-cpp.h>
 #include "swipl-util.hpp"
+#include "ClpbBackend.hpp"
+#include "PlEnginePool.hpp"
 
 
 
@@ -47,15 +55,29 @@ using namespace std;
 static ArgumatrixPlEngine argmatrixPlEngine((char*)"PlReasoner");
 
 
-// typedef PlTimeQry ClpbQry;
-typedef PlQuery ClpbQry;
-
-
+/**
+ * @brief The reasoners based on the constraint models of argmat-clpb.pl. The
+ * models are solved by a ConstraintBackend, either the CLP(B) library of
+ * SWI-Prolog (the default) or the in-process BddBackend, and are selected by
+ * the names of their predicates in both cases.
+ */
 class PlReasoner : public Reasoner {
 public:
-	PlReasoner(const DungAF& daf, streambuf* osbuff = std::cout.rdbuf());
+	/**
+	 * @param sparseModel whether the models of the reasoner are the sparse
+	 * ones of argmat-clpb.pl (the predicates *_sparse), which take the
+	 * attacker lists instead of the dense attack matrix (see isSparseTask()).
+	 */
+	PlReasoner(const DungAF& daf, streambuf* osbuff = std::cout.rdbuf(),
+		BackendType backend = CLPB_BACKEND, bool sparseModel = false);
 	~PlReasoner();
 
+	/**
+	 * @brief Whether the option sm_task of a reasoner, e.g., "COS", selects a
+	 * sparse model, i.e., it is the option of a semantics followed by 'S'.
+	 */
+	static bool isSparseTask(const string& sm_task);
+
 	void Test_time();
 
 	/**
@@ -70,7 +92,8 @@ public:
 	/**
 	 * Method:    fetchAllExts
 	 * FullName:  public  argumatrix::PlReasoner::fetchAllExts
-	 * @brief      
+	 * @brief     Print all the extensions of predct as printAllExts(), fetched
+	 * one by one by the cursor of the backend (see ConstraintBackend::fetchAll()).
 	 * @param     const std::string & predct
 	 * @return    void
 	 * @retval
@@ -139,50 +162,40 @@ public:
 	 * in each E \in E_\sigma(AF) (i.e., skeptically justified).
 	 */
 	bool isSkepticallyJustified(const std::string& predct, const std::set<string>& argset);
-protected:
-
-	/**
-	 * @brief Find all extensions and store them in *m_extensions* with the form of
-	 * bitvector.
-	 * @param string& predct: The predicate.
-	 * @return no return. The results are added into *m_extensions*.
-	 */
-	void findAllExts(const std::string& predct);
 
 	/**
-	 * @brief Create the attack matrix with the form of PlTerm, which is an input of
-	 * SWI-Prolog.
-	 * @return no return. The result is stored in member variable *m_PlAtkMtx*.
+	 * @brief Decide the problems DC-$\sigma$ (or DS-$\sigma$ if skeptical) of a
+	 * batch of argument sets. The queries are independent, so that they run
+	 * concurrently on the threads set by setThreadNum(): the calling thread
+	 * on the main engine, and the others on the engines of the PlEnginePool.
+	 * @return the answers, in the order of queries.
 	 */
-	void createPlAttackMatrix();
+	vector<bool> decideBatch(const std::string& predct,
+		const vector< std::set<string> >& queries, bool skeptical);
 
 	/**
-	 * @brief Print an extension with the form of the bool list term. Assume a bool
-	 * list term is [0, 1, 0, 1], the arguments corresponding to entry 1 will
-	 * be print. The member *m_output* will determine where to print.
-	 * @param PlTerm& plt : The PlTerm is a bool list term, which represents
-	 * an extension.
-	 * @return no return. 
+	 * @brief Print YES or NO for each query of decideBatch(), for the
+	 * task_DBatch() of the subclasses.
 	 */
-	void printLableExtByBlistTerm(const PlTerm& plt);
+	void printDecisions(const std::string& predct,
+		const vector< std::set<string> >& queries, bool skeptical);
+protected:
 
 	/**
-	 * @brief Print an extension with the form of the bool matrix term. Assume a bool
-	 * list term is [[0, 1, 0, 1], [0, 1, 0, 1]], the arguments corresponding to entry 1 will
-	 * be print. The member *m_output* will determine where to print.
-	 * @param PlTerm& plt : The PlTerm is a bool list term, which represents
-	 * an extension.
-	 * @return no return. 
+	 * @brief Find all extensions and store them in *m_extensions* with the form of
+	 * bitvector.
+	 * @param string& predct: The predicate.
+	 * @return no return. The results are added into *m_extensions*.
 	 */
-	void printLableExtByBmatrixTerm(const PlTerm& pmtx);
+	void findAllExts(const std::string& predct);
 
 	/**
-	 * @brief Convert a bool list term into a bitvertor, and add it to extension.
-	 * @param PlTerm& plt : The PlTerm is a bool list term, which represents
-	 * an extension.
-	 * @return no return. The results are added into m_extensions.
+	 * @brief Enumerate the extensions of the semantic predct which agree with
+	 * the partial assignment vecii (see ConstraintBackend::enumerate()), for
+	 * the enumerateExtensions() of the subclasses.
 	 */
-	void addBlTermToBvExts(const PlTerm& plt);
+	size_type enumerateExts(const std::string& predct, const vector<int>& vecii,
+		const ExtensionVisitor& visit);
 
 
 	/**
@@ -202,100 +215,36 @@ protected:
 	bool verifyExclusion(const std::string& predct, const bitvector& vecB);
 protected:
 
-	// The attack matrix, defined by Prolog *term_t*
-	PlTerm m_PlAtkMtx;   
+	// The solver of the constraint models, owned by the reasoner
+	ConstraintBackend* m_backend;
 };
 
 
-PlReasoner::PlReasoner(const DungAF& daf, streambuf* osbuff/* = std::cout.rdbuf()*/):
-	Reasoner(daf, osbuff)
-{
-	// Initialization
-	createPlAttackMatrix();
-}
-
-
-void PlReasoner::createPlAttackMatrix()
+PlReasoner::PlReasoner(const DungAF& daf, streambuf* osbuff/* = std::cout.rdbuf()*/,
+	BackendType backend /*= CLPB_BACKEND*/, bool sparseModel /*= false*/):
+	Reasoner(daf, osbuff, (backend == CLPB_BACKEND && sparseModel) ? SPARSE_MATRIX : AUTO_MATRIX),
+	m_backend(NULL)
 {
-	try	{ 
-		bitmatrix2plmatrixTerm(m_BmAtkMtx, m_PlAtkMtx.ref);
-	} catch ( PlException &ex ) { 
-		cerr << (char *) ex << endl;
-		exit(1);
+	// The term of the dense models of the Prolog backend is built from the
+	// dense matrix if any, otherwise from the sparse one
+	if (backend == CLPB_BACKEND) {
+		m_backend = new ClpbBackend(m_BmAtkMtx, m_SpAtkMtx, m_daf.getRevision());
+	} else {
+		m_backend = new BddBackend(m_SpAtkMtx);
 	}
 }
 
-void PlReasoner::printLableExtByBlistTerm(const PlTerm& plt)
-{
-	if ( !PL_is_list(plt.ref) )
-	{
-		throw PlTypeError("list", plt.ref);
-		return;
-	}
 
-	//the list ref will get modified so copy it
-	term_t tail = PL_copy_term_ref(plt.ref);
-	term_t head = PL_new_term_ref();
-	int index = 0;
-	int x;
-	bool first = true;
-	m_output << LEFT_LIMITER;
-	while(PL_get_list(tail, head, tail)){
-		if( !PL_get_integer(head, &x) ) {
-			throw PlTypeError("integer", head);
-		}
 
-		if(x == 1) 
-		{
-			if(first){
-				first = false;
-			}else{
-				m_output << DELIMITER; // ","
-			}
-			m_output << m_argLabels[index];
-		}
-		
-		++index;
-	}
-	m_output << RIGHT_LIMITER;
-}
-
-void PlReasoner::addBlTermToBvExts(const PlTerm& plt)
+PlReasoner::~PlReasoner()
 {
-	if ( !PL_is_list(plt.ref) )
-	{
-		throw PlTypeError("list", plt.ref);
-		return;
-	}
-
-	//the list ref will get modified so copy it
-	term_t tail = PL_copy_term_ref(plt.ref);
-	term_t head = PL_new_term_ref();
-	int x, index = 0;
-	bitvector _bv(m_argNum, 0);  // all bits are 0s.
-	while(PL_get_list(tail, head, tail)) {
-		if(PL_get_integer(head, &x)) {
-			if(x == 1) {
-				_bv.set(index);
-			}
-		} else {
-			throw PlTypeError("atom", head);
-		}
-
-		++index;
-	}
-
-	// The length of the list must be equal to the number of arguments.
-	// assert(m_argNum == index);
-
-	m_extensions.insert( _bv );
+	delete m_backend;
 }
 
-
-
-PlReasoner::~PlReasoner()
+__inline
+bool PlReasoner::isSparseTask(const string& sm_task)
 {
-	
+	return sm_task.size() > 2 && sm_task[sm_task.size()-1] == 'S';
 }
 
 void PlReasoner::printAllExts2(const string& predct)
@@ -309,40 +258,9 @@ void PlReasoner::Test_time()
 {
 	m_output << "Time test :" << endl;
 
-	try
-	{ 
-		// Building the constraints
-		PlTermv clp_term(2);
-		// The first term is attack matrix
-		clp_term[0] = m_PlAtkMtx;  		
-
-		PlTimeQry clp_query("complete5", clp_term);
-
-		m_output << LEFT_LIMITER;  // [
-		while( clp_query.next_solution() ) {
-			// Find all assignments 
-			PlTermv labeling_term(1);
-			labeling_term[0] = clp_term[1];
-
-			PlTimeQry labeling_query("clpb", "labeling", labeling_term);
-			bool first = true;
-
-			while( labeling_query.next_solution() ) {
-				if(first) {
-					first = false;
-				} else {
-					m_output << DELIMITER; // ","
-				}
-				// outputBoolListTerm((term_t)labeling_term[0]);
-				printLableExtByBlistTerm(labeling_term[0]);
-			}
-		}
-		m_output << RIGHT_LIMITER; // ]
-	} catch ( PlException &ex ) { 
-		cerr << (char *) ex << endl;
-		exit(1);
-	}
-	m_output << endl;
+	uint64_t _begin = clock_ns();
+	printAllExts("complete5");
+	m_output << "The time is : " << clock_ns() - _begin << endl;
 }
 
 __inline
@@ -353,78 +271,16 @@ void PlReasoner::printAllExts(const std::string& predct, const std::set<string>&
 
 void PlReasoner::printAllExts(const std::string& predct, const std::vector<int>& vecii)
 {
-	try
-	{ 
-		// Building the constraints
-		PlTermv clp_term(2);
-		// The first term is attack matrix
-		clp_term[0] = m_PlAtkMtx;  
-		// The second term is variable term, output
-		createBlListTerm(vecii, clp_term[1].ref);  
-
-		ClpbQry clp_query(predct.c_str(), clp_term);
-
-		m_output << LEFT_LIMITER;  // [
-		while( clp_query.next_solution() )  {
-			// Find all assignments 
-			PlTermv labeling_term(1);
-			labeling_term[0] = clp_term[1];
-			ClpbQry labeling_query("labeling", labeling_term);
-			bool first = true;
-
-			while( labeling_query.next_solution() ) {
-				if(first){
-					first = false;
-				} else {
-					m_output << DELIMITER; // ","
-				}
-				// outputBoolListTerm((term_t)labeling_term[0]);
-				printLableExtByBlistTerm(labeling_term[0]);
-			}
-		}
-		m_output << RIGHT_LIMITER << endl;
-
-	} catch ( PlException &ex ) { 
-		cerr << (char *) ex << endl;
-		exit(1);
-	}
+	printExtList([&](const SolutionVisitor& _print) {
+		m_backend->enumerate(predct, vecii, _print);
+	});
 }
 
 void PlReasoner::printAllExts(const std::string& predct)
 {
-	try
-	{ 
-		// Building the constraints
-		PlTermv clp_term(2);
-		// The first term is attack matrix
-		clp_term[0] = m_PlAtkMtx;  
-
-		ClpbQry clp_query(predct.c_str(), clp_term);
-
-		m_output << LEFT_LIMITER;  // [
-		while( clp_query.next_solution() ) {
-			// Find all assignments 
-			PlTermv labeling_term(1);
-			labeling_term[0] = clp_term[1];
-			ClpbQry labeling_query("clpb", "labeling", labeling_term);
-			bool first = true;
-
-			while( labeling_query.next_solution() ) {
-				if(first){
-					first = false;
-				}else{
-					m_output << DELIMITER; // ","
-				}
-				// outputBoolListTerm((term_t)labeling_term[0]);
-				printLableExtByBlistTerm(labeling_term[0]);
-			}
-		}
-		m_output << RIGHT_LIMITER << endl;
-
-	} catch ( PlException &ex ) { 
-		cerr << (char *) ex << endl;
-		exit(1);
-	}
+	printExtList([&](const SolutionVisitor& _print) {
+		m_backend->enumerate(predct, vector<int>(), _print);
+	});
 }
 
 __inline
@@ -435,137 +291,41 @@ void PlReasoner::printSomeExt(const std::string& predct, const std::set<string>&
 
 void PlReasoner::printSomeExt(const std::string& predct, const vector<int>& vecii)
 {
-	try
-	{ 
-		// Building the constraints
-		PlTermv clp_term(2);
-		// The first term is attack matrix
-		clp_term[0] = m_PlAtkMtx;  
-		// The second term is variable term, output
-		createBlListTerm(vecii, clp_term[1].ref);  
-
-		ClpbQry clp_query(predct.c_str(), clp_term);
-
-		while( clp_query.next_solution() )
-		{
-			// Find all assignments 
-			PlTermv labeling_term(1);
-			labeling_term[0] = clp_term[1];
-			ClpbQry labeling_query("clpb", "labeling", labeling_term);
-
-			if( labeling_query.next_solution() ) {
-				printLableExtByBlistTerm(labeling_term[0]);
-				m_output << endl;
-				return;
-			} else {
-				m_output << STR_NO << endl;
-				return;
-			}
-		}
-		m_output << STR_NO << endl;
+	SolutionVisitor _print = [&](const bitvector& _bv) {
+		printLabSet(_bv);
+		m_output << endl;
+		return false;  // Stop at the first one
+	};
 
-	} catch ( PlException &ex ) { 
-		cerr << (char *) ex << endl;
-		exit(1);
+	if ( m_backend->enumerate(predct, vecii, _print) == 0 ) {
+		m_output << STR_NO << endl;
 	}
 }
 
+__inline
 bool PlReasoner::verifyNonemptyExt(const std::string& predct)
 {
-	try
-	{ 
-		PlTermv nonempy_term(3);
-		nonempy_term[0] = PlTerm(predct.c_str());
-		nonempy_term[1] = m_PlAtkMtx;
-		ClpbQry nonempy_query("nonempty", nonempy_term);
-		while( nonempy_query.next_solution() )
-		{
-			// Find all assignments 
-			PlTermv labeling_term(1);
-			labeling_term[0] = nonempy_term[2];
-			ClpbQry labeling_query("clpb", "labeling", labeling_term);
-
-			if( labeling_query.next_solution() ) {
-				// printLableExtByBlistTerm(labeling_term[0]);
-				// m_output << STR_YES << endl;
-				return true;
-			} else {
-				// m_output << STR_NO << endl;
-				return false;
-			}	
-		}
-	} catch ( PlException &ex ) { 
-		cerr << (char *) ex << endl;
-		exit(1);
-	}
+	return m_backend->hasNonempty(predct);
+}
 
-	// m_output << STR_NO << endl;
-	return false;
+__inline
+size_type PlReasoner::enumerateExts(const std::string& predct, const vector<int>& vecii,
+	const ExtensionVisitor& visit)
+{
+	return m_backend->enumerate(predct, vecii, visit);
 }
 
 bool PlReasoner::verifyInclusion(const std::string& predct, const vector<int>& vecii)
 {
-	try{ 
-		// Building the constraints
-		PlTermv clp_term(2);
-		// The first term is attack matrix
-		clp_term[0] = m_PlAtkMtx;  
-		// The second term is variable term, output
-		createBlListTerm(vecii, clp_term[1].ref);  
-
-		ClpbQry clp_query(predct.c_str(), clp_term);
-
-		while( clp_query.next_solution() ){
-			// Find all assignments 
-			PlTermv labeling_term(1);
-			labeling_term[0] = clp_term[1];
-			ClpbQry labeling_query("clpb", "labeling", labeling_term);
-
-			// If there exists a solution
-			if( labeling_query.next_solution() ) {
-				return true;
-			} else {
-				return false;
-			}
-		}
-	} catch ( PlException &ex ) { 
-		cerr << (char *) ex << endl;
-		exit(1);
-	}
-
-	return false;
+	// If there exists a solution
+	SolutionVisitor _first = [](const bitvector&) { return false; };
+	return m_backend->enumerate(predct, vecii, _first) > 0;
 }
 
+__inline
 bool PlReasoner::verifyExclusion(const std::string& predct, const bitvector& vecB)
 {
-	try
-	{ 
-		PlTermv nonempy_term(4);
-		nonempy_term[0] = PlTerm(predct.c_str());
-		nonempy_term[1] = m_PlAtkMtx;
-		createBlListTerm(vecB, nonempy_term[2].ref);
-		ClpbQry nonempy_query("exclusion", nonempy_term);
-		while( nonempy_query.next_solution() )
-		{
-			// Find all assignments 
-			PlTermv labeling_term(1);
-			labeling_term[0] = nonempy_term[3];
-			ClpbQry labeling_query("clpb", "labeling", labeling_term);
-
-			if( labeling_query.next_solution() )
-			{
-				// printLableExtByBlistTerm(labeling_term[0]);
-				return true;
-			} else {
-				return false;
-			}	
-		}
-	} catch ( PlException &ex ) { 
-		cerr << (char *) ex << endl;
-		exit(1);
-	}
-
-	return false;
+	return m_backend->hasExcluding(predct, vecB);
 }
 
 __inline
@@ -575,31 +335,10 @@ bool PlReasoner::verifyExtension(const std::string& predct, std::set<string>& ar
 	return verifyExtension(predct, _bv );
 }
 
+__inline
 bool PlReasoner::verifyExtension(const std::string& predct, bitvector& bvec)
 {
-	try
-	{ 
-		// Building the constraints
-		PlTermv clp_term(2);
-		// The first term is attack matrix
-		clp_term[0] = m_PlAtkMtx;  
-		// The second term is variable term, output
-		createBlListTerm(bvec, clp_term[1].ref);  
-
-		ClpbQry clp_query(predct.c_str(), clp_term);
-
-		if ( clp_query.next_solution() )
-		{
-			// m_output << STR_YES << endl;
-			return true;
-		} else 	{
-			// m_output << STR_NO << endl;
-			return false;
-		}
-	} catch ( PlException &ex ) { 
-		cerr << (char *) ex << endl;
-		exit(1);
-	}
+	return m_backend->isSolution(predct, bvec);
 }
 
 bool PlReasoner::isCredulouslyJustified(const std::string& predct, const std::set<string>& argset)
@@ -629,77 +368,71 @@ bool PlReasoner::isSkepticallyJustified(const std::string& predct, const std::se
 	}
 }
 
-void PlReasoner::findAllExts(const std::string& predct)
+vector<bool> PlReasoner::decideBatch(const std::string& predct,
+	const vector< std::set<string> >& queries, bool skeptical)
 {
-	try
-	{ 
-		// Building the constraints
-		PlTermv clp_term(2);
-		// The first term is attack matrix
-		clp_term[0] = m_PlAtkMtx;  
-		// The second term is variable term, output
-		createBlListTerm(getGroundedIntVector(), clp_term[1].ref);  
-
-		ClpbQry clp_query(predct.c_str(), clp_term);
-
-		while( clp_query.next_solution() )
-		{
-			// Find all assignments 
-			PlTermv labeling_term(1);
-			labeling_term[0] = clp_term[1];
-			ClpbQry labeling_query("clpb", "labeling", labeling_term);
-
-			while( labeling_query.next_solution() )
-			{
-				// outputBoolListTerm((term_t)labeling_term[0]);
-				addBlTermToBvExts( labeling_term[0] );
-			}
+	// Not vector<bool>, whose elements can not be written concurrently
+	vector<char> _answers(queries.size(), 0);
+	std::atomic<size_type> _next(0);
+	auto _work = [&]() {
+		for (size_type q = _next++; q < queries.size(); q = _next++) {
+			_answers[q] = skeptical ? isSkepticallyJustified(predct, queries[q])
+				: isCredulouslyJustified(predct, queries[q]);
+		}
+	};
+
+	size_type _threads = min(m_threadNum, queries.size());
+	if (_threads <= 1 || !m_backend->isConcurrent()) {
+		_work();
+	} else {
+		PlEnginePool& _pool = PlEnginePool::instance();
+		_pool.reserve(_threads - 1);
+
+		vector<std::thread> _workers;
+		for (size_type k = 1; k < _threads; ++k) {
+			_workers.push_back(std::thread([&]() {
+				PlEngineScope _scope(_pool);
+				_work();
+			}));
 		}
-	} catch ( PlException &ex ) { 
-		cerr << (char *) ex << endl;
-		exit(1);
+		_work();
+		for (size_type k = 0; k < _workers.size(); ++k)
+			_workers[k].join();
 	}
+
+	return vector<bool>(_answers.begin(), _answers.end());
 }
 
-void PlReasoner::fetchAllExts(const std::string& predct)
+void PlReasoner::printDecisions(const std::string& predct,
+	const vector< std::set<string> >& queries, bool skeptical)
 {
-	try
-	{ 
-		// fetchAll(complete1, AttM, E)
-		PlTermv clp_term(3);
-		
-		clp_term[0] = PlTerm(predct.c_str()); // The first term is the goal	
-		clp_term[1] = m_PlAtkMtx;  // The second term is attack matrix
-
-		ClpbQry clp_query("fetchAll", clp_term);
-
-		m_output << LEFT_LIMITER;
-		while( clp_query.next_solution() )
-		{
-			printLableExtByBmatrixTerm(clp_term[2]);
+	for (size_type q = 0; q < queries.size(); ++q) {
+		if (queries[q].empty()) {
+			cerr << "The task " << (skeptical ? "DS" : "DC")
+				<< " needs additional argument (see option -a)" << endl;
+			exit(1);
 		}
-		m_output << RIGHT_LIMITER << endl;
-	} catch ( PlException &ex ) { 
-		cerr << (char *) ex << endl;
-		exit(1);
 	}
+
+	vector<bool> _answers = decideBatch(predct, queries, skeptical);
+	for (size_type q = 0; q < _answers.size(); ++q)
+		m_output << (_answers[q] ? STR_YES : STR_NO) << endl;
 }
 
-void PlReasoner::printLableExtByBmatrixTerm(const PlTerm& pmtx)
+void PlReasoner::findAllExts(const std::string& predct)
 {
-	//the list ref will get modified so copy it
-	term_t tail = PL_copy_term_ref(pmtx.ref);
-	term_t head = PL_new_term_ref();
-	bool first = true;
-	
-	while(PL_get_list(tail, head, tail)){
-		if(first){
-			first = 0;
-		}else{
-			m_output << DELIMITER; // ","
-		}
-		printLableExtByBlistTerm(head);
-	}
+	SolutionVisitor _add = [&](const bitvector& _bv) {
+		m_extensions.insert(_bv);
+		return true;
+	};
+	m_backend->enumerate(predct, getGroundedIntVector(), _add);
+}
+
+void PlReasoner::fetchAllExts(const std::string& predct)
+{
+	printExtList([&](const SolutionVisitor& _print) {
+		m_backend->fetchAll(predct, _print);
+	});
 }
 
 
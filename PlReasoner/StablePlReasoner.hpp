@@ -36,7 +36,8 @@ using namespace std;
 
 class StablePlReasoner : public PlReasoner {
 public:
-	StablePlReasoner(const DungAF& daf, const string& sm_task = "ST", streambuf* osbuff = std::cout.rdbuf()); 
+	StablePlReasoner(const DungAF& daf, const string& sm_task = "ST", streambuf* osbuff = std::cout.rdbuf(),
+		BackendType backend = CLPB_BACKEND); 
 
 	/**
 	 * Problem [EE-\f$\sigma\f$]
@@ -47,6 +48,9 @@ public:
 	void task_EE();
 	void task_EX();
 
+	// Enumerate the extensions, as task_EE() does
+	size_type enumerateExtensions(const ExtensionVisitor& visit);
+
 	/**
 	 * Problem [EC-\f$\sigma\f$]
 	 * @brief Given an \f$\textit{AF}=\left< \mathcal{X}, \mathcal{R}\right>\f$ and 
@@ -122,6 +126,9 @@ public:
 	 * in each \f$E \in E_\sigma(AF)\f$ (i.e., skeptically justified).
 	 */
 	void task_DS(const std::set<string>& argset);
+
+	// Decide the batch concurrently (see PlReasoner::decideBatch())
+	void task_DBatch(const vector< std::set<string> >& queries, bool skeptical);
 protected:
 	string m_predicate;
 };
@@ -129,8 +136,9 @@ protected:
 
 StablePlReasoner::StablePlReasoner(
 	const DungAF& daf, const string& sm_task /*= "CO"*/, 
-	streambuf* osbuff /*= std::cout.rdbuf()*/) :
-	PlReasoner(daf, osbuff)
+	streambuf* osbuff /*= std::cout.rdbuf()*/,
+	BackendType backend /*= CLPB_BACKEND*/) :
+	PlReasoner(daf, osbuff, backend, isSparseTask(sm_task))
 {	
 	if (sm_task == "ST") {   // The default predicate
 		m_predicate = "stable2";
@@ -140,13 +148,22 @@ StablePlReasoner::StablePlReasoner(
 	} else
 	if (sm_task == "ST2") {
 		m_predicate = "stable2";
+	} else
+	if (sm_task == "STS") {  // The sparse model
+		m_predicate = "stable_sparse";
 	} else {
 		cerr << "Error: in StablePlReasoner, unsupported predicate!" << endl;
-		cerr << "  The supported options [ST,ST1,ST2]" << endl;
+		cerr << "  The supported options [ST,ST1,ST2,STS]" << endl;
 		exit(1);
 	}
 }
 
+__inline
+size_type StablePlReasoner::enumerateExtensions(const ExtensionVisitor& visit)
+{
+	return PlReasoner::enumerateExts(m_predicate, getGroundedIntVector(), visit);
+}
+
 __inline
 void StablePlReasoner::task_EE()
 {
@@ -245,6 +262,12 @@ void StablePlReasoner::task_DS(const std::set<string>& argset)
 	}
 }
 
+__inline
+void StablePlReasoner::task_DBatch(const vector< std::set<string> >& queries, bool skeptical)
+{
+	printDecisions(m_predicate, queries, skeptical);
+}
+
 inline
 void StablePlReasoner::task_EX()
 {
@@ -265,6 +265,60 @@ complete6(Rows, X) :-
 	defense(Rows, V2, V3),
 	maplist(c_eqn, X, V3).  % the constraint	
 
+% =======================================================
+% The sparse constraint models, which take the attackers of each argument,
+% i.e., Adj = [As_1, ..., As_n] where As_i lists the (1-based) indices of the
+% attackers of the i-th argument, instead of the attack matrix. The size of
+% the terms is O(n+|R|) instead of O(n^2).
+
+% X_J, the J-th element of the vector term XT.
+arg_of(XT, J, V) :-
+	arg(J, XT, V).
+
+% The sum of the attackers As of an argument
+sparse_row(XT, As, +Vs) :-
+	maplist(arg_of(XT), As, Vs).
+
+% The multiplication of the sparse matrix and vector.
+% Y = Adj * X.
+sparse_mult(Adj, X, Y) :-
+	length(Adj, Len),
+	length(X, Len),
+	XT =.. [x|X],
+	maplist(sparse_row(XT), Adj, Y).
+
+% The sparse neutrality function
+% Y = neg(Adj * X)
+sparse_neutrality(Adj, X, Y) :-
+	sparse_mult(Adj, X, Z),
+	maplist(neg, Z, Y).
+
+% The sparse constraint model of [CF2].
+conflict_free_sparse(Adj, X) :-
+	sparse_neutrality(Adj, X, Y),
+    maplist(c_leq, X, Y).
+
+% The sparse constraint model of [ST2].
+stable_sparse(Adj, X) :-
+	sparse_mult(Adj, X, Z),     % Z = Ax
+	maplist(bxor, X, Z, Y),     % Y = Ax xor X
+	maplist(sat, Y).
+
+% The sparse constraint model of [AD3].
+admissible_sparse(Adj, X) :-
+	sparse_neutrality(Adj, X, Y),  % \neg R^+(X)
+	sparse_neutrality(Adj, Y, Z),  % Defense(X)
+	maplist(bmult, Y, Z, T),       % \neg R^+(X) and Defense(X)
+	maplist(c_leq, X, T).          % the constraint X =< T
+
+% The sparse constraint model of [CO5].
+complete_sparse(Adj, X) :-
+	sparse_neutrality(Adj, X, Y),  % \neg R^+(X)
+    maplist(badd, X, Y, Z),        % Z = X + \neg R^+(X)
+    sparse_mult(Adj, Z, T),        % T = Adj*Z
+    maplist(bxor, T, X, R),        % R = T xor X
+	maplist(sat, R).               % the constraint
+
 % non-empty sigma-extension
 nonempty(Goal, AttM, X) :-
     length(AttM, Len),
@@ -279,6 +333,14 @@ exclusion(Goal, AttM, Y, X) :-
     call(Goal, AttM, X),
     c_exclusion(Y, X). % constraint, Y is not included in X.
 
+% fetch the extensions one by one on backtracking, a cursor which keeps
+% only the current extension, unlike fetchAll/3.
+extension(Goal, AttM, X) :-
+    length(AttM, Len),
+	length(X, Len),
+	call(Goal, AttM, X),
+	labeling(X).
+
 % fetch all extensions at once.
 fetchAll(Goal, AttM, E) :-
     findall(X, (call(Goal, AttM, X), labeling(X)), E).
@@ -148,8 +148,87 @@ void demo5()
 	printExts(daf5);
 }
 
+/**
+ * @brief Create the reasoner of the semantics option sm_task, e.g., "CO3",
+ * on the backend.
+ */
+PlReasoner* createPlReasoner(const DungAF& daf, const string& sm_task,
+	BackendType backend)
+{
+	const string sm_type = sm_task.substr(0, 2);
+	if (sm_type == "CF")
+		return new ConflictfreePlReasoner(daf, sm_task, cout.rdbuf(), backend);
+	if (sm_type == "AD")
+		return new AdmissiblePlReasoner(daf, sm_task, cout.rdbuf(), backend);
+	if (sm_type == "CO")
+		return new CompletePlReasoner(daf, sm_task, cout.rdbuf(), backend);
+	return new StablePlReasoner(daf, sm_task, cout.rdbuf(), backend);
+}
+
+/**
+ * Enumerate the extensions of every model of argmat-clpb.pl on random small
+ * frameworks, by the CLP(B) backend and by the BddBackend, and compare both
+ * with the subsets of the arguments checked by the Reasoner.
+ * @return the number of the pairs of framework and model on which a backend
+ * differs.
+ */
+size_type Test_BackendAgreement(unsigned int seed, size_type rounds)
+{
+	const char* _tasks[] = { "CF1", "CF2", "CF3", "CFS",
+		"AD1", "AD2", "AD3", "AD4", "AD5", "AD6", "ADS",
+		"CO1", "CO2", "CO3", "CO4", "CO5", "CO6", "COS",
+		"ST1", "ST2", "STS" };
+
+	srand(seed);
+	size_type _clpbErrors = 0, _bddErrors = 0;
+	for (size_type r = 0; r < rounds; ++r) {
+		DungAF daf;
+		const size_type n = rand() % 9;
+		for (size_type i = 0; i < n; ++i)
+			daf.addArgument("a" + std::to_string(i));
+		for (size_type k = 0; n > 0 && k < 3 * n / 2; ++k)
+			daf.addAttack(Argument(rand() % n), Argument(rand() % n));
+
+		Reasoner _ref(daf);
+		for (const char* _task : _tasks) {
+			const string _type = string(_task).substr(0, 2);
+			set<bitvector> _expected;
+			for (unsigned long m = 0; m < (1UL << n); ++m) {
+				bitvector _bv = bitvector::EmptySet(n);
+				for (size_type j = 0; j < n; ++j)
+					if (m >> j & 1)
+						_bv.set(j);
+				if ((_type == "CF" && _ref.is_conflict_free(_bv)) ||
+					(_type == "AD" && _ref.is_admissible(_bv)) ||
+					(_type == "CO" && _ref.is_complete(_bv)) ||
+					(_type == "ST" && _ref.is_stable(_bv)))
+					_expected.insert(_bv);
+			}
+
+			for (BackendType _backend : { CLPB_BACKEND, BDD_BACKEND }) {
+				std::unique_ptr<PlReasoner> _rsner(createPlReasoner(daf, _task, _backend));
+				set<bitvector> _exts;
+				_rsner->enumerateExtensions([&](const bitvector& _bv) {
+					_exts.insert(_bv);
+					return true;
+				});
+				if (_exts != _expected)
+					++(_backend == CLPB_BACKEND ? _clpbErrors : _bddErrors);
+			}
+		}
+	}
+
+	cout << "Backends: " << rounds << " frameworks, "
+		<< _clpbErrors << " mismatches of CLP(B), "
+		<< _bddErrors << " mismatches of BDD" << endl;
+	return _clpbErrors + _bddErrors;
+}
+
 int main(int argc, char* argv[])
 {
+	if (Test_BackendAgreement(2016, 200) > 0)
+		return 1;
+
 	DungAF daf;
 
 	uint64_t time_begin, time_end;
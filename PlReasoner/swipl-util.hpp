@@ -22,6 +22,8 @@
 
 #include "bitmatrix/bitvector.hpp"
 #include "bitmatrix/bitmatrix.hpp"
+#include "bitmatrix/sparsematrix.hpp"
+#include "config/runstats.hpp"
 
 // SWI-Prolog
 #include <SWI-cpp.h>
@@ -31,14 +33,40 @@ namespace argumatrix{
 using namespace std;
 
 void bitmatrix2plmatrixTerm(const bitmatrix& bm, term_t bmtx);
+void sparsematrix2attackerListTerm(const sparsematrix& sm, term_t adj);
+void sparsematrix2plmatrixTerm(const sparsematrix& sm, term_t bmtx);
 void printBitVecTerm(const term_t blst, std::ostream &output = std::cout);
 void printBitMatTerm(const term_t bmtx, std::ostream &output = std::cout);
 void createBlListTerm(const vector<int>& vecI, term_t blst);
 void createBlListTerm(const bitvector& vecB, term_t blst);
+void blListTerm2bv(const term_t blst, bitvector& bv);
+void putBitRowCodes(const bitvector& bv, term_t blst, std::string& buffer);
+void samplePlStacks();
 
 
 #define ARG_PROLOG_FILE	"../PlReasoner/argmat-clpb"
 
+/**
+* class: PlQueryFrame
+* @brief A foreign frame of the engine of the calling thread, opened by the
+* constructor and discarded by the destructor, also when an exception is
+* thrown. The term references and the Prolog data created in the frame, e.g.,
+* by a query, are thus released when the query is done. The terms which must
+* outlive the query, e.g., the matrix terms of the PlMatrixTermCache, are
+* created before the frame.
+*/
+class PlQueryFrame {
+public:
+	PlQueryFrame(): m_fid(PL_open_foreign_frame()) {}
+	~PlQueryFrame() { PL_discard_foreign_frame(m_fid); }
+
+private:
+	PlQueryFrame(const PlQueryFrame&);
+	PlQueryFrame& operator=(const PlQueryFrame&);
+
+	fid_t m_fid;
+};
+
 /**
 * class: ArgumatrixPlEngine
 * @brief We rewrite the PlEngine since we do not want the PlEngine to print the 
@@ -320,7 +348,30 @@ int PlTimeQry::next_solution() {
 
 
 /**
-* @brief Convert a bitmatrix into a Prolog Boolean matrix.
+* @brief Put a bool list term of a bitvector by one call. A list of 0's and
+* 1's is also the list of the character codes 0 and 1, so that it can be built
+* by PL_put_list_ncodes() from a buffer of the bytes 0 and 1, instead of a
+* PL_cons_list() per entry.
+* @param bitvector& bv : a vector of bool {0,1}.
+* @param term_t blst : The output parameter.
+* @param std::string& buffer : the scratch of the codes, reused by the calls.
+*/
+void putBitRowCodes(const bitvector& bv, term_t blst, std::string& buffer)
+{
+	buffer.assign(bv.size(), '\0');
+	for (size_type j = bv.find_first(); j != bitvector::npos; j = bv.find_next(j)) {
+		buffer[j] = '\1';
+	}
+
+	if ( !PL_put_list_ncodes(blst, buffer.size(), buffer.data()) ) {
+		throw PlResourceError(blst);
+	}
+}
+
+/**
+* @brief Convert a bitmatrix into a Prolog Boolean matrix. Each row is put by
+* one call (see putBitRowCodes()), so that the matrix takes O(n) calls of the
+* foreign interface instead of O(n^2).
 * @param bitvector& bv
 * @param term_t bmtx
 * @return no return. *term_t bmtx* is the output parameter.
@@ -328,12 +379,10 @@ int PlTimeQry::next_solution() {
 void bitmatrix2plmatrixTerm(const bitmatrix& bm, term_t bmtx)
 {
 	term_t h = PL_new_term_ref();
+	std::string _codes;
 	PL_put_nil(bmtx); //initialize with the empty list
 	for(int i = bm.sizeR()-1; i >= 0; --i){
-		term_t blst = PL_new_term_ref();
-
-		createBlListTerm(bm[i], blst);
-		PL_put_term(h, blst);
+		putBitRowCodes(bm[i], h, _codes);
 
 		if( !PL_cons_list(bmtx, h, bmtx) ) //add h in front of the bmtx
 		{
@@ -341,6 +390,96 @@ void bitmatrix2plmatrixTerm(const bitmatrix& bm, term_t bmtx)
 			throw PlResourceError(bmtx);
 		}
 	}
+	RunStats::instance().count(COUNTER_TERM_CELLS, (uint64_t)bm.sizeR() * bm.sizeC());
+}
+
+/**
+* @brief Convert a sparse attack matrix into the Prolog term of the attacker
+* lists [As_1, ..., As_n], where As_i lists the 1-based indices of the
+* attackers of the i-th argument (i.e., the 1's of the i-th row), for the
+* sparse models of argmat-clpb.pl. The term takes O(n+|R|) calls of the
+* foreign interface.
+* @param sparsematrix& sm
+* @param term_t adj
+* @return no return. *term_t adj* is the output parameter.
+*/
+void sparsematrix2attackerListTerm(const sparsematrix& sm, term_t adj)
+{
+	term_t h = PL_new_term_ref();
+	term_t j = PL_new_term_ref();
+	PL_put_nil(adj); //initialize with the empty list
+	for(int i = (int)sm.sizeR()-1; i >= 0; --i){
+		PL_put_nil(h);
+		for(sparsematrix::const_iterator it = sm.row_end(i); it != sm.row_begin(i); ){
+			--it;
+			if( !PL_put_integer(j, (long)(*it + 1)) || !PL_cons_list(h, j, h) )
+			{
+				throw PlResourceError(h);
+			}
+		}
+
+		if( !PL_cons_list(adj, h, adj) ) //add h in front of the adj
+		{
+			// if adding failed, throw error
+			throw PlResourceError(adj);
+		}
+	}
+	RunStats::instance().count(COUNTER_TERM_CELLS, sm.nnz() + sm.sizeR());
+}
+
+/**
+* @brief Convert a sparse attack matrix into the Prolog Boolean matrix of
+* bitmatrix2plmatrixTerm(), for the dense models of a framework whose
+* bitmatrix is not built. Each row is put by one call from the codes of its
+* 1's.
+* @param sparsematrix& sm
+* @param term_t bmtx
+* @return no return. *term_t bmtx* is the output parameter.
+*/
+void sparsematrix2plmatrixTerm(const sparsematrix& sm, term_t bmtx)
+{
+	term_t h = PL_new_term_ref();
+	std::string _codes;
+	PL_put_nil(bmtx); //initialize with the empty list
+	for(int i = (int)sm.sizeR()-1; i >= 0; --i){
+		_codes.assign(sm.sizeC(), '\0');
+		for(sparsematrix::const_iterator it = sm.row_begin(i); it != sm.row_end(i); ++it){
+			_codes[*it] = '\1';
+		}
+
+		if( !PL_put_list_ncodes(h, _codes.size(), _codes.data()) ||
+			!PL_cons_list(bmtx, h, bmtx) ) //add h in front of the bmtx
+		{
+			// if adding failed, throw error
+			throw PlResourceError(bmtx);
+		}
+	}
+	RunStats::instance().count(COUNTER_TERM_CELLS, (uint64_t)sm.sizeR() * sm.sizeC());
+}
+
+/**
+* @brief Sample the stack usage of the engine of the calling thread, by
+* statistics/2, into the gauges of the RunStats. Nothing is queried unless
+* the RunStats are enabled.
+*/
+void samplePlStacks()
+{
+	if (!RunStats::instance().enabled())
+		return;
+
+	static const char* _keys[] = { "globalused", "localused", "trailused" };
+	static const StatGauge _gauges[] = {
+		GAUGE_PL_GLOBAL_USED, GAUGE_PL_LOCAL_USED, GAUGE_PL_TRAIL_USED
+	};
+	for (int k = 0; k < 3; ++k) {
+		PlQueryFrame _frame;
+		PlTermv _av(2);
+		_av[0] = PlTerm(_keys[k]);
+		PlQuery _query("statistics", _av);
+		int64_t _bytes;
+		if (_query.next_solution() && PL_get_int64(_av[1].ref, &_bytes))
+			RunStats::instance().peak(_gauges[k], (uint64_t)_bytes);
+	}
 }
 
 /**
@@ -412,6 +551,18 @@ void printBitMatTerm(const term_t bmtx, std::ostream &output /*= std::cout*/)
 */
 void createBlListTerm(const vector<int>& vecI, term_t blst)
 {
+	// Without unknowns, the list is put by one call
+	if (std::find(vecI.begin(), vecI.end(), 2) == vecI.end()) {
+		std::string _codes(vecI.size(), '\0');
+		for (size_type i = 0; i < vecI.size(); ++i) {
+			_codes[i] = (char)vecI[i];
+		}
+		if ( !PL_put_list_ncodes(blst, _codes.size(), _codes.data()) ) {
+			throw PlTypeError("list", blst);
+		}
+		return;
+	}
+
 	term_t tmp = PL_new_term_ref();
 	PL_put_nil(blst); //initialize with the empty list
 	for(int i = vecI.size() - 1; i >= 0; --i){
@@ -442,24 +593,38 @@ void createBlListTerm(const vector<int>& vecI, term_t blst)
 */
 void createBlListTerm(const bitvector& bv, term_t blst)
 {
-	term_t tmp = PL_new_term_ref();
-	PL_put_nil(blst); //initialize with the empty list
-	for(int i = bv.size() - 1; i >= 0; --i){ 
-		//if (bv[i]) {
-		//	PL_put_integer(tmp, 1);
-		//} else {  /* 0 and 1 */
-		//	PL_put_integer(tmp, 0);
-		//}
-		
-		if( !PL_put_integer(tmp, bv[i]) ){
-			// putting failed
-			throw PlTypeError("atom", tmp);
-		}
+	std::string _codes;
+	putBitRowCodes(bv, blst, _codes);
+}
 
-		if( !PL_cons_list(blst, tmp, blst) ) //add tmp in front of the list
-		{
-			throw PlTypeError("list", blst);
+
+/**
+* @brief Convert a bool list term into a bitvector. The entries 1 of the list
+* are set in bv, all the other bits are reset.
+* @param term_t blst : a bool list term of the size of bv.
+* @param bitvector& bv : The output parameter.
+* @return no return.
+*/
+void blListTerm2bv(const term_t blst, bitvector& bv)
+{
+	if ( !PL_is_list(blst) ) {
+		throw PlTypeError("list", blst);
+	}
+
+	//the list ref will get modified so copy it
+	term_t tail = PL_copy_term_ref(blst);
+	term_t head = PL_new_term_ref();
+	int x;
+	size_type index = 0;
+	bv.reset();
+	while(PL_get_list(tail, head, tail)){
+		if( !PL_get_integer(head, &x) ) {
+			throw PlTypeError("integer", head);
+		}
+		if (x == 1) {
+			bv.set(index);
 		}
+		++index;
 	}
 }
 
@@ -15,11 +15,18 @@
 #define ARGUMATRIX_CLPB_PROBLEM_HPP
 
 #include <map>
+#include <vector>
 #include <string>
 #include <iostream>
+#include <fstream>
+#include <sstream>
 
 #include "dung_theory/DungAF.hpp"
 #include "dung_theory/GroundedReasoner.hpp"
+#include "dung_theory/PreferredReasoner.hpp"
+#include "dung_theory/SemiStableReasoner.hpp"
+#include "dung_theory/StageReasoner.hpp"
+#include "dung_theory/SccReasoner.hpp"
 #include "config/config.hpp"
 #include "parser/parser.hpp"
 #include "PlReasoner/CompletePlReasoner.hpp"
@@ -54,13 +61,66 @@ void printProblemOptions();
 void printFileFormatOptions();
 
 
+/**
+ * @brief A streambuf which forwards the answers of the tasks to another one,
+ * and remembers the last byte written. Some tasks end their answer without a
+ * newline (e.g., SE-GR), which is fine for a single run, but the answers of a
+ * batch must be on their own lines, see endAnswer().
+ */
+class AnswerStreambuf : public std::streambuf {
+public:
+	explicit AnswerStreambuf(streambuf* sink): m_sink(sink), m_last('\n') {}
+
+	// End the answer written since the last call with a newline, if needed
+	void endAnswer()
+	{
+		if (m_last != '\n') {
+			m_sink->sputc('\n');
+			m_last = '\n';
+		}
+	}
+
+protected:
+	int_type overflow(int_type c)
+	{
+		if (traits_type::eq_int_type(c, traits_type::eof()))
+			return traits_type::not_eof(c);
+		m_last = traits_type::to_char_type(c);
+		return m_sink->sputc(m_last);
+	}
+
+	std::streamsize xsputn(const char* s, std::streamsize n)
+	{
+		if (n > 0)
+			m_last = s[n-1];
+		return m_sink->sputn(s, n);
+	}
+
+	int sync() { return m_sink->pubsync(); }
+
+private:
+	streambuf* m_sink;
+	char m_last;
+};
+
+
 struct ClpbProblem {
 	string m_problemType;
 	string m_fileFmt;
 	string m_inputFile;
 	string m_outputFile;
+	string m_binFile;        // Where to write the binary snapshot, set by -wb
 	set<string> m_otherArgs;
-	bool m_timeFlag;
+	size_type m_threadNum;   // The number of threads, set by -j
+	BackendType m_backend;   // The solver of the constraint models, set by -b
+	bool m_sccFlag;          // Solve component by component, set by -scc
+	size_type m_offset;      // The extensions skipped, set by -offset
+	size_type m_limit;       // The extensions printed at most, set by -limit
+	size_type m_flushEvery;  // Flush after every m_flushEvery extensions, set by -flush
+	ExtensionFormat m_outputFormat;  // How an extension is printed, set by -om
+	string m_queryFile;      // The batch of queries, set by -q ("-" for the standard input)
+	string m_socketPath;     // The socket of the server mode, set by -server
+	string m_statsFormat;    // How the statistics are reported, text or json, set by -t and -stats
 
 	DungAF daf;
 
@@ -77,6 +137,32 @@ struct ClpbProblem {
 
 
 	void reasoning(Reasoner* rsner, const string& task);
+	// Solve the task with the additional arguments argset instead of -a
+	void reasoning(Reasoner* rsner, const string& task, const set<string>& argset);
+
+	/**
+	 * @brief Create the reasoner of the problem, e.g., "DC-CO", on the
+	 * framework _daf with the options of the command line.
+	 * @return NULL if the semantics has no reasoner.
+	 */
+	Reasoner* createReasoner(const DungAF& _daf, const string& problem,
+		streambuf* osbuff);
+
+	/**
+	 * @brief Answer the queries of m_queryFile on the loaded framework. Each
+	 * line is a problem and its additional arguments, e.g., "DC-CO a1" or
+	 * "DS-ST a1,a2", and the lines starting with # are comments. The reasoner
+	 * of a semantics is reused by all its queries, and the consecutive DC (or
+	 * DS) queries of the same problem are decided concurrently with -j. Each
+	 * answer ends with a newline (see AnswerStreambuf).
+	 */
+	void solveBatch(streambuf* osbuff);
+
+	/**
+	 * @brief Report the statistics of the run (see RunStats) to the standard
+	 * error in the format m_statsFormat, if -t or -stats is given.
+	 */
+	void reportStats();
 
 
 	/**
@@ -101,7 +187,17 @@ ClpbProblem::ClpbProblem() :
 	m_fileFmt(""),
 	m_inputFile(""),
 	m_outputFile(""),
-	m_timeFlag(false)
+	m_binFile(""),
+	m_threadNum(1),
+	m_backend(CLPB_BACKEND),
+	m_sccFlag(false),
+	m_offset(0),
+	m_limit(0),
+	m_flushEvery(0),
+	m_outputFormat(FORMAT_LABELS),
+	m_queryFile(""),
+	m_socketPath(""),
+	m_statsFormat("")
 {
 	
 }
@@ -133,6 +229,24 @@ void ClpbProblem::parseParams(int argc, char* argv[])
 				continue;
 			}
 		} else
+		if(strcmp(argv[i],"-server")==0){
+			if((i+1)<argc){
+				m_socketPath = argv[++i];
+				continue;
+			}
+		} else
+		if(strcmp(argv[i],"-q")==0){
+			if((i+1)<argc){
+				m_queryFile = argv[++i];
+				continue;
+			}
+		} else
+		if(strcmp(argv[i],"-wb")==0){
+			if((i+1)<argc){
+				m_binFile = argv[++i];
+				continue;
+			}
+		} else
 		if(strcmp(argv[i],"-a")==0){
 			if((i+1)<argc){
 				parseAddtionalParams(argv[++i]);
@@ -142,8 +256,90 @@ void ClpbProblem::parseParams(int argc, char* argv[])
 			}
 		} else
 		if(strcmp(argv[i],"-t")==0){
-			m_timeFlag = true;
+			if ("" == m_statsFormat)
+				m_statsFormat = "text";
+			RunStats::instance().enable();
+			continue;
+		} else
+		if(strcmp(argv[i],"-stats")==0 || strcmp(argv[i],"--stats")==0){
+			if((i+1)<argc){
+				m_statsFormat = argv[++i];
+				if (m_statsFormat != "text" && m_statsFormat != "json") {
+					cerr << "The statistics format [" << m_statsFormat << "] is not supported!" << endl;
+					cerr << "  The supported options [text,json]" << endl;
+					exit(1);
+				}
+				RunStats::instance().enable();
+				continue;
+			}
+		} else
+		if(strcmp(argv[i],"-scc")==0){
+			m_sccFlag = true;
+			continue;
+		} else
+		if(strcmp(argv[i],"-j")==0){
+			if((i+1)<argc){
+				int _num = atoi(argv[++i]);
+				if (_num < 1) {
+					cerr << "The number of threads must be a positive integer!" << endl;
+					exit(1);
+				}
+				m_threadNum = _num;
+				continue;
+			}
+		} else
+		if(strcmp(argv[i],"-offset")==0 || strcmp(argv[i],"-limit")==0 ||
+			strcmp(argv[i],"-flush")==0){
+			if((i+1)<argc){
+				const char* _opt = argv[i];
+				int _num = atoi(argv[++i]);
+				if (_num < 0) {
+					cerr << "The option " << _opt << " must be a non-negative integer!" << endl;
+					exit(1);
+				}
+				if (strcmp(_opt,"-offset")==0)
+					m_offset = _num;
+				else if (strcmp(_opt,"-limit")==0)
+					m_limit = _num;
+				else
+					m_flushEvery = _num;
+				continue;
+			}
+		} else
+		if(strcmp(argv[i],"-om")==0){
+			if((i+1)<argc){
+				string _format = argv[++i];
+				if (_format == "labels") {
+					m_outputFormat = FORMAT_LABELS;
+				} else
+				if (_format == "indices") {
+					m_outputFormat = FORMAT_INDICES;
+				} else
+				if (_format == "bits") {
+					m_outputFormat = FORMAT_BITS;
+				} else {
+					cerr << "The output mode [" << _format << "] is not supported!" << endl;
+					cerr << "  The supported options [labels,indices,bits]" << endl;
+					exit(1);
+				}
+				continue;
+			}
+		} else
+		if(strcmp(argv[i],"-b")==0){
+			if((i+1)<argc){
+				string _backend = argv[++i];
+				if (_backend == "clpb") {
+					m_backend = CLPB_BACKEND;
+				} else
+				if (_backend == "bdd") {
+					m_backend = BDD_BACKEND;
+				} else {
+					cerr << "The backend [" << _backend << "] is not supported!" << endl;
+					cerr << "  The supported options [clpb,bdd]" << endl;
+					exit(1);
+				}
 				continue;
+			}
 		}
 	}
 }
@@ -154,6 +350,7 @@ void ClpbProblem::loadDungAF()
 		cerr << "No input file!" << endl;
 		exit(1);
 	}
+	StatTimerScope _timer(TIMER_PARSE);
 	if("" == m_fileFmt) {
 		cerr << "The file format must be given!" << endl;
 		printFileFormatOptions();
@@ -171,6 +368,12 @@ void ClpbProblem::loadDungAF()
 			cerr<< "tgf file loading failed."<<endl;
 			exit(1);
 		}
+	} else
+	if(m_fileFmt=="bin") {
+		if(!(argumatrix::parser::Binary2DungAF(m_inputFile, daf))){
+			cerr<< "bin file loading failed."<<endl;
+			exit(1);
+		}
 	} else {
 		cerr << "The file format ["<< m_fileFmt<<"] is not supported!"<< endl;
 		printFileFormatOptions();
@@ -182,10 +385,19 @@ void ClpbProblem::solve()
 {
 	loadDungAF();
 
-	if(m_problemType.size() < 5) {
-		cerr << "The problem type is invalid!" << endl;
-		printProblemOptions();
-		exit(1);
+	// Save the framework for the later runs. The dense attack matrix is
+	// embedded when the reasoners would store it, and then it takes at most
+	// 8 bytes per attack (see SPARSE_DENSITY_THRESHOLD).
+	if ("" != m_binFile) {
+		bool _with_matrix = daf.getNumberOfArguments() > 0 &&
+			daf.getSparseAttackMatrix().density() >= SPARSE_DENSITY_THRESHOLD;
+		if (!argumatrix::parser::DungAF2Binary(daf, m_binFile, _with_matrix)) {
+			cerr << "Can not write the binary snapshot: " << m_binFile << endl;
+			exit(1);
+		}
+		// Only convert the file if no problem is given
+		if ("" == m_problemType && "" == m_queryFile)
+			return;
 	}
 
 	// Osbuff
@@ -204,29 +416,74 @@ void ClpbProblem::solve()
 		osbuff = ofs.rdbuf();
 	}
 
-	string sm_type = m_problemType.substr(3,2);  // Get the semantics option
-	string sm_full = m_problemType.substr(3);
+	if ("" != m_queryFile) {
+		solveBatch(osbuff);
+		return;
+	}
+
+	if(m_problemType.size() < 5) {
+		cerr << "The problem type is invalid!" << endl;
+		printProblemOptions();
+		exit(1);
+	}
+
 	string tsk_type = m_problemType.substr(0,2); // Get the Task option
-	
+	Reasoner* rsner = createReasoner(daf, m_problemType, osbuff);
+
+	// Do reason TASK
+	if (rsner != NULL) {
+		reasoning(rsner, tsk_type);
+
+		delete rsner;
+	}
+}
+
+Reasoner* ClpbProblem::createReasoner(const DungAF& _daf, const string& problem,
+	streambuf* osbuff)
+{
+	string sm_type = problem.substr(3,2);  // Get the semantics option
+	string sm_full = problem.substr(3);
+
 	Reasoner* rsner = NULL;
 	
+	// SST and STG before the two-letter options, since STG starts with ST
+	if (sm_full == "SST") {
+		rsner = new SemiStableReasoner(_daf, osbuff);
+	} else
+	if (sm_full == "STG") {
+		rsner = new StageReasoner(_daf, osbuff);
+	} else
+	if (m_sccFlag && (sm_type == "CO" || sm_type == "ST" || sm_type == "PR")) {
+		// The reasoners of the components write nothing to osbuff
+		BackendType _backend = m_backend;
+		ReasonerFactory _factory = [=](const DungAF& _local) -> Reasoner* {
+			if (sm_type == "CO")
+				return new CompletePlReasoner(_local, sm_full, osbuff, _backend);
+			if (sm_type == "ST")
+				return new StablePlReasoner(_local, sm_full, osbuff, _backend);
+			return new PreferredReasoner(_local, osbuff);
+		};
+		SccSemantics _sem = (sm_type == "CO") ? SCC_COMPLETE
+			: (sm_type == "ST") ? SCC_STABLE : SCC_PREFERRED;
+		rsner = new SccReasoner(_daf, _sem, _factory, osbuff);
+	} else
 	if (sm_type == "CF") {
-		rsner = new ConflictfreePlReasoner(daf, sm_full, osbuff);
+		rsner = new ConflictfreePlReasoner(_daf, sm_full, osbuff, m_backend);
 	} else 
 	if (sm_type == "ST") {
-		rsner = new StablePlReasoner(daf, sm_full, osbuff);
+		rsner = new StablePlReasoner(_daf, sm_full, osbuff, m_backend);
 	} else
 	if (sm_type == "AD") {
-		rsner = new AdmissiblePlReasoner(daf, sm_full, osbuff);
+		rsner = new AdmissiblePlReasoner(_daf, sm_full, osbuff, m_backend);
 	} else
 	if (sm_type == "CO") {
-		rsner = new CompletePlReasoner(daf, sm_full, osbuff);
+		rsner = new CompletePlReasoner(_daf, sm_full, osbuff, m_backend);
 	} else
 	if (sm_type == "GR") {
-		rsner = new GroundedReasoner(daf, osbuff);
+		rsner = new GroundedReasoner(_daf, osbuff);
 	} else
 	if (sm_type == "PR") {
-		//reasoning<CompletePlReasoner>(TODO, TODO);
+		rsner = new PreferredReasoner(_daf, osbuff);
 	} 
 	else {
 		cerr << "The semantics [" << sm_type << "] "
@@ -235,16 +492,114 @@ void ClpbProblem::solve()
 		exit(1);
 	}
 
-	// Do reason TASK
 	if (rsner != NULL) {
-		reasoning(rsner, tsk_type);
+		rsner->setThreadNum(m_threadNum);
+		rsner->setEnumerationWindow(m_offset, m_limit);
+		rsner->setFlushInterval(m_flushEvery);
+		rsner->setOutputFormat(m_outputFormat);
+	}
+	return rsner;
+}
 
-		delete rsner;
+void ClpbProblem::solveBatch(streambuf* osbuff)
+{
+	ifstream ifs;
+	if (m_queryFile != "-") {
+		ifs.open(m_queryFile.c_str());
+		if (!ifs) {
+			cerr << "Can not open the query file: " << m_queryFile << endl;
+			exit(1);
+		}
 	}
+	istream& _in = (m_queryFile == "-") ? std::cin : ifs;
+	AnswerStreambuf _answers(osbuff);
+
+	// The reasoners by their semantics option (e.g., CO1), created by the
+	// first query of the semantics and reused by the later ones, so that the
+	// attack matrix term and the grounded labelling are built once
+	map<string, Reasoner*> _reasoners;
+
+	// The consecutive DC (or DS) queries of the same problem, decided
+	// together by task_DBatch() when there are several threads
+	string _batchProblem;
+	vector< set<string> > _batch;
+	const size_type _batchMax = 64 * m_threadNum;
+
+	string _line;
+	size_type _lineNo = 0;
+	bool _eof = false;
+	while (!_eof) {
+		_eof = !std::getline(_in, _line);
+		++_lineNo;
+
+		string _problem, _args;
+		if (!_eof) {
+			istringstream _iss(_line);
+			_iss >> _problem >> _args;
+			// Skip the empty lines and the comments
+			if (_problem.empty() || _problem[0] == '#')
+				continue;
+			if (_problem.size() < 5 || _problem[2] != '-') {
+				cerr << "The problem type [" << _problem << "] at line "
+					<< _lineNo << " of the query file is invalid!" << endl;
+				exit(1);
+			}
+		}
+
+		// Answer the pending batch before the other queries
+		if (!_batch.empty() && (_eof || _problem != _batchProblem)) {
+			_reasoners[_batchProblem.substr(3)]->task_DBatch(
+				_batch, _batchProblem.substr(0,2) == "DS");
+			_answers.endAnswer();
+			_batch.clear();
+		}
+		if (_eof)
+			break;
+
+		string sm_full = _problem.substr(3);
+		string tsk_type = _problem.substr(0,2);
+		map<string, Reasoner*>::iterator _itr = _reasoners.find(sm_full);
+		if (_itr == _reasoners.end()) {
+			Reasoner* _rsner = createReasoner(daf, _problem, &_answers);
+			if (_rsner == NULL) {
+				cerr << "The problem [" << _problem << "] at line "
+					<< _lineNo << " of the query file is not supported!" << endl;
+				exit(1);
+			}
+			_itr = _reasoners.insert(make_pair(sm_full, _rsner)).first;
+		}
+
+		parseAddtionalParams(_args);
+		if (m_threadNum > 1 && (tsk_type == "DC" || tsk_type == "DS")) {
+			_batchProblem = _problem;
+			_batch.push_back(m_otherArgs);
+			if (_batch.size() >= _batchMax) {
+				_itr->second->task_DBatch(_batch, tsk_type == "DS");
+				_answers.endAnswer();
+				_batch.clear();
+			}
+		} else {
+			reasoning(_itr->second, tsk_type);
+			_answers.endAnswer();
+		}
+	}
+
+	map<string, Reasoner*>::iterator _itr = _reasoners.begin();
+	for ( ; _itr != _reasoners.end(); ++_itr)
+		delete _itr->second;
+	_answers.pubsync();
 }
 
+__inline
 void ClpbProblem::reasoning(Reasoner* rsner, const string& task)
 {
+	reasoning(rsner, task, m_otherArgs);
+}
+
+void ClpbProblem::reasoning(Reasoner* rsner, const string& task,
+	const set<string>& argset)
+{
+	StatTimerScope _timer(TIMER_SOLVE);
 	if (task == "EE") {
 		rsner->task_EE();
 	} else 
@@ -252,17 +607,17 @@ void ClpbProblem::reasoning(Reasoner* rsner, const string& task)
 		rsner->task_EX();
 	} else 
 	if (task == "EC") {
-		rsner->task_EC(m_otherArgs);
+		rsner->task_EC(argset);
 	} else
 	if (task == "SC") {
-		rsner->task_SC(m_otherArgs);
+		rsner->task_SC(argset);
 	} else
 	if (task == "SE") {
 		rsner->task_SE();
 	} else
 	if (task == "DE")
 	{
-		rsner->task_DE(m_otherArgs);
+		rsner->task_DE(argset);
 	} else
 	if (task == "DN")
 	{
@@ -270,17 +625,32 @@ void ClpbProblem::reasoning(Reasoner* rsner, const string& task)
 	} else 
 	if (task == "DC")
 	{
-		rsner->task_DC(m_otherArgs);
+		rsner->task_DC(argset);
 	} else
 	if (task == "DS")
 	{
-		rsner->task_DS(m_otherArgs);
+		rsner->task_DS(argset);
 	} else {
 		cerr << "The task [" << task << "] "
 			<< "is not supported!" << endl;
 		printProblemOptions();
 		exit(1);
 	}
+
+	// The stacks are sampled once per task, since the peak is not kept
+	samplePlStacks();
+}
+
+void ClpbProblem::reportStats()
+{
+	if ("" == m_statsFormat)
+		return;
+
+	samplePlStacks();
+	if (m_statsFormat == "json")
+		RunStats::instance().printJson(std::cerr);
+	else
+		RunStats::instance().printText(std::cerr);
 }
 
 void ClpbProblem::parseAddtionalParams(const string& oargs)
@@ -345,7 +715,11 @@ void printHelpInfo()
 	std::cout<< "argmat-clpb " << "-p <problem> "
 		<< "-f <file> " << "-fo <fileformat> "
 		<< "[-a <additional_parameter>] " 
-		<< "[-o <file>] " << "[-t]" << endl;
+		<< "[-o <file>] " << "[-wb <file>] " << "[-t] " << "[-stats <fmt>] " << "[-j <threads>] " << "[-b <backend>] " << "[-scc]" << endl
+		<< INDENT << "[-offset <n>] " << "[-limit <n>] " << "[-flush <n>] " << "[-om <mode>]" << endl;
+	std::cout<< "argmat-clpb " << "-q <queries> "
+		<< "-f <file> " << "-fo <fileformat> " << "[options]" << endl;
+	std::cout<< "argmat-clpb " << "-server <socket> " << "[options]" << endl;
 	std::cout<< "<problem>" << endl
 		<< INDENT;
 	printProblemOptions();
@@ -354,6 +728,55 @@ void printHelpInfo()
 		<< INDENT;
 	printFileFormatOptions();
 
+	std::cout<< "-q <queries>" << endl
+		<< INDENT << "Answer a file of queries (- for the standard input) on the framework" << endl
+		<< INDENT << "loaded once, a problem and its arguments per line, e.g., DC-CO a1 or" << endl
+		<< INDENT << "DS-ST a1,a2. With -j, the consecutive DC (or DS) queries of the same" << endl
+		<< INDENT << "problem are decided concurrently." << endl;
+
+	std::cout<< "-server <socket>" << endl
+		<< INDENT << "Serve the clients of the Unix domain socket, with -j workers. The" << endl
+		<< INDENT << "requests are LOAD <key> <fileformat> <file>, QUERY <key> <problem>" << endl
+		<< INDENT << "[<arg1,arg2,...>], UNLOAD <key>, QUIT and SHUTDOWN, one per line, and" << endl
+		<< INDENT << "each response ends with a line OK or ERROR <message>. A loaded framework" << endl
+		<< INDENT << "is changed by ADDARG <key> <arg>, DELARG <key> <arg>, ADDATT <key> <arg1>" << endl
+		<< INDENT << "<arg2> and DELATT <key> <arg1> <arg2>." << endl;
+
+	std::cout<< "-wb <file>" << endl
+		<< INDENT << "Write the framework as a binary snapshot, which can be loaded by -fo bin." << endl;
+
+	std::cout<< "<threads>" << endl
+		<< INDENT << "The number of threads of the parallel reasoners (default 1)." << endl;
+
+	std::cout<< "<backend>" << endl
+		<< INDENT << "The solver of the constraint models of CF, ST, AD and CO:" << endl
+		<< INDENT << "clpb (SWI-Prolog CLP(B), default) or bdd (in-process BDDs)." << endl
+		<< INDENT << "The models CFS, STS, ADS and COS (e.g., -p EE-COS) take the attacker" << endl
+		<< INDENT << "lists instead of the attack matrix, for large sparse frameworks." << endl
+		<< INDENT << "The preferred (PR), semi-stable (SST) and stage (STG) semantics are" << endl
+		<< INDENT << "answered by native labelling searches, e.g., -p EE-SST." << endl;
+
+	std::cout<< "-offset <n>, -limit <n>" << endl
+		<< INDENT << "Print the extensions of EE, EX and EC from the (n+1)-th one (-offset)," << endl
+		<< INDENT << "and at most n of them (-limit, default 0 for all)." << endl;
+
+	std::cout<< "-flush <n>" << endl
+		<< INDENT << "Flush the output after every n extensions, as they are found." << endl;
+
+	std::cout<< "-om <mode>" << endl
+		<< INDENT << "How EE, EX and EC print an extension: labels ([a,c], default)," << endl
+		<< INDENT << "indices ([0,2], the indices of the arguments) or bits (101)." << endl;
+
+	std::cout<< "-t, -stats <fmt>" << endl
+		<< INDENT << "Report the statistics of the run to the standard error: the time of" << endl
+		<< INDENT << "the phases, the grounded iterations, the cells of the Prolog terms," << endl
+		<< INDENT << "the Prolog solutions, the peak RSS and the Prolog stacks, in text" << endl
+		<< INDENT << "(-t) or in one line of json (-stats json, or --stats json)." << endl;
+
+	std::cout<< "-scc" << endl
+		<< INDENT << "Solve CO, ST and PR component by component, following the strongly" << endl
+		<< INDENT << "connected components of the argument graph." << endl;
+
 
 	/*how to display version information.*/
 	std::cout<< "argmat-clpb --version" <<endl
@@ -390,7 +813,7 @@ void printVersionInfo()
 void printFileFormatOptions()
 {
 	cout << "The supported file formats:" << endl;
-	cout << INDENT << "[apx,tgf]" <<  endl;
+	cout << INDENT << "[apx,tgf,bin]" <<  endl;
 }
 
 void printProblemOptions()
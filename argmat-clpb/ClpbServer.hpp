@@ -0,0 +1,647 @@
+/*!
+ * @file ClpbServer.hpp
+ *
+ * @author Fuan Pu
+ * Contact: Pu.Fuan@gmail.com
+ *
+ * @brief The server mode of argmat-clpb, which keeps the loaded frameworks
+ * and their reasoners, and answers the requests of the clients over a Unix
+ * domain socket.
+ */
+#ifndef ARGUMATRIX_CLPB_SERVER_HPP
+#define ARGUMATRIX_CLPB_SERVER_HPP
+
+#include <map>
+#include <set>
+#include <deque>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <algorithm>
+#include <string.h>
+#include <errno.h>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <signal.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#include "ClpbProblem.hpp"
+#include "PlReasoner/PlEnginePool.hpp"
+#include "PlReasoner/ClpbBackend.hpp"
+#include "dung_theory/IncrementalGrounded.hpp"
+
+namespace argumatrix{
+
+using namespace std;
+
+/**
+ * @brief A daemon answering the requests of the clients connected to a Unix
+ * domain socket, one request per line, and each response ends with a line
+ * OK or ERROR <message>:
+ *   - LOAD <key> <fileformat> <file>: load a framework (as -f and -fo), and
+ *     keep it under the key, replacing the framework of the same key;
+ *   - QUERY <key> <problem> [<arg1,arg2,...>]: solve a problem (as -p and -a)
+ *     on the framework of the key; the output of the task precedes OK, or
+ *     it is replaced by ERROR if the solver fails, e.g., out of stack;
+ *   - ADDARG <key> <arg>, DELARG <key> <arg>, ADDATT <key> <arg1> <arg2>,
+ *     DELATT <key> <arg1> <arg2>: change the framework of the key, i.e., add
+ *     or remove an argument (with its attacks), or the attacks from arg1 to
+ *     arg2 (ADDATT adds the arguments not in the framework);
+ *   - UNLOAD <key>: forget the framework, its reasoners and its matrix terms;
+ *   - QUIT: close the connection; SHUTDOWN: stop the server.
+ * The reasoners of a framework are created by its first query of each
+ * semantics option, with the options of the command line (see
+ * ClpbProblem::createReasoner()), and are reused by the later queries, so
+ * that the Prolog initialisation, the parsing and the attack matrix terms
+ * are paid once. A change of a framework drops its reasoners, which are
+ * created again by the next queries, but its grounded labelling is kept by
+ * an IncrementalGrounded and given to the new reasoners, so that the GR
+ * queries, and the preprocessing of the others, are not recomputed from
+ * scratch. The main thread polls the connections, and hands a
+ * connection with a pending request to a pool of workers, each on its own
+ * engine of the PlEnginePool, so that the clients run concurrently and an
+ * idle client holds no worker.
+ * ~~~~~{.sh}
+ *   argmat-clpb -server /tmp/argmat.sock -j 4 &
+ *   printf 'LOAD g apx af.apx\nQUERY g DC-CO a1\n' | nc -U /tmp/argmat.sock
+ * ~~~~~
+ */
+class ClpbServer {
+public:
+	/**
+	 * @param problem the options of the command line; the number of threads
+	 * (-j) is the number of the workers.
+	 */
+	explicit ClpbServer(ClpbProblem& problem);
+
+	// Listen on the socket path, and serve the clients until SHUTDOWN
+	void run(const string& path);
+
+private:
+	// A loaded framework and its reasoners by their semantics option
+	struct Framework {
+		DungAF m_daf;
+		std::unique_ptr<IncrementalGrounded> m_grounded;  /**< Observes m_daf */
+		std::mutex m_mtx;  /**< Protect m_reasoners, and serialize the queries and the changes */
+		map<string, Reasoner*> m_reasoners;
+
+		~Framework();
+
+		// Delete the reasoners, and the matrix terms of the revision
+		void dropReasoners(uint64_t revision);
+	};
+	typedef std::shared_ptr<Framework> FrameworkPtr;
+
+	// A client connection, and the part of its next request already read
+	struct Connection {
+		int m_fd;
+		string m_pending;
+
+		explicit Connection(int fd): m_fd(fd) {}
+	};
+
+	ClpbServer(const ClpbServer&);
+	ClpbServer& operator=(const ClpbServer&);
+
+	// The loop of a worker: serve the connections taken from the queue
+	void work();
+
+	/**
+	 * Read the available bytes of a connection, and answer its complete
+	 * requests, without waiting for more.
+	 * @return false if the connection must be closed
+	 */
+	bool serve(Connection* _conn);
+
+	// Give a served connection back to the poll loop of run()
+	void giveBack(Connection* _conn);
+
+	// Wake up the poll loop of run()
+	void wakeUp();
+
+	// Handle a request line, and write the response into _out
+	// @return false if the connection must be closed
+	bool handle(const string& _line, ostringstream& _out);
+
+	bool load(const string& _key, const string& _fmt, const string& _file, string& _error);
+	bool query(const string& _key, const string& _problem, const string& _args,
+		ostringstream& _out, string& _error);
+
+	// Apply the change _cmd, e.g., ADDATT, to the framework of the key
+	bool update(const string& _cmd, const string& _key, const string& _a,
+		const string& _b, string& _error);
+
+	// The framework of the key, NULL if it is not loaded
+	FrameworkPtr find(const string& _key, string& _error);
+
+	// Whether the problem, e.g., "DC-CO1", has a reasoner and a task
+	static bool checkProblem(const string& _problem, string& _error);
+
+	// Write all the bytes of _data to the socket _fd
+	static bool sendAll(int _fd, const string& _data);
+
+	ClpbProblem& m_problem;
+
+	std::mutex m_frameworksMtx;
+	map<string, FrameworkPtr> m_frameworks;
+
+	std::mutex m_queueMtx;
+	std::condition_variable m_queueCv;
+	deque<Connection*> m_ready;     /**< The connections to serve, NULL stops a worker */
+	vector<Connection*> m_served;   /**< The connections given back by the workers */
+
+	int m_listenFd;
+	int m_wakeFds[2];  /**< A pipe waking up the poll loop */
+	bool m_stop;
+};
+
+
+ClpbServer::Framework::~Framework()
+{
+	// The reasoners refer to m_daf, so that they are deleted first
+	dropReasoners(m_daf.getRevision());
+}
+
+void ClpbServer::Framework::dropReasoners(uint64_t revision)
+{
+	map<string, Reasoner*>::iterator _itr = m_reasoners.begin();
+	for ( ; _itr != m_reasoners.end(); ++_itr)
+		delete _itr->second;
+	m_reasoners.clear();
+
+	// The matrix terms of the framework on the engines
+	PlMatrixTermCache::instance().evict(revision);
+}
+
+ClpbServer::ClpbServer(ClpbProblem& problem):
+	m_problem(problem),
+	m_listenFd(-1),
+	m_stop(false)
+{
+	m_wakeFds[0] = m_wakeFds[1] = -1;
+}
+
+#ifndef _WIN32
+
+void ClpbServer::run(const string& path)
+{
+	// A client closing its connection must not kill the server
+	signal(SIGPIPE, SIG_IGN);
+
+	struct sockaddr_un _addr;
+	memset(&_addr, 0, sizeof(_addr));
+	_addr.sun_family = AF_UNIX;
+	if (path.size() >= sizeof(_addr.sun_path)) {
+		cerr << "The socket path is too long: " << path << endl;
+		exit(1);
+	}
+	strcpy(_addr.sun_path, path.c_str());
+
+	m_listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	unlink(path.c_str());
+	if (m_listenFd < 0 || bind(m_listenFd, (struct sockaddr*)&_addr, sizeof(_addr)) < 0
+		|| listen(m_listenFd, 64) < 0) {
+		cerr << "Can not listen on the socket: " << path << " (" << strerror(errno) << ")" << endl;
+		exit(1);
+	}
+
+	if (pipe(m_wakeFds) < 0) {
+		cerr << "Can not create the pipe of the server (" << strerror(errno) << ")" << endl;
+		exit(1);
+	}
+
+	// The workers, each with its own Prolog engine
+	size_type _workerNum = m_problem.m_threadNum;
+	PlEnginePool::instance().reserve(_workerNum);
+	vector<std::thread> _workers;
+	for (size_type k = 0; k < _workerNum; ++k)
+		_workers.push_back(std::thread(&ClpbServer::work, this));
+
+	// The idle connections, waiting for a request
+	vector<Connection*> _idle;
+	vector<struct pollfd> _fds;
+	while (true) {
+		{
+			std::lock_guard<std::mutex> _lock(m_queueMtx);
+			if (m_stop)
+				break;
+			_idle.insert(_idle.end(), m_served.begin(), m_served.end());
+			m_served.clear();
+		}
+
+		// The listening socket, the pipe, and then the idle connections
+		_fds.resize(2 + _idle.size());
+		_fds[0].fd = m_listenFd;
+		_fds[1].fd = m_wakeFds[0];
+		for (size_type k = 0; k < _idle.size(); ++k)
+			_fds[2 + k].fd = _idle[k]->m_fd;
+		for (size_type k = 0; k < _fds.size(); ++k) {
+			_fds[k].events = POLLIN;
+			_fds[k].revents = 0;
+		}
+
+		if (poll(&_fds[0], _fds.size(), -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			cerr << "The server can not poll the connections (" << strerror(errno) << ")" << endl;
+			break;
+		}
+
+		if (_fds[1].revents != 0) {
+			char _buf[256];
+			if (read(m_wakeFds[0], _buf, sizeof(_buf)) < 0 && errno != EINTR && errno != EAGAIN)
+				break;
+		}
+
+		// A request, or the end of the connection, is served by a worker
+		size_type _kept = 0;
+		for (size_type k = 0; k < _idle.size(); ++k) {
+			if (_fds[2 + k].revents != 0) {
+				std::lock_guard<std::mutex> _lock(m_queueMtx);
+				m_ready.push_back(_idle[k]);
+				m_queueCv.notify_one();
+			} else {
+				_idle[_kept++] = _idle[k];
+			}
+		}
+		_idle.resize(_kept);
+
+		if (_fds[0].revents != 0) {
+			int _fd = accept(m_listenFd, NULL, NULL);
+			if (_fd >= 0)
+				_idle.push_back(new Connection(_fd));
+		}
+	}
+
+	// The requests in progress are answered, and the other connections are
+	// closed
+	{
+		std::lock_guard<std::mutex> _lock(m_queueMtx);
+		for (size_type k = 0; k < _workers.size(); ++k)
+			m_ready.push_back(NULL);
+		m_queueCv.notify_all();
+	}
+	for (size_type k = 0; k < _workers.size(); ++k)
+		_workers[k].join();
+
+	_idle.insert(_idle.end(), m_served.begin(), m_served.end());
+	_idle.insert(_idle.end(), m_ready.begin(), m_ready.end());
+	m_served.clear();
+	m_ready.clear();
+	for (size_type k = 0; k < _idle.size(); ++k) {
+		if (_idle[k] != NULL) {
+			close(_idle[k]->m_fd);
+			delete _idle[k];
+		}
+	}
+
+	close(m_wakeFds[0]);
+	close(m_wakeFds[1]);
+	close(m_listenFd);
+	unlink(path.c_str());
+}
+
+void ClpbServer::work()
+{
+	PlEngineScope _scope(PlEnginePool::instance());
+	while (true) {
+		Connection* _conn;
+		{
+			std::unique_lock<std::mutex> _lock(m_queueMtx);
+			m_queueCv.wait(_lock, [this]() { return !m_ready.empty(); });
+			_conn = m_ready.front();
+			m_ready.pop_front();
+		}
+		if (_conn == NULL)
+			return;
+
+		if (serve(_conn)) {
+			giveBack(_conn);
+		} else {
+			close(_conn->m_fd);
+			delete _conn;
+		}
+	}
+}
+
+bool ClpbServer::serve(Connection* _conn)
+{
+	// The connection is readable, and the later reads do not wait
+	char _buf[4096];
+	while (true) {
+		ssize_t _n = recv(_conn->m_fd, _buf, sizeof(_buf), MSG_DONTWAIT);
+		if (_n < 0 && errno == EINTR)
+			continue;
+		if (_n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+		if (_n <= 0)
+			return false;
+		_conn->m_pending.append(_buf, _n);
+		if (_n < (ssize_t)sizeof(_buf))
+			break;
+	}
+
+	size_type _end;
+	while ((_end = _conn->m_pending.find('\n')) != string::npos) {
+		string _line = _conn->m_pending.substr(0, _end);
+		_conn->m_pending.erase(0, _end + 1);
+
+		ostringstream _out;
+		bool _keep = handle(_line, _out);
+		if (!sendAll(_conn->m_fd, _out.str()) || !_keep)
+			return false;
+	}
+	return true;
+}
+
+void ClpbServer::giveBack(Connection* _conn)
+{
+	{
+		std::lock_guard<std::mutex> _lock(m_queueMtx);
+		m_served.push_back(_conn);
+	}
+	wakeUp();
+}
+
+void ClpbServer::wakeUp()
+{
+	char _c = 0;
+	while (write(m_wakeFds[1], &_c, 1) < 0 && errno == EINTR)
+		;
+}
+
+bool ClpbServer::sendAll(int _fd, const string& _data)
+{
+	const char* _p = _data.data();
+	size_type _len = _data.size();
+	while (_len > 0) {
+		ssize_t _n = send(_fd, _p, _len, 0);
+		if (_n < 0) {
+			if (errno == EINTR)
+				continue;
+			return false;
+		}
+		_p += _n;
+		_len -= _n;
+	}
+	return true;
+}
+
+#else
+
+void ClpbServer::run(const string& path)
+{
+	cerr << "The server mode needs Unix domain sockets." << endl;
+	exit(1);
+}
+
+#endif  // _WIN32
+
+bool ClpbServer::handle(const string& _line, ostringstream& _out)
+{
+	istringstream _iss(_line);
+	string _cmd, _key, _a, _b;
+	_iss >> _cmd >> _key >> _a >> _b;
+
+	string _error;
+	if (_cmd == "LOAD" && _key != "" && _b != "") {
+		if (load(_key, _a, _b, _error)) {
+			_out << "OK" << endl;
+		} else {
+			_out << "ERROR " << _error << endl;
+		}
+	} else
+	if (_cmd == "QUERY" && _a != "") {
+		if (query(_key, _a, _b, _out, _error)) {
+			_out << "OK" << endl;
+		} else {
+			_out << "ERROR " << _error << endl;
+		}
+	} else
+	if (((_cmd == "ADDARG" || _cmd == "DELARG") && _a != "") ||
+		((_cmd == "ADDATT" || _cmd == "DELATT") && _b != "")) {
+		if (update(_cmd, _key, _a, _b, _error)) {
+			_out << "OK" << endl;
+		} else {
+			_out << "ERROR " << _error << endl;
+		}
+	} else
+	if (_cmd == "UNLOAD" && _key != "") {
+		std::lock_guard<std::mutex> _lock(m_frameworksMtx);
+		if (m_frameworks.erase(_key) > 0) {
+			_out << "OK" << endl;
+		} else {
+			_out << "ERROR The framework [" << _key << "] is not loaded" << endl;
+		}
+	} else
+	if (_cmd == "QUIT") {
+		_out << "OK" << endl;
+		return false;
+	} else
+	if (_cmd == "SHUTDOWN") {
+		{
+			std::lock_guard<std::mutex> _lock(m_queueMtx);
+			m_stop = true;
+		}
+#ifndef _WIN32
+		wakeUp();
+#endif
+		_out << "OK" << endl;
+		return false;
+	} else
+	if (_cmd != "") {
+		_out << "ERROR The request is invalid: " << _line << endl;
+	}
+	return true;
+}
+
+bool ClpbServer::load(const string& _key, const string& _fmt, const string& _file,
+	string& _error)
+{
+	FrameworkPtr _fw(new Framework());
+	bool _loaded;
+	if (_fmt == "apx") {
+		_loaded = argumatrix::parser::Aspartix2DungAF(_file, _fw->m_daf);
+	} else
+	if (_fmt == "tgf") {
+		_loaded = argumatrix::parser::TrivialGraph2DungAF(_file, _fw->m_daf);
+	} else
+	if (_fmt == "bin") {
+		_loaded = argumatrix::parser::Binary2DungAF(_file, _fw->m_daf);
+	} else {
+		_error = "The file format [" + _fmt + "] is not supported";
+		return false;
+	}
+	if (!_loaded) {
+		_error = _fmt + " file loading failed: " + _file;
+		return false;
+	}
+	_fw->m_grounded.reset(new IncrementalGrounded(_fw->m_daf));
+
+	// The queries in progress keep the replaced framework alive
+	std::lock_guard<std::mutex> _lock(m_frameworksMtx);
+	m_frameworks[_key] = _fw;
+	return true;
+}
+
+bool ClpbServer::query(const string& _key, const string& _problem, const string& _args,
+	ostringstream& _out, string& _error)
+{
+	if (!checkProblem(_problem, _error))
+		return false;
+
+	FrameworkPtr _fw = find(_key, _error);
+	if (!_fw)
+		return false;
+
+	// The queries of a framework are serialized, since the reasoners are
+	// not thread-safe; the frameworks are queried concurrently
+	std::lock_guard<std::mutex> _lock(_fw->m_mtx);
+
+	// The arguments arg1[,arg2,...], which must be in the framework, since
+	// the reasoners exit on an unknown argument
+	set<string> _argset;
+	size_type _bgn = 0;
+	while (_bgn < _args.size()) {
+		size_type _end = _args.find(',', _bgn);
+		if (_end == string::npos)
+			_end = _args.size();
+		string _arg = _args.substr(_bgn, _end - _bgn);
+		if (_arg.empty() || !_fw->m_daf.hasArgument(_arg)) {
+			_error = "The argument [" + _arg + "] is not in the framework";
+			return false;
+		}
+		_argset.insert(_arg);
+		_bgn = _end + 1;
+	}
+
+	string _task = _problem.substr(0,2);
+	if (_argset.empty() && (_task == "EC" || _task == "SC" || _task == "DC" || _task == "DS")) {
+		_error = "The task " + _task + " needs additional arguments";
+		return false;
+	}
+
+	string sm_full = _problem.substr(3);
+	map<string, Reasoner*>::iterator _itr = _fw->m_reasoners.find(sm_full);
+	if (_itr == _fw->m_reasoners.end()) {
+		Reasoner* _rsner = m_problem.createReasoner(_fw->m_daf, _problem, std::cout.rdbuf());
+		if (_rsner == NULL) {
+			_error = "The problem [" + _problem + "] is not supported";
+			return false;
+		}
+		// The worker threads hold the engines of the pool
+		_rsner->setThreadNum(1);
+		_rsner->setGroundedIntVector(_fw->m_grounded->getLabels());
+		_itr = _fw->m_reasoners.insert(make_pair(sm_full, _rsner)).first;
+	}
+
+	// The terminator must be on a line of its own, see AnswerStreambuf
+	Reasoner* _rsner = _itr->second;
+	AnswerStreambuf _answer(_out.rdbuf());
+	_rsner->setOutput(&_answer);
+	try {
+		m_problem.reasoning(_rsner, _task, _argset);
+	} catch (BackendError& ex) {
+		// The partial answer is dropped, and so is the reasoner, which may
+		// be left in the middle of its task
+		_fw->m_reasoners.erase(_itr);
+		delete _rsner;
+		_out.str("");
+		_error = ex.what();
+		std::replace(_error.begin(), _error.end(), '\n', ' ');
+		return false;
+	}
+	_answer.endAnswer();
+	_rsner->setOutput(std::cout);
+	return true;
+}
+
+bool ClpbServer::update(const string& _cmd, const string& _key, const string& _a,
+	const string& _b, string& _error)
+{
+	FrameworkPtr _fw = find(_key, _error);
+	if (!_fw)
+		return false;
+
+	std::lock_guard<std::mutex> _lock(_fw->m_mtx);
+	DungAF& daf = _fw->m_daf;
+	if (_cmd != "ADDARG" && _cmd != "ADDATT") {
+		if (!daf.hasArgument(_a) || (_cmd == "DELATT" && !daf.hasArgument(_b))) {
+			_error = "The argument [" + (daf.hasArgument(_a) ? _b : _a) + "] is not in the framework";
+			return false;
+		}
+	}
+
+	// The reasoners and the matrix terms are of the revision before the
+	// change; the grounded labelling is repaired by the change
+	const uint64_t _revision = daf.getRevision();
+	if (_cmd == "ADDARG") {
+		if (daf.hasArgument(_a))
+			return true;
+		daf.addArgument(_a);
+	} else
+	if (_cmd == "DELARG") {
+		daf.removeArgument(daf.getArgumentIdx(_a));
+	} else
+	if (_cmd == "ADDATT") {
+		daf.addAttack(_a, _b);
+	} else {
+		daf.removeAttack(daf.getArgumentIdx(_a), daf.getArgumentIdx(_b));
+	}
+	_fw->dropReasoners(_revision);
+	return true;
+}
+
+ClpbServer::FrameworkPtr ClpbServer::find(const string& _key, string& _error)
+{
+	std::lock_guard<std::mutex> _lock(m_frameworksMtx);
+	map<string, FrameworkPtr>::iterator _itr = m_frameworks.find(_key);
+	if (_itr == m_frameworks.end()) {
+		_error = "The framework [" + _key + "] is not loaded";
+		return FrameworkPtr();
+	}
+	return _itr->second;
+}
+
+bool ClpbServer::checkProblem(const string& _problem, string& _error)
+{
+	// The semantics options supported by the reasoners, which exit on the
+	// others
+	static const char* _options[] = {
+		"CF", "CF1", "CF2", "CF3", "CFS",
+		"ST", "ST1", "ST2", "STS",
+		"AD", "AD1", "AD2", "AD3", "AD4", "AD5", "AD6", "ADS",
+		"CO", "CO1", "CO2", "CO3", "CO4", "CO5", "CO6", "COS",
+		"GR", "PR", "SST", "STG"
+	};
+	static const char* _tasks[] = {
+		"EE", "EX", "EC", "SC", "SE", "DE", "DN", "DC", "DS"
+	};
+
+	if (_problem.size() >= 5 && _problem[2] == '-') {
+		string _task = _problem.substr(0,2);
+		string _option = _problem.substr(3);
+		bool _taskOk = false, _optionOk = false;
+		for (size_type k = 0; k < sizeof(_tasks)/sizeof(_tasks[0]); ++k)
+			_taskOk = _taskOk || _task == _tasks[k];
+		for (size_type k = 0; k < sizeof(_options)/sizeof(_options[0]); ++k)
+			_optionOk = _optionOk || _option == _options[k];
+		if (_taskOk && _optionOk)
+			return true;
+	}
+
+	_error = "The problem [" + _problem + "] is not supported";
+	return false;
+}
+
+} // namespace argumatrix
+
+#endif  // ARGUMATRIX_CLPB_SERVER_HPP
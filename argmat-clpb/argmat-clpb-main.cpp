@@ -6,6 +6,7 @@
 #include <string>
 
 #include "ClpbProblem.hpp"
+#include "ClpbServer.hpp"
 
 
 using namespace std;
@@ -42,7 +43,19 @@ int main(int argc, char* argv[])
 	ClpbProblem problem;
 	problem.parseParams(argc, argv);
 
-	problem.solve();
+	if ("" != problem.m_socketPath) {
+		ClpbServer server(problem);
+		server.run(problem.m_socketPath);
+		return 0;
+	}
+
+	try {
+		problem.solve();
+	} catch (BackendError& ex) {
+		cerr << ex.what() << endl;
+		return 1;
+	}
+	problem.reportStats();
 
 	return 0;
 }
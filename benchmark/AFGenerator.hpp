@@ -0,0 +1,323 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// The generators of the synthetic argumentation frameworks
+//=======================================================================
+
+#ifndef ARGUMATRIX_AF_GENERATOR_HPP
+#define ARGUMATRIX_AF_GENERATOR_HPP
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <random>
+#include <math.h>
+#include <stdint.h>
+
+#include "config/config.hpp"
+
+
+namespace argumatrix{
+
+using namespace std;
+
+/**
+ * @brief A generated framework: the arguments 0, ..., m_argNum-1, labelled
+ * a0, a1, ..., and the attacks (i,j), i.e., i attacks j.
+ */
+struct GeneratedAF {
+	size_type m_argNum;
+	vector< pair<size_type, size_type> > m_attacks;
+
+	GeneratedAF(): m_argNum(0) {}
+
+	static string label(size_type i) { return "a" + std::to_string(i); }
+};
+
+/**
+ * @brief The random graphs used as benchmark frameworks, in the spirit of the
+ * datasets of ICCMA and of the experiments of argmat-clpb (see experiment.sh):
+ *   - kleinberg(): the small-world graphs of Kleinberg, a lattice whose
+ *     nodes are linked to the nodes within a lattice distance and to a few
+ *     far nodes, with a probability decreasing with the distance;
+ *   - barabasiAlbert(): the scale-free graphs grown by preferential
+ *     attachment;
+ *   - erdosRenyi(): each attack exists independently with a probability;
+ *   - grid(): each node is linked to its right and lower neighbours.
+ * The links of the undirected graphs are turned into attacks of a random
+ * direction, or into mutual attacks with the probability of setMutualRate().
+ * The same seed gives the same frameworks.
+ * ~~~~~{.cpp}
+ *   AFGenerator _gen(2016);
+ *   GeneratedAF _gaf;
+ *   _gen.erdosRenyi(100, 0.02, _gaf);
+ *   AFGenerator::writeAspartix(_gaf, "er_100.apx");
+ * ~~~~~
+ */
+class AFGenerator {
+public:
+	explicit AFGenerator(uint64_t seed = 0);
+
+	// The probability of a mutual attack for a link of an undirected graph
+	void setMutualRate(double rate) { m_mutual = rate; }
+
+	/**
+	 * @brief Kleinberg's small-world graph on a side*side lattice. Each node is
+	 * linked to the nodes within the lattice distance p, and to q other
+	 * nodes v chosen with the probability proportional to d(u,v)^(-r).
+	 */
+	void kleinberg(size_type side, size_type p, size_type q, double r, GeneratedAF& gaf);
+
+	/**
+	 * @brief Barabasi-Albert graph of n nodes: each new node is linked to m
+	 * distinct older nodes chosen with the probability proportional to their
+	 * degree. The first m+1 nodes form a clique.
+	 */
+	void barabasiAlbert(size_type n, size_type m, GeneratedAF& gaf);
+
+	/**
+	 * @brief Erdos-Renyi graph of n nodes: each ordered pair (i,j), i!=j, is an
+	 * attack with the probability prob. The attacks are drawn by geometric
+	 * skips over the pairs, in O(n+|R|) instead of O(n^2).
+	 */
+	void erdosRenyi(size_type n, double prob, GeneratedAF& gaf);
+
+	// The grid of rows*cols nodes
+	void grid(size_type rows, size_type cols, GeneratedAF& gaf);
+
+	// Write gaf in Aspartix format, arg(a0). ... att(a0,a1). ...
+	static bool writeAspartix(const GeneratedAF& gaf, const string& fileName);
+
+	// Write gaf in Trivial Graph Format
+	static bool writeTrivialGraph(const GeneratedAF& gaf, const string& fileName);
+
+private:
+	// Turn the link {u,v} into one or two attacks
+	void link(size_type u, size_type v, GeneratedAF& gaf);
+
+	double uniform() { return m_uniform(m_rng); }
+
+	std::mt19937_64 m_rng;
+	std::uniform_real_distribution<double> m_uniform;
+	double m_mutual;
+};
+
+
+AFGenerator::AFGenerator(uint64_t seed /*= 0*/):
+	m_rng(seed),
+	m_uniform(0.0, 1.0),
+	m_mutual(0.0)
+{
+
+}
+
+__inline
+void AFGenerator::link(size_type u, size_type v, GeneratedAF& gaf)
+{
+	if (uniform() < m_mutual) {
+		gaf.m_attacks.push_back(make_pair(u, v));
+		gaf.m_attacks.push_back(make_pair(v, u));
+	} else
+	if (uniform() < 0.5) {
+		gaf.m_attacks.push_back(make_pair(u, v));
+	} else {
+		gaf.m_attacks.push_back(make_pair(v, u));
+	}
+}
+
+void AFGenerator::kleinberg(size_type side, size_type p, size_type q, double r,
+	GeneratedAF& gaf)
+{
+	const size_type n = side * side;
+	gaf.m_argNum = n;
+	gaf.m_attacks.clear();
+
+	if (n < 2)
+		return;
+	const long _side = (long)side, _p = (long)p;
+
+	// The local links {u,v}, u<v, within the lattice distance p, i.e., the
+	// offsets (di,dj) of the lattice neighbourhood after u in the row-major
+	// order
+	for (long ui = 0; ui < _side; ++ui) {
+		for (long uj = 0; uj < _side; ++uj) {
+			const size_type u = (size_type)(ui * _side + uj);
+			for (long di = 0; di <= _p && ui + di < _side; ++di) {
+				const long _w = _p - di;
+				for (long dj = (di == 0 ? 1 : -_w); dj <= _w; ++dj) {
+					if (uj + dj >= 0 && uj + dj < _side)
+						link(u, (size_type)((ui + di) * _side + uj + dj), gaf);
+				}
+			}
+		}
+	}
+
+	// The long-range links. There are 4d offsets at the distance d on the
+	// unbounded lattice, so that the distance of an offset drawn with the
+	// weight d^(-r) is drawn from the cumulative weights 4d*d^(-r), computed
+	// once, and the offset is uniform among the 4d ones. The offsets out of
+	// the lattice are drawn again, which leaves the probabilities of the
+	// nodes v proportional to d(u,v)^(-r), in O(1) expected draws per link.
+	const long _maxd = 2 * (_side - 1);
+	vector<double> _cumul(_maxd);
+	double _sum = 0;
+	for (long d = 1; d <= _maxd; ++d) {
+		_sum += 4.0 * d * pow((double)d, -r);
+		_cumul[d - 1] = _sum;
+	}
+
+	for (long ui = 0; ui < _side; ++ui) {
+		for (long uj = 0; uj < _side; ++uj) {
+			const size_type u = (size_type)(ui * _side + uj);
+			for (size_type k = 0; k < q; ++k) {
+				long vi, vj;
+				for (;;) {
+					long d = (long)(std::lower_bound(_cumul.begin(), _cumul.end(),
+						uniform() * _sum) - _cumul.begin()) + 1;
+					if (d > _maxd)
+						d = _maxd;
+
+					// The offset t of the 4d ones, i.e., (s,d-s) turned by
+					// the quarter t/d, s = t%d
+					long t = (long)(uniform() * 4 * d);
+					if (t >= 4 * d)
+						t = 4 * d - 1;
+					const long s = t % d;
+					long di, dj;
+					switch (t / d) {
+					case 0:  di = s;      dj = d - s;  break;
+					case 1:  di = d - s;  dj = -s;     break;
+					case 2:  di = -s;     dj = s - d;  break;
+					default: di = s - d;  dj = s;      break;
+					}
+					vi = ui + di;
+					vj = uj + dj;
+					if (vi >= 0 && vi < _side && vj >= 0 && vj < _side)
+						break;
+				}
+				link(u, (size_type)(vi * _side + vj), gaf);
+			}
+		}
+	}
+}
+
+void AFGenerator::barabasiAlbert(size_type n, size_type m, GeneratedAF& gaf)
+{
+	gaf.m_argNum = n;
+	gaf.m_attacks.clear();
+	if (m < 1)
+		m = 1;
+
+	// Each node occurs in _ends once per link, so that a uniform element of
+	// _ends is a node drawn by its degree
+	vector<size_type> _ends;
+	const size_type _clique = std::min(n, m + 1);
+	for (size_type u = 0; u < _clique; ++u) {
+		for (size_type v = u + 1; v < _clique; ++v) {
+			link(u, v, gaf);
+			_ends.push_back(u);
+			_ends.push_back(v);
+		}
+	}
+
+	vector<size_type> _targets;
+	for (size_type u = _clique; u < n; ++u) {
+		_targets.clear();
+		while (_targets.size() < m) {
+			size_type v = _ends[(size_type)(uniform() * _ends.size()) % _ends.size()];
+			if (std::find(_targets.begin(), _targets.end(), v) == _targets.end())
+				_targets.push_back(v);
+		}
+		for (size_type k = 0; k < _targets.size(); ++k) {
+			link(u, _targets[k], gaf);
+			_ends.push_back(u);
+			_ends.push_back(_targets[k]);
+		}
+	}
+}
+
+void AFGenerator::erdosRenyi(size_type n, double prob, GeneratedAF& gaf)
+{
+	gaf.m_argNum = n;
+	gaf.m_attacks.clear();
+	if (n < 2 || prob <= 0)
+		return;
+
+	// The pair k is (k/(n-1), the (k%(n-1))-th other argument)
+	const uint64_t _pairs = (uint64_t)n * (n - 1);
+	if (prob >= 1) {
+		for (uint64_t k = 0; k < _pairs; ++k) {
+			size_type i = (size_type)(k / (n - 1)), j = (size_type)(k % (n - 1));
+			gaf.m_attacks.push_back(make_pair(i, j < i ? j : j + 1));
+		}
+		return;
+	}
+
+	const double _logq = log(1.0 - prob);
+	uint64_t k = 0;
+	for (;;) {
+		// The number of the pairs skipped before the next attack
+		double _skip = floor(log(1.0 - uniform()) / _logq);
+		if (_skip >= (double)(_pairs - k))
+			break;
+		k += (uint64_t)_skip;
+		size_type i = (size_type)(k / (n - 1)), j = (size_type)(k % (n - 1));
+		gaf.m_attacks.push_back(make_pair(i, j < i ? j : j + 1));
+		if (++k >= _pairs)
+			break;
+	}
+}
+
+void AFGenerator::grid(size_type rows, size_type cols, GeneratedAF& gaf)
+{
+	gaf.m_argNum = rows * cols;
+	gaf.m_attacks.clear();
+	for (size_type i = 0; i < rows; ++i) {
+		for (size_type j = 0; j < cols; ++j) {
+			size_type u = i * cols + j;
+			if (j + 1 < cols)
+				link(u, u + 1, gaf);
+			if (i + 1 < rows)
+				link(u, u + cols, gaf);
+		}
+	}
+}
+
+bool AFGenerator::writeAspartix(const GeneratedAF& gaf, const string& fileName)
+{
+	ofstream ofs(fileName.c_str());
+	if (!ofs)
+		return false;
+
+	for (size_type i = 0; i < gaf.m_argNum; ++i)
+		ofs << "arg(" << GeneratedAF::label(i) << ").\n";
+	for (size_type k = 0; k < gaf.m_attacks.size(); ++k) {
+		ofs << "att(" << GeneratedAF::label(gaf.m_attacks[k].first) << ","
+			<< GeneratedAF::label(gaf.m_attacks[k].second) << ").\n";
+	}
+	return (bool)ofs;
+}
+
+bool AFGenerator::writeTrivialGraph(const GeneratedAF& gaf, const string& fileName)
+{
+	ofstream ofs(fileName.c_str());
+	if (!ofs)
+		return false;
+
+	for (size_type i = 0; i < gaf.m_argNum; ++i)
+		ofs << GeneratedAF::label(i) << "\n";
+	ofs << "#\n";
+	for (size_type k = 0; k < gaf.m_attacks.size(); ++k) {
+		ofs << GeneratedAF::label(gaf.m_attacks[k].first) << " "
+			<< GeneratedAF::label(gaf.m_attacks[k].second) << "\n";
+	}
+	return (bool)ofs;
+}
+
+} // namespace argumatrix
+
+#endif  // ARGUMATRIX_AF_GENERATOR_HPP
@@ -0,0 +1,767 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// The benchmarks of the matrix operations and of the argmat-clpb problems
+//=======================================================================
+
+#ifndef ARGUMATRIX_BENCHMARK_HPP
+#define ARGUMATRIX_BENCHMARK_HPP
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <stdint.h>
+#include <string.h>
+
+#include "config/config.hpp"
+#include "config/cptimer.hpp"
+#include "dung_theory/ExtensionWriter.hpp"
+#include "argmat-clpb/ClpbProblem.hpp"
+#include "AFGenerator.hpp"
+
+
+namespace argumatrix{
+
+using namespace std;
+
+/**
+ * @brief Print the usage of the benchmark
+ */
+void printBenchmarkHelp();
+
+/**
+ * @brief The minimum, median and mean of the samples of a measurement, in
+ * nanoseconds per operation.
+ */
+struct TimeStats {
+	uint64_t m_min;
+	uint64_t m_median;
+	uint64_t m_mean;
+	size_type m_samples;
+	size_type m_iters;  /**< The operations timed together by a sample */
+
+	TimeStats(): m_min(0), m_median(0), m_mean(0), m_samples(0), m_iters(1) {}
+
+	// The statistics of the samples _ns, each of _iters operations
+	static TimeStats of(vector<uint64_t> _ns, size_type _iters = 1);
+};
+
+/**
+ * @brief Write a JSON document to a stream, e.g.,
+ * ~~~~~{.cpp}
+ *   JsonWriter _json(cout);
+ *   _json.beginObject();
+ *   _json.value("seed", 2016);
+ *   _json.beginArray("frameworks");
+ *   ...
+ *   _json.endArray();
+ *   _json.endObject();
+ * ~~~~~
+ * The keys are ignored in the arrays.
+ */
+class JsonWriter {
+public:
+	explicit JsonWriter(ostream& os): m_os(os) {}
+
+	void beginObject(const string& key = "");
+	void endObject();
+	void beginArray(const string& key = "");
+	void endArray();
+
+	void value(const string& key, const string& v);
+	void value(const string& key, const char* v) { value(key, string(v)); }
+	void value(const string& key, uint64_t v);
+	void value(const string& key, double v);
+
+	// The object of the statistics _ts under the key
+	void value(const string& key, const TimeStats& _ts);
+
+private:
+	// The separator, the indent and the key of the next member
+	void member(const string& key);
+
+	static string escape(const string& s);
+
+	ostream& m_os;
+	vector<bool> m_first;  /**< Whether the open containers are still empty */
+	vector<bool> m_isArray;
+};
+
+/**
+ * @brief The benchmark suite of argumatrix. The frameworks are generated by
+ * AFGenerator and written to files of the chosen format, then
+ *   - the micro benchmarks time the parsing, the construction of the attack
+ *     matrices, the products and the transposes of bitmatrix and
+ *     sparsematrix, and the construction of the Prolog matrix terms, each
+ *     repeated until a sample lasts long enough to be timed;
+ *   - the macro benchmarks solve each problem, e.g., EE-CO, from the file,
+ *     and time its phases:
+ *       parse  -- the file is read into a DungAF;
+ *       matrix -- the reasoner is constructed, i.e., its attack matrices;
+ *       term   -- the Prolog term of the attack matrix, which the reasoner
+ *                 then takes from the PlMatrixTermCache (0 for the native
+ *                 reasoners and the BDD backend);
+ *       solve  -- the extensions of EE and SE are enumerated into memory,
+ *                 and the other tasks are answered into a memory buffer;
+ *       output -- the answer is written to the sink (see -sink).
+ * The results are written as a JSON document.
+ */
+class Benchmark {
+public:
+	Benchmark();
+
+	void parseParams(int argc, char* argv[]);
+
+	void run();
+
+	vector<string> m_generators;  // kleinberg, ba, er or grid, set by -g
+	vector<size_type> m_sizes;    // The numbers of arguments, set by -n
+	double m_degree;              // The average number of attacks per argument of ba and er, set by -d
+	string m_fileFmt;             // apx or tgf, set by -fo
+	string m_dir;                 // Where to write the frameworks, set by -dir
+	uint64_t m_seed;              // The seed of the generators, set by -seed
+	size_type m_repeat;           // The samples of a measurement, set by -r
+	vector<string> m_problems;    // The problems of the macro benchmarks, set by -p
+	string m_queryArg;            // The argument of EC, SC, DE, DC and DS, set by -a
+	size_type m_limit;            // The extensions enumerated at most, set by -limit
+	BackendType m_backend;        // Set by -b
+	bool m_micro;                 // Run the micro benchmarks, set by -m
+	bool m_macro;                 // Run the macro benchmarks, set by -m
+	bool m_genOnly;               // Only write the frameworks, set by -go
+	string m_outputFile;          // Where to write the results, set by -o
+	string m_sinkFile;            // Where to write the answers, set by -sink
+
+private:
+	// Generate the framework n of the generator _gen, and write it to a file
+	string generate(const string& _gen, size_type n, GeneratedAF& gaf);
+
+	bool parseFile(const string& _file, DungAF& daf);
+
+	void runMicro(const string& _file, JsonWriter& json);
+	void runMacro(const string& _file, const string& problem, JsonWriter& json);
+
+	/**
+	 * @brief Time the operation op, which returns a number folded into
+	 * m_sink so that it is not optimized away. The number of the operations
+	 * of a sample is doubled until the sample lasts 1ms.
+	 */
+	template<typename Operation>
+	TimeStats measure(Operation op);
+
+	// Split "a,b,c" into its items
+	static vector<string> splitList(const string& s);
+
+	static const uint64_t MIN_SAMPLE_NS = 1000000;
+
+	volatile uint64_t m_sink;
+};
+
+
+TimeStats TimeStats::of(vector<uint64_t> _ns, size_type _iters /*= 1*/)
+{
+	TimeStats _ts;
+	_ts.m_iters = _iters;
+	_ts.m_samples = _ns.size();
+	if (_ns.empty())
+		return _ts;
+
+	std::sort(_ns.begin(), _ns.end());
+	uint64_t _sum = 0;
+	for (size_type k = 0; k < _ns.size(); ++k)
+		_sum += _ns[k];
+	_ts.m_min = _ns.front();
+	_ts.m_median = _ns[_ns.size() / 2];
+	_ts.m_mean = _sum / _ns.size();
+	return _ts;
+}
+
+void JsonWriter::member(const string& key)
+{
+	if (!m_first.empty()) {
+		if (!m_first.back())
+			m_os << ",";
+		m_first.back() = false;
+		m_os << "\n" << string(2 * m_first.size(), ' ');
+		if (!m_isArray.back())
+			m_os << "\"" << escape(key) << "\": ";
+	}
+}
+
+void JsonWriter::beginObject(const string& key /*= ""*/)
+{
+	member(key);
+	m_os << "{";
+	m_first.push_back(true);
+	m_isArray.push_back(false);
+}
+
+void JsonWriter::endObject()
+{
+	bool _empty = m_first.back();
+	m_first.pop_back();
+	m_isArray.pop_back();
+	if (!_empty)
+		m_os << "\n" << string(2 * m_first.size(), ' ');
+	m_os << "}";
+	if (m_first.empty())
+		m_os << endl;
+}
+
+void JsonWriter::beginArray(const string& key /*= ""*/)
+{
+	member(key);
+	m_os << "[";
+	m_first.push_back(true);
+	m_isArray.push_back(true);
+}
+
+void JsonWriter::endArray()
+{
+	bool _empty = m_first.back();
+	m_first.pop_back();
+	m_isArray.pop_back();
+	if (!_empty)
+		m_os << "\n" << string(2 * m_first.size(), ' ');
+	m_os << "]";
+}
+
+void JsonWriter::value(const string& key, const string& v)
+{
+	member(key);
+	m_os << "\"" << escape(v) << "\"";
+}
+
+void JsonWriter::value(const string& key, uint64_t v)
+{
+	member(key);
+	m_os << v;
+}
+
+void JsonWriter::value(const string& key, double v)
+{
+	member(key);
+	m_os << v;
+}
+
+void JsonWriter::value(const string& key, const TimeStats& _ts)
+{
+	beginObject(key);
+	value("min_ns", _ts.m_min);
+	value("median_ns", _ts.m_median);
+	value("mean_ns", _ts.m_mean);
+	value("samples", (uint64_t)_ts.m_samples);
+	value("iterations", (uint64_t)_ts.m_iters);
+	endObject();
+}
+
+string JsonWriter::escape(const string& s)
+{
+	string _esc;
+	for (size_type k = 0; k < s.size(); ++k) {
+		char c = s[k];
+		if (c == '"' || c == '\\') {
+			_esc += '\\';
+			_esc += c;
+		} else
+		if ((unsigned char)c < 0x20) {
+			char _hex[8];
+			sprintf(_hex, "\\u%04x", (unsigned int)(unsigned char)c);
+			_esc += _hex;
+		} else {
+			_esc += c;
+		}
+	}
+	return _esc;
+}
+
+
+Benchmark::Benchmark():
+	m_degree(2.0),
+	m_fileFmt("apx"),
+	m_dir("."),
+	m_seed(2016),
+	m_repeat(5),
+	m_queryArg(""),
+	m_limit(1000),
+	m_backend(CLPB_BACKEND),
+	m_micro(true),
+	m_macro(true),
+	m_genOnly(false),
+	m_outputFile(""),
+#ifdef _WIN32
+	m_sinkFile("NUL"),
+#else
+	m_sinkFile("/dev/null"),
+#endif
+	m_sink(0)
+{
+	m_generators = splitList("kleinberg,ba,er,grid");
+	m_sizes.push_back(36);
+
+	// All the tasks of the semantics
+	static const char* _tasks[] = { "EE", "EX", "EC", "SC", "SE", "DE", "DN", "DC", "DS" };
+	static const char* _sems[] = { "CF", "ST", "AD", "CO", "GR", "PR" };
+	for (size_type s = 0; s < sizeof(_sems)/sizeof(_sems[0]); ++s) {
+		for (size_type t = 0; t < sizeof(_tasks)/sizeof(_tasks[0]); ++t)
+			m_problems.push_back(string(_tasks[t]) + "-" + _sems[s]);
+	}
+
+	// The tasks of the native semi-stable and stage reasoners
+	static const char* _rangeTasks[] = { "EE", "SE", "DC", "DS" };
+	static const char* _rangeSems[] = { "SST", "STG" };
+	for (size_type s = 0; s < sizeof(_rangeSems)/sizeof(_rangeSems[0]); ++s) {
+		for (size_type t = 0; t < sizeof(_rangeTasks)/sizeof(_rangeTasks[0]); ++t)
+			m_problems.push_back(string(_rangeTasks[t]) + "-" + _rangeSems[s]);
+	}
+}
+
+void Benchmark::parseParams(int argc, char* argv[])
+{
+	for(int i=1; i<argc; i++){
+		if(strcmp(argv[i],"-go")==0){
+			m_genOnly = true;
+			continue;
+		}
+		if((i+1)>=argc){
+			cerr << "The option " << argv[i] << " is unknown or has no value!" << endl;
+			printBenchmarkHelp();
+			exit(1);
+		}
+
+		const char* _opt = argv[i];
+		const char* _val = argv[++i];
+		if(strcmp(_opt,"-g")==0){
+			m_generators = splitList(_val);
+		} else
+		if(strcmp(_opt,"-n")==0){
+			m_sizes.clear();
+			vector<string> _sizes = splitList(_val);
+			for (size_type k = 0; k < _sizes.size(); ++k) {
+				int _num = atoi(_sizes[k].c_str());
+				if (_num < 1) {
+					cerr << "The number of arguments must be a positive integer!" << endl;
+					exit(1);
+				}
+				m_sizes.push_back(_num);
+			}
+		} else
+		if(strcmp(_opt,"-d")==0){
+			m_degree = atof(_val);
+		} else
+		if(strcmp(_opt,"-fo")==0){
+			m_fileFmt = _val;
+			if (m_fileFmt != "apx" && m_fileFmt != "tgf") {
+				cerr << "The file format [" << m_fileFmt << "] is not supported!" << endl;
+				exit(1);
+			}
+		} else
+		if(strcmp(_opt,"-dir")==0){
+			m_dir = _val;
+		} else
+		if(strcmp(_opt,"-seed")==0){
+			m_seed = strtoull(_val, NULL, 10);
+		} else
+		if(strcmp(_opt,"-r")==0 || strcmp(_opt,"-limit")==0){
+			int _num = atoi(_val);
+			if (_num < 1) {
+				cerr << "The option " << _opt << " must be a positive integer!" << endl;
+				exit(1);
+			}
+			if (strcmp(_opt,"-r")==0)
+				m_repeat = _num;
+			else
+				m_limit = _num;
+		} else
+		if(strcmp(_opt,"-p")==0){
+			m_problems = splitList(_val);
+		} else
+		if(strcmp(_opt,"-a")==0){
+			m_queryArg = _val;
+		} else
+		if(strcmp(_opt,"-b")==0){
+			if (strcmp(_val,"clpb")==0) {
+				m_backend = CLPB_BACKEND;
+			} else
+			if (strcmp(_val,"bdd")==0) {
+				m_backend = BDD_BACKEND;
+			} else {
+				cerr << "The backend [" << _val << "] is not supported!" << endl;
+				exit(1);
+			}
+		} else
+		if(strcmp(_opt,"-m")==0){
+			m_micro = strcmp(_val,"micro")==0 || strcmp(_val,"all")==0;
+			m_macro = strcmp(_val,"macro")==0 || strcmp(_val,"all")==0;
+			if (!m_micro && !m_macro) {
+				cerr << "The benchmarks [" << _val << "] are unknown!" << endl;
+				exit(1);
+			}
+		} else
+		if(strcmp(_opt,"-o")==0){
+			m_outputFile = _val;
+		} else
+		if(strcmp(_opt,"-sink")==0){
+			m_sinkFile = _val;
+		} else {
+			cerr << "The option " << _opt << " is unknown!" << endl;
+			printBenchmarkHelp();
+			exit(1);
+		}
+	}
+}
+
+void Benchmark::run()
+{
+	ofstream ofs;
+	if (m_outputFile != "") {
+		ofs.open(m_outputFile.c_str());
+		if (!ofs) {
+			cerr << "Can not open the output file: " << m_outputFile << endl;
+			exit(1);
+		}
+	}
+	ostream& _os = (m_outputFile != "") ? ofs : std::cout;
+
+	JsonWriter json(_os);
+	json.beginObject();
+	json.value("seed", m_seed);
+	json.value("repeat", (uint64_t)m_repeat);
+	json.value("format", m_fileFmt);
+	json.value("limit", (uint64_t)m_limit);
+	json.value("backend", m_backend == BDD_BACKEND ? "bdd" : "clpb");
+	json.beginArray("frameworks");
+
+	for (size_type g = 0; g < m_generators.size(); ++g) {
+		for (size_type k = 0; k < m_sizes.size(); ++k) {
+			GeneratedAF _gaf;
+			string _file = generate(m_generators[g], m_sizes[k], _gaf);
+
+			json.beginObject();
+			json.value("generator", m_generators[g]);
+			json.value("file", _file);
+			json.value("arguments", (uint64_t)_gaf.m_argNum);
+			json.value("attacks", (uint64_t)_gaf.m_attacks.size());
+
+			if (!m_genOnly && m_micro)
+				runMicro(_file, json);
+
+			if (!m_genOnly && m_macro) {
+				json.beginArray("problems");
+				for (size_type p = 0; p < m_problems.size(); ++p)
+					runMacro(_file, m_problems[p], json);
+				json.endArray();
+			}
+			json.endObject();
+		}
+	}
+
+	json.endArray();
+	json.endObject();
+}
+
+string Benchmark::generate(const string& _gen, size_type n, GeneratedAF& gaf)
+{
+	// The same framework for the same generator, size and seed
+	AFGenerator _generator(m_seed + n);
+	size_type _side = 1;
+	while (_side * _side < n)
+		++_side;
+
+	if (_gen == "kleinberg") {
+		_generator.kleinberg(_side, 1, 1, 2.0, gaf);
+	} else
+	if (_gen == "ba") {
+		size_type _m = (size_type)(m_degree + 0.5);
+		_generator.barabasiAlbert(n, _m < 1 ? 1 : _m, gaf);
+	} else
+	if (_gen == "er") {
+		_generator.erdosRenyi(n, n > 1 ? m_degree / (n - 1) : 0, gaf);
+	} else
+	if (_gen == "grid") {
+		_generator.grid(_side, (n + _side - 1) / _side, gaf);
+	} else {
+		cerr << "The generator [" << _gen << "] is unknown!" << endl;
+		printBenchmarkHelp();
+		exit(1);
+	}
+
+	string _file = m_dir + "/" + _gen + "_n" + std::to_string(n) + "_s"
+		+ std::to_string(m_seed) + "." + m_fileFmt;
+	bool _written = (m_fileFmt == "tgf") ? AFGenerator::writeTrivialGraph(gaf, _file)
+		: AFGenerator::writeAspartix(gaf, _file);
+	if (!_written) {
+		cerr << "Can not write the framework: " << _file << endl;
+		exit(1);
+	}
+	return _file;
+}
+
+bool Benchmark::parseFile(const string& _file, DungAF& daf)
+{
+	if (m_fileFmt == "tgf")
+		return parser::TrivialGraph2DungAF(_file, daf);
+	return parser::Aspartix2DungAF(_file, daf);
+}
+
+template<typename Operation>
+TimeStats Benchmark::measure(Operation op)
+{
+	size_type _iters = 1;
+	for (;;) {
+		uint64_t _bgn = clock_ns();
+		for (size_type k = 0; k < _iters; ++k)
+			m_sink += op();
+		if (clock_ns() - _bgn >= MIN_SAMPLE_NS || _iters >= (1u << 20))
+			break;
+		_iters *= 2;
+	}
+
+	vector<uint64_t> _ns;
+	for (size_type r = 0; r < m_repeat; ++r) {
+		uint64_t _bgn = clock_ns();
+		for (size_type k = 0; k < _iters; ++k)
+			m_sink += op();
+		_ns.push_back((clock_ns() - _bgn) / _iters);
+	}
+	return TimeStats::of(_ns, _iters);
+}
+
+void Benchmark::runMicro(const string& _file, JsonWriter& json)
+{
+	DungAF daf;
+	if (!parseFile(_file, daf)) {
+		cerr << m_fileFmt << " file loading failed: " << _file << endl;
+		exit(1);
+	}
+	const bitmatrix _atk = daf.getAttackMatrix();
+	const sparsematrix _spAtk = daf.getSparseAttackMatrix();
+	const size_type n = daf.getNumberOfArguments();
+
+	// Every other argument
+	bitvector _bv(n);
+	for (size_type i = 0; i < n; i += 2)
+		_bv.set(i);
+
+	json.beginObject("micro");
+	json.value("parse", measure([&]() -> uint64_t {
+		DungAF _daf;
+		parseFile(_file, _daf);
+		return _daf.getNumberOfArguments();
+	}));
+	json.value("bitmatrix_build", measure([&]() -> uint64_t {
+		return daf.getAttackMatrix().sizeR();
+	}));
+	json.value("sparsematrix_build", measure([&]() -> uint64_t {
+		return daf.getSparseAttackMatrix().nnz();
+	}));
+	json.value("bitmatrix_bitvector_product", measure([&]() -> uint64_t {
+		return (_atk * _bv).count();
+	}));
+	json.value("sparsematrix_bitvector_product", measure([&]() -> uint64_t {
+		return (_spAtk * _bv).count();
+	}));
+	json.value("bitmatrix_product", measure([&]() -> uint64_t {
+		return (_atk * _atk).sizeR();
+	}));
+	json.value("bitmatrix_transpose", measure([&]() -> uint64_t {
+		return _atk.transpose().sizeR();
+	}));
+	json.value("sparsematrix_transpose", measure([&]() -> uint64_t {
+		return _spAtk.transpose().nnz();
+	}));
+
+	// The terms are discarded with their frame
+	json.value("prolog_matrix_term", measure([&]() -> uint64_t {
+		fid_t _fid = PL_open_foreign_frame();
+		term_t _mtx = PL_new_term_ref();
+		bitmatrix2plmatrixTerm(_atk, _mtx);
+		PL_discard_foreign_frame(_fid);
+		return _mtx;
+	}));
+	json.value("prolog_attacker_list_term", measure([&]() -> uint64_t {
+		fid_t _fid = PL_open_foreign_frame();
+		term_t _adj = PL_new_term_ref();
+		sparsematrix2attackerListTerm(_spAtk, _adj);
+		PL_discard_foreign_frame(_fid);
+		return _adj;
+	}));
+	json.endObject();
+}
+
+void Benchmark::runMacro(const string& _file, const string& problem, JsonWriter& json)
+{
+	json.beginObject();
+	json.value("problem", problem);
+
+	if (problem.size() < 5 || problem[2] != '-') {
+		json.value("error", "The problem is invalid");
+		json.endObject();
+		return;
+	}
+	string task = problem.substr(0,2);
+	string sm_type = problem.substr(3,2);
+	string sm_full = problem.substr(3);
+
+	// The options of the reasoners
+	ClpbProblem _cfg;
+	_cfg.m_backend = m_backend;
+	_cfg.m_limit = m_limit;
+
+	ofstream _sink(m_sinkFile.c_str(), ios::binary);
+	if (!_sink) {
+		cerr << "Can not open the sink: " << m_sinkFile << endl;
+		exit(1);
+	}
+
+	vector<uint64_t> _parse, _matrix, _term, _solve, _output;
+	uint64_t _answer = 0;
+	for (size_type r = 0; r < m_repeat; ++r) {
+		uint64_t _t0 = clock_ns();
+		std::unique_ptr<DungAF> daf(new DungAF());
+		if (!parseFile(_file, *daf)) {
+			cerr << m_fileFmt << " file loading failed: " << _file << endl;
+			exit(1);
+		}
+		uint64_t _t1 = clock_ns();
+
+		set<string> _argset;
+		if (task == "EC" || task == "SC" || task == "DE" || task == "DC" || task == "DS") {
+			_argset.insert(m_queryArg != "" ? m_queryArg
+				: GeneratedAF::label(daf->getNumberOfArguments() / 2));
+		}
+
+		ostringstream _buffer;
+		uint64_t _t2 = clock_ns();
+		std::unique_ptr<Reasoner> rsner(_cfg.createReasoner(*daf, problem, _buffer.rdbuf()));
+		uint64_t _t3 = clock_ns();
+		if (!rsner) {
+			json.value("error", "The problem has no reasoner");
+			json.endObject();
+			return;
+		}
+
+		// The term of the constraint models, taken by the first query from
+		// the cache
+		uint64_t _tt = 0;
+		if (m_backend == CLPB_BACKEND && (sm_type == "CF" || sm_type == "ST" ||
+			sm_type == "AD" || sm_type == "CO")) {
+			// The 0/1 matrix of the dense models is built from the sparse
+			// matrix, as ClpbBackend does without the bitmatrix
+			const sparsematrix _spAtk = daf->getSparseAttackMatrix();
+			uint64_t _tb = clock_ns();
+			if (PlReasoner::isSparseTask(sm_full))
+				PlMatrixTermCache::instance().get(daf->getRevision(), _spAtk);
+			else
+				PlMatrixTermCache::instance().getMatrix(daf->getRevision(), _spAtk);
+			_tt = clock_ns() - _tb;
+		}
+
+		vector<bitvector> _exts;
+		uint64_t _t4 = clock_ns();
+		if (task == "EE" || task == "SE") {
+			const size_type _max = (task == "SE") ? 1 : m_limit;
+			rsner->enumerateExtensions([&](const bitvector& _bv) -> bool {
+				_exts.push_back(_bv);
+				return _exts.size() < _max;
+			});
+		} else {
+			_cfg.reasoning(rsner.get(), task, _argset);
+		}
+		uint64_t _t5 = clock_ns();
+
+		if (task == "EE" || task == "SE") {
+			ExtensionWriter _writer(daf->getArgumentLabels(), _sink);
+			if (task == "EE")
+				_writer.put(LEFT_LIMITER);
+			for (size_type k = 0; k < _exts.size(); ++k) {
+				if (k > 0)
+					_writer.put(DELIMITER);
+				_writer.putExtension(_exts[k]);
+			}
+			if (task == "EE")
+				_writer.put(RIGHT_LIMITER);
+			else if (_exts.empty())
+				_writer.put(STR_NO);
+			_writer.put('\n');
+			_answer = _exts.size();
+		} else {
+			const string _str = _buffer.str();
+			_sink.rdbuf()->sputn(_str.data(), _str.size());
+			_sink.rdbuf()->pubsync();
+			_answer = _str.size();
+		}
+		uint64_t _t6 = clock_ns();
+
+		_parse.push_back(_t1 - _t0);
+		_matrix.push_back(_t3 - _t2);
+		_term.push_back(_tt);
+		_solve.push_back(_t5 - _t4);
+		_output.push_back(_t6 - _t5);
+
+		// Each repeat parses a new framework, i.e., a new revision, whose
+		// terms must not stay on the engine for the next repeats
+		rsner.reset();
+		PlMatrixTermCache::instance().evict(daf->getRevision());
+	}
+
+	if (task == "EE" || task == "SE")
+		json.value("extensions", _answer);
+	else
+		json.value("answer_bytes", _answer);
+	json.beginObject("phases");
+	json.value("parse", TimeStats::of(_parse));
+	json.value("matrix", TimeStats::of(_matrix));
+	json.value("term", TimeStats::of(_term));
+	json.value("solve", TimeStats::of(_solve));
+	json.value("output", TimeStats::of(_output));
+	json.endObject();
+	json.endObject();
+}
+
+vector<string> Benchmark::splitList(const string& s)
+{
+	vector<string> _items;
+	size_type _bgn = 0;
+	while (_bgn <= s.size()) {
+		size_type _end = s.find(',', _bgn);
+		if (_end == string::npos)
+			_end = s.size();
+		if (_end > _bgn)
+			_items.push_back(s.substr(_bgn, _end - _bgn));
+		_bgn = _end + 1;
+	}
+	return _items;
+}
+
+void printBenchmarkHelp()
+{
+	cout << "Usage: benchmark [options]" << endl << endl;
+	cout << "Options:" << endl;
+	cout << "  -g <gens>      The generators, kleinberg,ba,er,grid (the default)" << endl;
+	cout << "  -n <sizes>     The numbers of arguments, e.g., 16,64 (default 36), rounded up" << endl
+		 << "                 to a square by kleinberg" << endl;
+	cout << "  -d <degree>    The average number of attacks per argument of ba and er (default 2)" << endl;
+	cout << "  -fo <fmt>      The format of the generated files, apx (the default) or tgf" << endl;
+	cout << "  -dir <dir>     Where to write the generated files (default .)" << endl;
+	cout << "  -seed <num>    The seed of the generators (default 2016)" << endl;
+	cout << "  -go            Only generate the files" << endl;
+	cout << "  -m <which>     micro, macro or all (the default)" << endl;
+	cout << "  -r <num>       The samples of each measurement (default 5)" << endl;
+	cout << "  -p <problems>  The problems of the macro benchmarks, e.g., EE-CO,DC-GR" << endl
+		 << "                 (default all the tasks of CF, ST, AD, CO, GR and PR," << endl
+		 << "                 and EE, SE, DC and DS of SST and STG)" << endl;
+	cout << "  -a <arg>       The argument of EC, SC, DE, DC and DS (default the middle one)" << endl;
+	cout << "  -limit <num>   The extensions of EE enumerated at most (default 1000)" << endl;
+	cout << "  -b <backend>   The solver of the constraint models, clpb (the default) or bdd" << endl;
+	cout << "  -o <file>      Where to write the JSON results (default the standard output)" << endl;
+	cout << "  -sink <file>   Where to write the answers (default the null device)" << endl;
+}
+
+} // namespace argumatrix
+
+#endif  // ARGUMATRIX_BENCHMARK_HPP
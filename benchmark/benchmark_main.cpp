@@ -0,0 +1,27 @@
+#include <iostream>
+#include <string.h>
+
+#include "Benchmark.hpp"
+
+using namespace std;
+using namespace argumatrix;
+
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && strcmp(argv[1],"--help")==0) {
+		printBenchmarkHelp();
+		return 0;
+	}
+
+	Benchmark benchmark;
+	benchmark.parseParams(argc, argv);
+	try {
+		benchmark.run();
+	} catch (BackendError& ex) {
+		cerr << ex.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
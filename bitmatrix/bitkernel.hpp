@@ -0,0 +1,243 @@
+#ifndef BIT_KERNEL_HPP
+#define BIT_KERNEL_HPP
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config/config.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#  define ARGUMATRIX_X86_KERNELS
+#  include <immintrin.h>
+#endif
+
+
+namespace argumatrix {  // argumatrix
+
+/**
+ * @brief Low-level kernels working on the raw blocks of bitvectors. They are
+ * the inner loops of the bitmatrix operations, and each of them is provided
+ * with a scalar version and, on x86 machines, with AVX2 and AVX-512 versions.
+ * The fastest version supported by the running CPU is selected at runtime.
+ * The selection can be overridden by the environment variable
+ * ARGUMATRIX_SIMD=[scalar|avx2|avx512], which is useful for benchmarking.
+ */
+namespace bitkernel {
+
+/**
+ * @brief The number of 1's in a block.
+ */
+inline
+size_type popcount(block_type _b)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll(_b);
+#else
+	size_type _n = 0;
+	for ( ; _b; _b &= _b - 1) ++_n;
+	return _n;
+#endif
+}
+
+/**
+ * @brief The position of the lowest 1 of a non-zero block.
+ */
+inline
+size_type lowest_bit(block_type _b)
+{
+	assert(_b != 0);
+#if defined(__GNUC__)
+	return __builtin_ctzll(_b);
+#else
+	size_type _pos = 0;
+	for ( ; !(_b & 1); _b >>= 1) ++_pos;
+	return _pos;
+#endif
+}
+
+/**
+ * @brief Transpose a 64x64 bit block in place. The block is given by 64 words,
+ * the bit j of the word i being the entry (i,j). The block is transposed by
+ * swapping its off-diagonal sub-blocks of size 32, then 16, ..., then 1, and
+ * each step works on whole words (see Hacker's Delight, Section 7-3).
+ * @param a the 64 words of the block.
+ */
+inline
+void transpose64(block_type* a)
+{
+	block_type m = 0x00000000FFFFFFFFULL;
+	for (size_type j = 32; j != 0; j >>= 1, m ^= (m << j)) {
+		for (size_type k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+			block_type t = ((a[k] >> j) ^ a[k | j]) & m;
+			a[k] ^= t << j;
+			a[k | j] ^= t;
+		}
+	}
+}
+
+/**
+ * @brief The type of the kernel that AND-reduces four rows against a vector.
+ * Bit k (k=0,1,2,3) of the returned mask is 1 iff the k-th row intersects
+ * the vector, i.e., iff (row_k & v) is not all 0's.
+ * @param r0,r1,r2,r3 the blocks of the four rows.
+ * @param v the blocks of the vector.
+ * @param nblocks the number of blocks of each row (and of the vector).
+ * @return a 4-bit mask.
+ */
+typedef unsigned (*and_any4_fn)(const block_type* r0, const block_type* r1,
+	const block_type* r2, const block_type* r3, const block_type* v, size_type nblocks);
+
+
+// The scalar version, which stops as soon as all four rows have a hit.
+inline
+unsigned and_any4_scalar(const block_type* r0, const block_type* r1,
+	const block_type* r2, const block_type* r3, const block_type* v, size_type nblocks)
+{
+	block_type _a0 = 0, _a1 = 0, _a2 = 0, _a3 = 0;
+	for (size_type k = 0; k < nblocks; ++k)
+	{
+		block_type _v = v[k];
+		_a0 |= r0[k] & _v;
+		_a1 |= r1[k] & _v;
+		_a2 |= r2[k] & _v;
+		_a3 |= r3[k] & _v;
+
+		if (_a0 && _a1 && _a2 && _a3)
+			break;
+	}
+
+	return (_a0 != 0) | ((_a1 != 0) << 1) | ((_a2 != 0) << 2) | ((_a3 != 0) << 3);
+}
+
+#ifdef ARGUMATRIX_X86_KERNELS
+
+// The AVX2 version, 256 bits (4 blocks) of each row per step. Attack matrices
+// are sparse, so most products have no hit and the whole row must be scanned
+// anyway; we therefore do not test for an early exit in the loop.
+__attribute__((target("avx2")))
+inline
+unsigned and_any4_avx2(const block_type* r0, const block_type* r1,
+	const block_type* r2, const block_type* r3, const block_type* v, size_type nblocks)
+{
+	__m256i _a0 = _mm256_setzero_si256();
+	__m256i _a1 = _mm256_setzero_si256();
+	__m256i _a2 = _mm256_setzero_si256();
+	__m256i _a3 = _mm256_setzero_si256();
+
+	size_type k = 0;
+	for (; k + 4 <= nblocks; k += 4)
+	{
+		__m256i _v = _mm256_loadu_si256((const __m256i*)(v + k));
+		_a0 = _mm256_or_si256(_a0, _mm256_and_si256(_v, _mm256_loadu_si256((const __m256i*)(r0 + k))));
+		_a1 = _mm256_or_si256(_a1, _mm256_and_si256(_v, _mm256_loadu_si256((const __m256i*)(r1 + k))));
+		_a2 = _mm256_or_si256(_a2, _mm256_and_si256(_v, _mm256_loadu_si256((const __m256i*)(r2 + k))));
+		_a3 = _mm256_or_si256(_a3, _mm256_and_si256(_v, _mm256_loadu_si256((const __m256i*)(r3 + k))));
+	}
+
+	unsigned _mask = (!_mm256_testz_si256(_a0, _a0))
+		| ((!_mm256_testz_si256(_a1, _a1)) << 1)
+		| ((!_mm256_testz_si256(_a2, _a2)) << 2)
+		| ((!_mm256_testz_si256(_a3, _a3)) << 3);
+
+	// The remaining blocks
+	if (k < nblocks) {
+		_mask |= and_any4_scalar(r0 + k, r1 + k, r2 + k, r3 + k, v + k, nblocks - k);
+	}
+
+	return _mask;
+}
+
+// The AVX-512 version, 512 bits (8 blocks) of each row per step.
+__attribute__((target("avx512f")))
+inline
+unsigned and_any4_avx512(const block_type* r0, const block_type* r1,
+	const block_type* r2, const block_type* r3, const block_type* v, size_type nblocks)
+{
+	__m512i _a0 = _mm512_setzero_si512();
+	__m512i _a1 = _mm512_setzero_si512();
+	__m512i _a2 = _mm512_setzero_si512();
+	__m512i _a3 = _mm512_setzero_si512();
+
+	size_type k = 0;
+	for (; k + 8 <= nblocks; k += 8)
+	{
+		__m512i _v = _mm512_loadu_si512((const void*)(v + k));
+		_a0 = _mm512_or_si512(_a0, _mm512_and_si512(_v, _mm512_loadu_si512((const void*)(r0 + k))));
+		_a1 = _mm512_or_si512(_a1, _mm512_and_si512(_v, _mm512_loadu_si512((const void*)(r1 + k))));
+		_a2 = _mm512_or_si512(_a2, _mm512_and_si512(_v, _mm512_loadu_si512((const void*)(r2 + k))));
+		_a3 = _mm512_or_si512(_a3, _mm512_and_si512(_v, _mm512_loadu_si512((const void*)(r3 + k))));
+	}
+
+	unsigned _mask = (_mm512_test_epi64_mask(_a0, _a0) != 0)
+		| ((_mm512_test_epi64_mask(_a1, _a1) != 0) << 1)
+		| ((_mm512_test_epi64_mask(_a2, _a2) != 0) << 2)
+		| ((_mm512_test_epi64_mask(_a3, _a3) != 0) << 3);
+
+	// The remaining blocks
+	if (k < nblocks) {
+		_mask |= and_any4_scalar(r0 + k, r1 + k, r2 + k, r3 + k, v + k, nblocks - k);
+	}
+
+	return _mask;
+}
+
+#endif // ARGUMATRIX_X86_KERNELS
+
+
+/**
+ * @brief Select the fastest and_any4 kernel supported by the running CPU,
+ * unless the environment variable ARGUMATRIX_SIMD requires another one.
+ */
+inline
+and_any4_fn select_and_any4()
+{
+	const char* _req = getenv("ARGUMATRIX_SIMD");
+	if (_req != NULL && strcmp(_req, "scalar") == 0)
+		return &and_any4_scalar;
+
+#ifdef ARGUMATRIX_X86_KERNELS
+	__builtin_cpu_init();
+	bool _has_avx512 = __builtin_cpu_supports("avx512f");
+	bool _has_avx2 = __builtin_cpu_supports("avx2");
+
+	if (_req != NULL && strcmp(_req, "avx2") == 0)
+		return _has_avx2 ? &and_any4_avx2 : &and_any4_scalar;
+
+	if (_has_avx512)
+		return &and_any4_avx512;
+	if (_has_avx2)
+		return &and_any4_avx2;
+#endif
+
+	return &and_any4_scalar;
+}
+
+/**
+ * @brief Get the and_any4 kernel. The selection is done once, at the first call.
+ */
+inline
+and_any4_fn and_any4_kernel()
+{
+	static const and_any4_fn _kernel = select_and_any4();
+	return _kernel;
+}
+
+/**
+ * @brief Get the name of the selected kernel, e.g., for benchmark reports.
+ */
+inline
+const char* and_any4_kernel_name()
+{
+	and_any4_fn _kernel = and_any4_kernel();
+#ifdef ARGUMATRIX_X86_KERNELS
+	if (_kernel == &and_any4_avx512) return "avx512";
+	if (_kernel == &and_any4_avx2) return "avx2";
+#endif
+	return "scalar";
+}
+
+} // namespace bitkernel
+
+} // namespace argumatrix
+#endif
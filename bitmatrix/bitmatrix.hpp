@@ -8,137 +8,258 @@
 #include <vector>
 #include <iostream>
 
-#include <boost/dynamic_bitset/dynamic_bitset.hpp>
 #include "config/config.hpp"
 #include "bitvector.hpp"
+#include "bitkernel.hpp"
+#include "bitrow.hpp"
+#include <boost/dynamic_bitset/dynamic_bitset.hpp>
+#include <boost/align/aligned_allocator.hpp>
 #include <utility>
 
 
 namespace argumatrix {  // argumatrix
 using namespace std;
 
+/**
+ * @brief A Boolean matrix. All the rows are stored in one block buffer that is
+ * aligned to cache lines, and the row stride (the number of blocks between two
+ * consecutive rows) is rounded up to a whole number of cache lines. Thus the
+ * copy of a bitmatrix is a single allocation, a row never shares a cache line
+ * with another row, and the row scans of the kernels are sequential memory
+ * accesses. The padding blocks of a row are always 0's.
+ * The rows are accessed by the views bitrow/const_bitrow (see bitrow.hpp).
+ */
 class bitmatrix{ 	
  public:
+	typedef bitrow row_reference;
+	typedef const_bitrow const_row_reference;
+
+	// The alignment of the block buffer, i.e., the size of a cache line
+	static const size_type alignment = 64;
+	// The number of blocks per cache line
+	static const size_type blocks_per_line = alignment / sizeof(block_type);
+
 	// constructors
 	bitmatrix(size_type num_size);
 	bitmatrix(size_type num_rows, size_type num_columns);
 	// copy constructor
 	bitmatrix(const bitmatrix& _bm);
-	bitmatrix(): m_nRow(0), m_nColumn(0) {}  // default constructor 
+	bitmatrix(bitmatrix&& _bm);
+	bitmatrix(): m_nRow(0), m_nColumn(0), m_stride(0) {}  // default constructor 
 	
 	void show();
-	bitvector& operator[](size_type pos);	
-	const bitvector& operator[](size_type pos) const { return m_bitData[pos]; }
-	//const bitvector& operator[](const size_type pos);	
-	bitvector operator*(const bitvector& _bv);
-	bitmatrix operator*(const bitmatrix& _bm);
-	bitmatrix operator=(const bitmatrix& _bm);
+	bitrow operator[](size_type pos);	
+	const_bitrow operator[](size_type pos) const;
+	/**
+	 * @brief The multiplication of a bitmatrix and a bitvector. The i-th entry
+	 * of the result is the multiplication of the i-th row and _bv, i.e., whether
+	 * the i-th row intersects with _bv. Rows are processed four at a time by the
+	 * fastest kernel of bitkernel.hpp, and the result bits are written straight
+	 * into the blocks of the result.
+	 * @param _bv a bitvector of size sizeC().
+	 * @return a bitvector of size sizeR().
+	 */
+	bitvector operator*(const bitvector& _bv) const;
+	bitmatrix operator*(const bitmatrix& _bm) const;
+	bitmatrix& operator=(const bitmatrix& _bm);
+	bitmatrix& operator=(bitmatrix&& _bm);
 
 	// set the row bitvector of bitmatrix at pos with _bv
 	void setBitvector(const bitvector& _bv, size_type pos);  
 	
 	// get a copy of the row bitvector of bitmatrix at pos
-	bitvector getBitvector(size_type pos);
+	bitvector getBitvector(size_type pos) const;
 
 	bitmatrix transpose() const;
 	size_type sizeR() const { return m_nRow; }
 	size_type sizeC() const { return m_nColumn; }
 
-	void push_back(bitvector& _bv);
+	/**
+	 * @brief The number of blocks between the beginnings of two consecutive
+	 * rows, a multiple of blocks_per_line.
+	 */
+	size_type stride() const { return m_stride; }
+
+	void push_back(const bitvector& _bv);
 
 	/**
 	 * Get the diagonal elements of a bitmatrix
 	 * @return the bitvector of the diagonal elements
 	 */
-	bitvector diag();
+	bitvector diag() const;
 
 private:
+	typedef std::vector< block_type, 
+		boost::alignment::aligned_allocator<block_type, alignment> > block_buffer;
+
+	// The stride of rows with num_columns columns
+	static size_type row_stride(size_type num_columns);
+
+	block_type* row_blocks(size_type pos) { return m_blocks.data() + pos*m_stride; }
+	const block_type* row_blocks(size_type pos) const { return m_blocks.data() + pos*m_stride; }
+
 	size_type m_nRow;
 	size_type m_nColumn;
-	std::vector< bitvector > m_bitData;
+	size_type m_stride;
+	block_buffer m_blocks;
 };
 
+inline
+size_type bitmatrix::row_stride(size_type num_columns)
+{
+	size_type _nb = (num_columns + bitvector::bits_per_block - 1) / bitvector::bits_per_block;
+	return (_nb + blocks_per_line - 1) / blocks_per_line * blocks_per_line;
+}
+
 bitmatrix::bitmatrix(size_type num_rows, size_type num_columns )
 	:m_nRow(num_rows),
-	 m_nColumn(num_columns)
+	 m_nColumn(num_columns),
+	 m_stride(row_stride(num_columns)),
+	 m_blocks(num_rows*m_stride, 0)
 {
-	m_bitData.resize(m_nRow);
-	
-	for(size_type i=0; i < m_nRow; i++){
-		m_bitData[i].resize(m_nColumn, false);
-	}
 }
 
 bitmatrix::bitmatrix(size_type num_size)
 	:m_nRow(num_size),
-	 m_nColumn(num_size)
+	 m_nColumn(num_size),
+	 m_stride(row_stride(num_size)),
+	 m_blocks(num_size*m_stride, 0)
 {
-	m_bitData.resize(m_nRow);
-	
-	for(size_type i=0; i < m_nRow; i++){
-		m_bitData[i].resize(m_nColumn, false);
-	}
 }
 
 bitmatrix::bitmatrix(const bitmatrix& _bm)
+	:m_nRow(_bm.m_nRow),
+	 m_nColumn(_bm.m_nColumn),
+	 m_stride(_bm.m_stride),
+	 m_blocks(_bm.m_blocks)
 {
-	m_nRow = _bm.m_nRow;
-	m_nColumn = _bm.m_nColumn;
-	m_bitData = _bm.m_bitData;
+}
+
+bitmatrix::bitmatrix(bitmatrix&& _bm)
+	:m_nRow(_bm.m_nRow),
+	 m_nColumn(_bm.m_nColumn),
+	 m_stride(_bm.m_stride),
+	 m_blocks(std::move(_bm.m_blocks))
+{
+	_bm.m_nRow = _bm.m_nColumn = _bm.m_stride = 0;
 }
 
 
 void bitmatrix::show(){
 	for(size_type i=0; i<m_nRow; i++){
-		std::cout<< m_bitData[i] << std::endl;
+		std::cout<< (*this)[i] << std::endl;
 	}
 }
 
-bitvector& bitmatrix::operator[](size_type pos) {
-	return m_bitData[pos];
+inline
+bitrow bitmatrix::operator[](size_type pos) {
+	assert(pos < m_nRow);
+	return bitrow(row_blocks(pos), m_nColumn);
+}
+
+inline
+const_bitrow bitmatrix::operator[](size_type pos) const {
+	assert(pos < m_nRow);
+	return const_bitrow(row_blocks(pos), m_nColumn);
 }
 
-bitvector bitmatrix::operator*(const bitvector& _bv){
+bitvector bitmatrix::operator*(const bitvector& _bv) const {
 	assert(_bv.size()==m_nColumn);
-	bitvector bv1(_bv.size());
-	for(size_type i=0; i<m_nColumn; i++){
-		bv1[i] = m_bitData[i]*_bv;
+	bitvector bv1(m_nRow);
+
+	const size_type _bpb = bitvector::bits_per_block;
+	const size_type _nb = _bv.num_blocks();
+	const block_type* _v = _bv.blocks();
+	block_type* _out = bv1.blocks();
+	bitkernel::and_any4_fn _and_any4 = bitkernel::and_any4_kernel();
+
+	// Four rows at a time. Since bits_per_block is a multiple of 4, the four
+	// result bits always fall into the same block.
+	size_type i = 0;
+	const block_type* _row = m_blocks.data();
+	for( ; i+4 <= m_nRow; i += 4, _row += 4*m_stride){
+		block_type _mask = _and_any4(_row, _row + m_stride,
+			_row + 2*m_stride, _row + 3*m_stride, _v, _nb);
+		_out[i/_bpb] |= _mask << (i%_bpb);
 	}
+	for( ; i<m_nRow; i++){
+		if ((*this)[i].intersects(_bv))
+			_out[i/_bpb] |= block_type(1) << (i%_bpb);
+	}
+
 	return bv1;
 }
 
 bitmatrix bitmatrix::transpose() const {
 	assert(m_nColumn>0);
 	assert(m_nRow>0);
+	assert(bitvector::bits_per_block == 64);
 	
 	bitmatrix bm(m_nColumn, m_nRow);
-	
-	for(size_type i=0; i<m_nColumn; i++){
-		for(size_type j=0; j<m_nRow; j++){
-			bm[i][j] = m_bitData[j][i];
-		} 
+
+	// The matrix is cut into 64x64 tiles. The tile (I,J), i.e., the J-th block
+	// of the rows 64I..64I+63, is gathered, transposed by a word-level kernel,
+	// and then scattered into the I-th block of the rows 64J..64J+63 of the
+	// result. The rows out of range are read as 0's and are not written.
+	const size_type _nbr = (m_nRow + 63) / 64;
+	const size_type _nbc = (m_nColumn + 63) / 64;
+	block_type _tile[64];
+
+	for(size_type I=0; I<_nbr; I++){
+		const size_type _rows = min<size_type>(64, m_nRow - I*64);
+		for(size_type J=0; J<_nbc; J++){
+			const size_type _cols = min<size_type>(64, m_nColumn - J*64);
+
+			const block_type* _src = row_blocks(I*64) + J;
+			bool _any = false;
+			for(size_type r=0; r<_rows; r++, _src += m_stride){
+				_tile[r] = *_src;
+				_any = _any || _tile[r];
+			}
+			if (!_any)   // Attack matrices are sparse, skip the empty tiles
+				continue;
+			for(size_type r=_rows; r<64; r++)
+				_tile[r] = 0;
+
+			bitkernel::transpose64(_tile);
+
+			block_type* _dst = bm.row_blocks(J*64) + I;
+			for(size_type c=0; c<_cols; c++, _dst += bm.m_stride){
+				*_dst = _tile[c];
+			}
+		}
 	}
 	
 	return bm;
 }
 
-bitmatrix bitmatrix::operator=(const bitmatrix& _bm){
+bitmatrix& bitmatrix::operator=(const bitmatrix& _bm){
 	m_nRow = _bm.m_nRow;
 	m_nColumn = _bm.m_nColumn;
-	m_bitData = _bm.m_bitData;
+	m_stride = _bm.m_stride;
+	m_blocks = _bm.m_blocks;
 	
 	return *this;
 }
 
-bitmatrix bitmatrix::operator*(const bitmatrix& _bm_r){
+bitmatrix& bitmatrix::operator=(bitmatrix&& _bm){
+	m_nRow = _bm.m_nRow;
+	m_nColumn = _bm.m_nColumn;
+	m_stride = _bm.m_stride;
+	m_blocks = std::move(_bm.m_blocks);
+	_bm.m_nRow = _bm.m_nColumn = _bm.m_stride = 0;
+	
+	return *this;
+}
+
+bitmatrix bitmatrix::operator*(const bitmatrix& _bm_r) const {
 	assert( m_nColumn == _bm_r.m_nRow);
 	bitmatrix result_bm(m_nRow, _bm_r.m_nColumn);
 	bitmatrix _bm_r_t = _bm_r.transpose();
 	
+	// The i-th row of the result is (_bm_r^T * the i-th row)
 	for(size_type i=0; i<m_nRow; i++){
-		for(size_type j=0; j<_bm_r_t.m_nRow; j++){
-			result_bm[i][j] = (m_bitData[i]*_bm_r_t.m_bitData[j]);
-		} 
+		result_bm[i] = _bm_r_t * getBitvector(i);
 	}
 	
 	return result_bm;
@@ -149,17 +270,17 @@ void bitmatrix::setBitvector(const bitvector& _bv, size_type pos)
 	assert(pos >=0 && pos < m_nRow);
 	assert(m_nColumn == _bv.size());
 	
-	m_bitData[pos] = _bv;
+	(*this)[pos] = _bv;
 }
 
-bitvector bitmatrix::getBitvector(size_type pos)
+bitvector bitmatrix::getBitvector(size_type pos) const
 {
 	assert(pos >=0 && pos < m_nRow);
 
-	return m_bitData[pos];
+	return (*this)[pos];
 }
 
-void bitmatrix::push_back(bitvector& _bv)
+void bitmatrix::push_back(const bitvector& _bv)
 {
 	// The _bv must none empty, i.e., _bv.size()>0
 	assert(!_bv.empty());
@@ -167,22 +288,24 @@ void bitmatrix::push_back(bitvector& _bv)
 	// if the bitmatrix is empty, _bv will be the first row of it
 	if (m_nRow == 0){
 		m_nColumn = _bv.size();
+		m_stride = row_stride(m_nColumn);
 	}
 
 	assert( _bv.size() == m_nColumn );
 	
-	m_bitData.push_back(_bv);
-
+	m_blocks.resize((m_nRow+1)*m_stride, 0);
 	++m_nRow;
+
+	(*this)[m_nRow-1] = _bv;
 }
 
-bitvector bitmatrix::diag()
+bitvector bitmatrix::diag() const
 {
 	size_type _sz = min(m_nRow, m_nColumn);
 	bitvector _bv( _sz );
 
 	for (size_type i=0; i<_sz; i++)
-		_bv[i] = m_bitData[i][i];
+		_bv[i] = (*this)[i][i];
 
 	return _bv;
 }
@@ -0,0 +1,392 @@
+#ifndef BIT_ROW_HPP
+#define BIT_ROW_HPP
+
+#include <assert.h>
+#include <string.h>
+#include <iostream>
+
+#include "config/config.hpp"
+#include "bitvector.hpp"
+#include "bitkernel.hpp"
+
+
+namespace argumatrix {  // argumatrix
+
+/**
+ * @brief A read-only view of a row of a bitmatrix. It does not own the blocks,
+ * it only points to the blocks of the row in the block buffer of the bitmatrix.
+ * Thus it is cheap to create and to pass by value, but it is invalidated once
+ * the bitmatrix is resized or destroyed. The view provides the read-only
+ * operations of bitvector (test, count, intersects, is_subset_of, ...), and it
+ * can be converted into a bitvector when a copy is really needed.
+ * The unused bits of the last block of a row are always 0's.
+ */
+class const_bitrow
+{
+public:
+	const_bitrow(const block_type* _blocks, size_type _nbits)
+		: m_blocks(const_cast<block_type*>(_blocks)), m_nbits(_nbits) { }
+	// The view of the blocks of a bitvector
+	explicit const_bitrow(const dynamic_bitset<block_type>& _bv);
+
+	size_type size() const { return m_nbits; }
+	size_type num_blocks() const { return (m_nbits + bits_per_block - 1) / bits_per_block; }
+	const block_type* blocks() const { return m_blocks; }
+
+	bool test(size_type pos) const {
+		assert(pos < m_nbits);
+		return (m_blocks[pos / bits_per_block] >> (pos % bits_per_block)) & 1;
+	}
+	bool operator[](size_type pos) const { return test(pos); }
+
+	// The number of 1's of the row
+	size_type count() const;
+	bool any() const;
+	bool none() const { return !any(); }
+
+	/**
+	 * @brief Whether the row intersects with a set, i.e., whether the row and
+	 * the set have at least one common 1.
+	 */
+	bool intersects(const const_bitrow& _r) const;
+	bool intersects(const dynamic_bitset<block_type>& _bv) const;
+
+	/**
+	 * @brief Whether the row is a subset of a set, i.e., all the 1's of the row
+	 * are also the 1's of the set.
+	 */
+	bool is_subset_of(const const_bitrow& _r) const;
+	bool is_subset_of(const dynamic_bitset<block_type>& _bv) const;
+
+	/**
+	 * @brief Find the position of the first 1 (respectively, of the first 1
+	 * after pos). Return bitvector::npos if there is no such 1.
+	 */
+	size_type find_first() const { return find_from(0); }
+	size_type find_next(size_type pos) const { return find_from(pos + 1); }
+
+	// Get a copy of the row.
+	operator bitvector() const;
+
+	static const size_type bits_per_block = bitvector::bits_per_block;
+
+protected:
+	size_type find_from(size_type pos) const;
+
+	block_type* m_blocks;
+	size_type m_nbits;
+};
+
+
+/**
+ * @brief A mutable view of a row of a bitmatrix. The assignment of a bitrow
+ * assigns the content of the row, not the view itself, so that the statements
+ * like "bm[i] = _bv" and "bm[i][j] = true" work as for a vector of bitvectors.
+ */
+class bitrow : public const_bitrow
+{
+public:
+	// A proxy of a bit of the row, like dynamic_bitset<>::reference
+	class reference
+	{
+	public:
+		reference(block_type& _b, size_type _pos)
+			: m_block(_b), m_mask(block_type(1) << _pos) { }
+
+		operator bool() const { return (m_block & m_mask) != 0; }
+		bool operator~() const { return (m_block & m_mask) == 0; }
+
+		reference& operator=(bool x) { if (x) m_block |= m_mask; else m_block &= ~m_mask; return *this; }
+		reference& operator=(const reference& _r) { return *this = bool(_r); }
+		reference& operator|=(bool x) { if (x) m_block |= m_mask; return *this; }
+		reference& operator&=(bool x) { if (!x) m_block &= ~m_mask; return *this; }
+
+	private:
+		block_type& m_block;
+		const block_type m_mask;
+	};
+
+	bitrow(block_type* _blocks, size_type _nbits) : const_bitrow(_blocks, _nbits) { }
+
+	block_type* blocks() const { return m_blocks; }
+
+	reference operator[](size_type pos) const {
+		assert(pos < m_nbits);
+		return reference(m_blocks[pos / bits_per_block], pos % bits_per_block);
+	}
+
+	bitrow& set(size_type pos, bool val = true) { (*this)[pos] = val; return *this; }
+	bitrow& reset(size_type pos) { return set(pos, false); }
+	// Set all the bits of the row to 0
+	bitrow& reset();
+
+	// Copy the content of a row or of a bitvector of the same size into this row
+	bitrow& operator=(const bitrow& _r) { return assign(_r.blocks(), _r.size()); }
+	bitrow& operator=(const const_bitrow& _r) { return assign(_r.blocks(), _r.size()); }
+	bitrow& operator=(const dynamic_bitset<block_type>& _bv);
+
+	// In-place set operations, without any temporary bitvector
+	bitrow& operator|=(const const_bitrow& _r);
+	bitrow& operator&=(const const_bitrow& _r);
+	bitrow& operator-=(const const_bitrow& _r);
+	bitrow& operator|=(const dynamic_bitset<block_type>& _bv);
+	bitrow& operator&=(const dynamic_bitset<block_type>& _bv);
+	bitrow& operator-=(const dynamic_bitset<block_type>& _bv);
+
+private:
+	bitrow& assign(const block_type* _src, size_type _nbits);
+};
+
+
+namespace detail {
+	// The raw blocks of a dynamic_bitset (see BOOST_DYNAMIC_BITSET_DONT_USE_FRIENDS)
+	inline
+	const block_type* db_blocks(const dynamic_bitset<block_type>& _bv)
+	{
+		return _bv.m_bits.empty() ? NULL : &_bv.m_bits[0];
+	}
+	inline
+	block_type* db_blocks(dynamic_bitset<block_type>& _bv)
+	{
+		return _bv.m_bits.empty() ? NULL : &_bv.m_bits[0];
+	}
+} // namespace detail
+
+
+inline
+const_bitrow::const_bitrow(const dynamic_bitset<block_type>& _bv)
+	: m_blocks(const_cast<block_type*>(detail::db_blocks(_bv))), m_nbits(_bv.size())
+{
+
+}
+
+inline
+size_type const_bitrow::count() const
+{
+	size_type _n = 0;
+	for (size_type k = 0, _nb = num_blocks(); k < _nb; ++k)
+		_n += bitkernel::popcount(m_blocks[k]);
+	return _n;
+}
+
+inline
+bool const_bitrow::any() const
+{
+	for (size_type k = 0, _nb = num_blocks(); k < _nb; ++k)
+		if (m_blocks[k]) return true;
+	return false;
+}
+
+inline
+bool const_bitrow::intersects(const const_bitrow& _r) const
+{
+	assert(m_nbits == _r.m_nbits);
+	for (size_type k = 0, _nb = num_blocks(); k < _nb; ++k)
+		if (m_blocks[k] & _r.m_blocks[k]) return true;
+	return false;
+}
+
+inline
+bool const_bitrow::intersects(const dynamic_bitset<block_type>& _bv) const
+{
+	assert(m_nbits == _bv.size());
+	const block_type* _b = detail::db_blocks(_bv);
+	for (size_type k = 0, _nb = num_blocks(); k < _nb; ++k)
+		if (m_blocks[k] & _b[k]) return true;
+	return false;
+}
+
+inline
+bool const_bitrow::is_subset_of(const const_bitrow& _r) const
+{
+	assert(m_nbits == _r.m_nbits);
+	for (size_type k = 0, _nb = num_blocks(); k < _nb; ++k)
+		if (m_blocks[k] & ~_r.m_blocks[k]) return false;
+	return true;
+}
+
+inline
+bool const_bitrow::is_subset_of(const dynamic_bitset<block_type>& _bv) const
+{
+	assert(m_nbits == _bv.size());
+	const block_type* _b = detail::db_blocks(_bv);
+	for (size_type k = 0, _nb = num_blocks(); k < _nb; ++k)
+		if (m_blocks[k] & ~_b[k]) return false;
+	return true;
+}
+
+inline
+size_type const_bitrow::find_from(size_type pos) const
+{
+	if (pos >= m_nbits)
+		return bitvector::npos;
+
+	size_type k = pos / bits_per_block;
+	block_type _b = m_blocks[k] & (~block_type(0) << (pos % bits_per_block));
+	for (size_type _nb = num_blocks(); ; ) {
+		if (_b)
+			return k * bits_per_block + bitkernel::lowest_bit(_b);
+		if (++k >= _nb)
+			return bitvector::npos;
+		_b = m_blocks[k];
+	}
+}
+
+inline
+const_bitrow::operator bitvector() const
+{
+	bitvector _bv(m_nbits);
+	if (m_nbits > 0)
+		memcpy(_bv.blocks(), m_blocks, num_blocks() * sizeof(block_type));
+	return _bv;
+}
+
+inline
+bitrow& bitrow::reset()
+{
+	memset(m_blocks, 0, num_blocks() * sizeof(block_type));
+	return *this;
+}
+
+inline
+bitrow& bitrow::assign(const block_type* _src, size_type _nbits)
+{
+	assert(m_nbits == _nbits);
+	if (_src != m_blocks && _nbits > 0)
+		memcpy(m_blocks, _src, num_blocks() * sizeof(block_type));
+	return *this;
+}
+
+inline
+bitrow& bitrow::operator=(const dynamic_bitset<block_type>& _bv)
+{
+	return assign(detail::db_blocks(_bv), _bv.size());
+}
+
+inline
+bitrow& bitrow::operator|=(const const_bitrow& _r)
+{
+	assert(m_nbits == _r.size());
+	for (size_type k = 0, _nb = num_blocks(); k < _nb; ++k)
+		m_blocks[k] |= _r.blocks()[k];
+	return *this;
+}
+
+inline
+bitrow& bitrow::operator&=(const const_bitrow& _r)
+{
+	assert(m_nbits == _r.size());
+	for (size_type k = 0, _nb = num_blocks(); k < _nb; ++k)
+		m_blocks[k] &= _r.blocks()[k];
+	return *this;
+}
+
+inline
+bitrow& bitrow::operator-=(const const_bitrow& _r)
+{
+	assert(m_nbits == _r.size());
+	for (size_type k = 0, _nb = num_blocks(); k < _nb; ++k)
+		m_blocks[k] &= ~_r.blocks()[k];
+	return *this;
+}
+
+inline
+bitrow& bitrow::operator|=(const dynamic_bitset<block_type>& _bv)
+{
+	return *this |= const_bitrow(detail::db_blocks(_bv), _bv.size());
+}
+
+inline
+bitrow& bitrow::operator&=(const dynamic_bitset<block_type>& _bv)
+{
+	return *this &= const_bitrow(detail::db_blocks(_bv), _bv.size());
+}
+
+inline
+bitrow& bitrow::operator-=(const dynamic_bitset<block_type>& _bv)
+{
+	return *this -= const_bitrow(detail::db_blocks(_bv), _bv.size());
+}
+
+
+/************************************************************************/
+/* Operations between bitvectors and rows                               */
+/************************************************************************/
+
+inline
+dynamic_bitset<block_type>& operator|=(dynamic_bitset<block_type>& _bv, const const_bitrow& _r)
+{
+	assert(_bv.size() == _r.size());
+	block_type* _b = detail::db_blocks(_bv);
+	for (size_type k = 0, _nb = _r.num_blocks(); k < _nb; ++k)
+		_b[k] |= _r.blocks()[k];
+	return _bv;
+}
+
+inline
+dynamic_bitset<block_type>& operator&=(dynamic_bitset<block_type>& _bv, const const_bitrow& _r)
+{
+	assert(_bv.size() == _r.size());
+	block_type* _b = detail::db_blocks(_bv);
+	for (size_type k = 0, _nb = _r.num_blocks(); k < _nb; ++k)
+		_b[k] &= _r.blocks()[k];
+	return _bv;
+}
+
+inline
+dynamic_bitset<block_type>& operator-=(dynamic_bitset<block_type>& _bv, const const_bitrow& _r)
+{
+	assert(_bv.size() == _r.size());
+	block_type* _b = detail::db_blocks(_bv);
+	for (size_type k = 0, _nb = _r.num_blocks(); k < _nb; ++k)
+		_b[k] &= ~_r.blocks()[k];
+	return _bv;
+}
+
+inline
+bitvector operator&(const const_bitrow& _r, const dynamic_bitset<block_type>& _bv)
+{
+	bitvector _res(_bv);
+	_res &= _r;
+	return _res;
+}
+
+inline
+bitvector operator&(const dynamic_bitset<block_type>& _bv, const const_bitrow& _r)
+{
+	return _r & _bv;
+}
+
+inline
+bitvector operator|(const const_bitrow& _r, const dynamic_bitset<block_type>& _bv)
+{
+	bitvector _res(_bv);
+	_res |= _r;
+	return _res;
+}
+
+inline
+bitvector operator|(const dynamic_bitset<block_type>& _bv, const const_bitrow& _r)
+{
+	return _r | _bv;
+}
+
+inline
+bitvector operator-(const dynamic_bitset<block_type>& _bv, const const_bitrow& _r)
+{
+	bitvector _res(_bv);
+	_res -= _r;
+	return _res;
+}
+
+// Print a row in the same way as a dynamic_bitset, i.e., from the last bit to the first one
+inline
+std::ostream& operator<<(std::ostream& os, const const_bitrow& _r)
+{
+	for (size_type i = _r.size(); i > 0; --i)
+		os << (_r.test(i - 1) ? '1' : '0');
+	return os;
+}
+
+} // namespace argumatrix
+#endif
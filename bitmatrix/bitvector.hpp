@@ -10,6 +10,12 @@
 
 #include "config/config.hpp"
 
+// Make the block buffer (m_bits) of dynamic_bitset accessible, so that the
+// kernels in bitkernel.hpp can work on the raw blocks of a bitvector. This
+// macro must be defined before dynamic_bitset.hpp is included.
+#ifndef BOOST_DYNAMIC_BITSET_DONT_USE_FRIENDS
+#define BOOST_DYNAMIC_BITSET_DONT_USE_FRIENDS
+#endif
 #include <boost/dynamic_bitset/dynamic_bitset.hpp>
 
 
@@ -107,6 +113,15 @@ public:
 	 * @return the bitvector of the empty set or the universal set.
 	 */
 	bool Increase();
+
+	/**
+	 * @brief Get the raw blocks of the bitvector. Bit i is stored in the block
+	 * blocks()[i/bits_per_block] at the position i%bits_per_block. The unused
+	 * bits of the last block are always 0's.
+	 * @return the pointer to the first block.
+	 */
+	const block_type* blocks() const { return m_bits.data(); }
+	block_type* blocks() { return m_bits.data(); }
 };
 
 __inline
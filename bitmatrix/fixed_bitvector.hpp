@@ -0,0 +1,331 @@
+#ifndef FIXED_BIT_VECTOR_HPP
+#define FIXED_BIT_VECTOR_HPP
+
+#include <assert.h>
+#include <string.h>
+#include <iostream>
+
+#include "config/config.hpp"
+#include "bitvector.hpp"
+#include "bitkernel.hpp"
+#include "bitrow.hpp"
+
+
+namespace argumatrix {  // argumatrix
+
+/**
+ * @brief A bitvector of at most N bits, whose blocks are stored in the object
+ * itself instead of the heap. Thus a copy is a copy of a few words, and a
+ * fixed_bitvector lives in registers and on the stack. The size (the number
+ * of the arguments) is given at runtime, and the bits from size() to N are
+ * always 0's. It has the interface of bitvector which is used by the searches,
+ * and it is viewed as a const_bitrow for the operations with the rows of a
+ * bitmatrix, e.g.,
+ * ~~~~~{.cpp}
+ *   fixed_bitvector<64> _out = fixed_bitvector<64>::EmptySet(m_argNum);
+ *   _out |= m_attackedBy[i];
+ *   bool _b = m_BmAtkMtx[j].is_subset_of(_out);
+ * ~~~~~
+ */
+template<size_type N>
+class fixed_bitvector
+{
+public:
+	typedef bitrow::reference reference;
+
+	static const size_type bits_per_block = bitvector::bits_per_block;
+	static const size_type num_words = (N + bits_per_block - 1) / bits_per_block;
+	static const size_type npos = bitvector::npos;
+
+	// Constructor, the empty set of _sz bits
+	fixed_bitvector(): m_nbits(0) { memset(m_bits, 0, sizeof(m_bits)); }
+	explicit fixed_bitvector(size_type _sz): m_nbits(_sz)
+	{
+		assert(_sz <= N);
+		memset(m_bits, 0, sizeof(m_bits));
+	}
+	explicit fixed_bitvector(const const_bitrow& _r);
+	explicit fixed_bitvector(const dynamic_bitset<block_type>& _bv);
+
+	size_type size() const { return m_nbits; }
+	const block_type* blocks() const { return m_bits; }
+	block_type* blocks() { return m_bits; }
+
+	// The view of the bits, e.g., for the operations with the rows of a bitmatrix
+	operator const_bitrow() const { return const_bitrow(m_bits, m_nbits); }
+
+	bool test(size_type pos) const
+	{
+		assert(pos < m_nbits);
+		return (m_bits[pos / bits_per_block] >> (pos % bits_per_block)) & 1;
+	}
+	bool operator[](size_type pos) const { return test(pos); }
+	reference operator[](size_type pos)
+	{
+		assert(pos < m_nbits);
+		return reference(m_bits[pos / bits_per_block], pos % bits_per_block);
+	}
+
+	fixed_bitvector& set(size_type pos, bool val = true) { (*this)[pos] = val; return *this; }
+	fixed_bitvector& reset(size_type pos) { return set(pos, false); }
+	fixed_bitvector& set();
+	fixed_bitvector& reset() { memset(m_bits, 0, sizeof(m_bits)); return *this; }
+
+	size_type count() const;
+	bool any() const;
+	bool none() const { return !any(); }
+	bool is_emptyset() const { return !any(); }
+
+	bool intersects(const fixed_bitvector& _bv) const;
+	bool is_subset_of(const fixed_bitvector& _bv) const;
+	bool is_proper_subset_of(const fixed_bitvector& _bv) const
+	{
+		return is_subset_of(_bv) && !(*this == _bv);
+	}
+
+	size_type find_first() const { return find_from(0); }
+	size_type find_next(size_type pos) const { return find_from(pos + 1); }
+
+	fixed_bitvector& operator|=(const fixed_bitvector& _bv);
+	fixed_bitvector& operator&=(const fixed_bitvector& _bv);
+	fixed_bitvector& operator-=(const fixed_bitvector& _bv);
+	fixed_bitvector& operator|=(const const_bitrow& _r);
+	fixed_bitvector& operator&=(const const_bitrow& _r);
+	fixed_bitvector& operator-=(const const_bitrow& _r);
+
+	bool operator==(const fixed_bitvector& _bv) const;
+	bool operator!=(const fixed_bitvector& _bv) const { return !(*this == _bv); }
+
+	static fixed_bitvector EmptySet(size_type _sz) { return fixed_bitvector(_sz); }
+	static fixed_bitvector UniversalSet(size_type _sz) { return fixed_bitvector(_sz).set(); }
+
+private:
+	size_type find_from(size_type pos) const;
+
+	block_type m_bits[num_words];
+	size_type m_nbits;
+};
+
+/**
+ * @brief The capacity of the fixed_bitvector for the frameworks of _nbits
+ * arguments, 64, 128 or 256, and 0 if a bitvector is needed.
+ */
+inline
+size_type fixed_width_for(size_type _nbits)
+{
+	return _nbits == 0 ? 0
+		: _nbits <= 64 ? 64
+		: _nbits <= 128 ? 128
+		: _nbits <= 256 ? 256 : 0;
+}
+
+
+template<size_type N>
+fixed_bitvector<N>::fixed_bitvector(const const_bitrow& _r): m_nbits(_r.size())
+{
+	assert(_r.size() <= N);
+	memset(m_bits, 0, sizeof(m_bits));
+	if (m_nbits > 0)
+		memcpy(m_bits, _r.blocks(), _r.num_blocks() * sizeof(block_type));
+}
+
+template<size_type N>
+fixed_bitvector<N>::fixed_bitvector(const dynamic_bitset<block_type>& _bv): m_nbits(_bv.size())
+{
+	assert(_bv.size() <= N);
+	memset(m_bits, 0, sizeof(m_bits));
+	if (m_nbits > 0)
+		memcpy(m_bits, detail::db_blocks(_bv), _bv.num_blocks() * sizeof(block_type));
+}
+
+template<size_type N>
+fixed_bitvector<N>& fixed_bitvector<N>::set()
+{
+	// The bits from m_nbits are kept 0's
+	for (size_type k = 0; k < num_words; ++k) {
+		size_type _bgn = k * bits_per_block;
+		m_bits[k] = _bgn + bits_per_block <= m_nbits ? ~block_type(0)
+			: _bgn >= m_nbits ? 0 : (block_type(1) << (m_nbits - _bgn)) - 1;
+	}
+	return *this;
+}
+
+template<size_type N>
+size_type fixed_bitvector<N>::count() const
+{
+	size_type _n = 0;
+	for (size_type k = 0; k < num_words; ++k)
+		_n += bitkernel::popcount(m_bits[k]);
+	return _n;
+}
+
+template<size_type N>
+bool fixed_bitvector<N>::any() const
+{
+	block_type _b = 0;
+	for (size_type k = 0; k < num_words; ++k)
+		_b |= m_bits[k];
+	return _b != 0;
+}
+
+template<size_type N>
+bool fixed_bitvector<N>::intersects(const fixed_bitvector& _bv) const
+{
+	block_type _b = 0;
+	for (size_type k = 0; k < num_words; ++k)
+		_b |= m_bits[k] & _bv.m_bits[k];
+	return _b != 0;
+}
+
+template<size_type N>
+bool fixed_bitvector<N>::is_subset_of(const fixed_bitvector& _bv) const
+{
+	block_type _b = 0;
+	for (size_type k = 0; k < num_words; ++k)
+		_b |= m_bits[k] & ~_bv.m_bits[k];
+	return _b == 0;
+}
+
+template<size_type N>
+size_type fixed_bitvector<N>::find_from(size_type pos) const
+{
+	if (pos >= m_nbits)
+		return npos;
+
+	size_type k = pos / bits_per_block;
+	block_type _b = m_bits[k] & (~block_type(0) << (pos % bits_per_block));
+	for ( ; ; ) {
+		if (_b)
+			return k * bits_per_block + bitkernel::lowest_bit(_b);
+		if (++k >= num_words)
+			return npos;
+		_b = m_bits[k];
+	}
+}
+
+template<size_type N>
+fixed_bitvector<N>& fixed_bitvector<N>::operator|=(const fixed_bitvector& _bv)
+{
+	for (size_type k = 0; k < num_words; ++k)
+		m_bits[k] |= _bv.m_bits[k];
+	return *this;
+}
+
+template<size_type N>
+fixed_bitvector<N>& fixed_bitvector<N>::operator&=(const fixed_bitvector& _bv)
+{
+	for (size_type k = 0; k < num_words; ++k)
+		m_bits[k] &= _bv.m_bits[k];
+	return *this;
+}
+
+template<size_type N>
+fixed_bitvector<N>& fixed_bitvector<N>::operator-=(const fixed_bitvector& _bv)
+{
+	for (size_type k = 0; k < num_words; ++k)
+		m_bits[k] &= ~_bv.m_bits[k];
+	return *this;
+}
+
+template<size_type N>
+fixed_bitvector<N>& fixed_bitvector<N>::operator|=(const const_bitrow& _r)
+{
+	assert(m_nbits == _r.size());
+	for (size_type k = 0, _nb = _r.num_blocks(); k < _nb; ++k)
+		m_bits[k] |= _r.blocks()[k];
+	return *this;
+}
+
+template<size_type N>
+fixed_bitvector<N>& fixed_bitvector<N>::operator&=(const const_bitrow& _r)
+{
+	assert(m_nbits == _r.size());
+	for (size_type k = 0, _nb = _r.num_blocks(); k < _nb; ++k)
+		m_bits[k] &= _r.blocks()[k];
+	return *this;
+}
+
+template<size_type N>
+fixed_bitvector<N>& fixed_bitvector<N>::operator-=(const const_bitrow& _r)
+{
+	assert(m_nbits == _r.size());
+	for (size_type k = 0, _nb = _r.num_blocks(); k < _nb; ++k)
+		m_bits[k] &= ~_r.blocks()[k];
+	return *this;
+}
+
+template<size_type N>
+bool fixed_bitvector<N>::operator==(const fixed_bitvector& _bv) const
+{
+	return m_nbits == _bv.m_nbits && memcmp(m_bits, _bv.m_bits, sizeof(m_bits)) == 0;
+}
+
+
+/************************************************************************/
+/* Operations between fixed_bitvectors and rows                         */
+/************************************************************************/
+
+template<size_type N>
+inline
+fixed_bitvector<N> operator|(const fixed_bitvector<N>& _a, const fixed_bitvector<N>& _b)
+{
+	fixed_bitvector<N> _res(_a);
+	return _res |= _b;
+}
+
+template<size_type N>
+inline
+fixed_bitvector<N> operator&(const fixed_bitvector<N>& _a, const fixed_bitvector<N>& _b)
+{
+	fixed_bitvector<N> _res(_a);
+	return _res &= _b;
+}
+
+template<size_type N>
+inline
+fixed_bitvector<N> operator-(const fixed_bitvector<N>& _a, const fixed_bitvector<N>& _b)
+{
+	fixed_bitvector<N> _res(_a);
+	return _res -= _b;
+}
+
+template<size_type N>
+inline
+fixed_bitvector<N> operator&(const const_bitrow& _r, const fixed_bitvector<N>& _bv)
+{
+	fixed_bitvector<N> _res(_bv);
+	return _res &= _r;
+}
+
+template<size_type N>
+inline
+fixed_bitvector<N> operator&(const fixed_bitvector<N>& _bv, const const_bitrow& _r)
+{
+	return _r & _bv;
+}
+
+template<size_type N>
+inline
+fixed_bitvector<N> operator|(const const_bitrow& _r, const fixed_bitvector<N>& _bv)
+{
+	fixed_bitvector<N> _res(_bv);
+	return _res |= _r;
+}
+
+template<size_type N>
+inline
+fixed_bitvector<N> operator|(const fixed_bitvector<N>& _bv, const const_bitrow& _r)
+{
+	return _r | _bv;
+}
+
+// Print in the same way as a bitvector, i.e., from the last bit to the first one
+template<size_type N>
+inline
+std::ostream& operator<<(std::ostream& os, const fixed_bitvector<N>& _bv)
+{
+	return os << const_bitrow(_bv);
+}
+
+} // namespace argumatrix
+#endif
@@ -0,0 +1,234 @@
+#ifndef SPARSE_MATRIX_HPP
+#define SPARSE_MATRIX_HPP
+
+#include <assert.h>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <iostream>
+
+#include "config/config.hpp"
+#include "bitvector.hpp"
+#include "bitmatrix.hpp"
+
+
+namespace argumatrix {  // argumatrix
+using namespace std;
+
+/**
+ * @brief A sparse Boolean matrix, which stores the positions of its 1's both
+ * row by row (compressed sparse row, CSR) and column by column (compressed
+ * sparse column, CSC). The memory is O(R+C+nnz) instead of O(R*C) bits of a
+ * bitmatrix, and the multiplication with a bitvector S costs O(|S| + the 1's
+ * in the columns of S), which makes it the better choice for the large and
+ * sparse attack matrices. The indices of each row (and of each column) are
+ * sorted in ascending order.
+ */
+class sparsematrix {
+public:
+	typedef unsigned int index_type;
+	typedef const index_type* const_iterator;
+
+	sparsematrix(): m_nRow(0), m_nColumn(0), m_rowPtr(1, 0), m_colPtr(1, 0) {}
+
+	/**
+	 * @brief Build a sparse matrix from a list of its 1's. Duplicated entries
+	 * are allowed and are stored once.
+	 * @param num_rows, num_columns the size of the matrix.
+	 * @param entries the (row, column) pairs of the 1's.
+	 */
+	sparsematrix(size_type num_rows, size_type num_columns,
+		const vector< pair<size_type, size_type> >& entries);
+
+	// Build a sparse matrix from a dense one
+	explicit sparsematrix(const bitmatrix& _bm);
+
+	size_type sizeR() const { return m_nRow; }
+	size_type sizeC() const { return m_nColumn; }
+	// The number of 1's
+	size_type nnz() const { return m_rowIdx.size(); }
+	// The ratio of 1's, nnz/(R*C)
+	double density() const;
+
+	// The columns of the 1's in the i-th row
+	const_iterator row_begin(size_type i) const { return m_rowIdx.data() + m_rowPtr[i]; }
+	const_iterator row_end(size_type i) const { return m_rowIdx.data() + m_rowPtr[i+1]; }
+	size_type row_count(size_type i) const { return m_rowPtr[i+1] - m_rowPtr[i]; }
+
+	// The rows of the 1's in the j-th column
+	const_iterator col_begin(size_type j) const { return m_colIdx.data() + m_colPtr[j]; }
+	const_iterator col_end(size_type j) const { return m_colIdx.data() + m_colPtr[j+1]; }
+	size_type col_count(size_type j) const { return m_colPtr[j+1] - m_colPtr[j]; }
+
+	// The entry (i,j)
+	bool test(size_type i, size_type j) const;
+
+	// Get a copy of the i-th row
+	bitvector getBitvector(size_type i) const;
+
+	/**
+	 * @brief The multiplication of a sparse matrix and a bitvector, which has
+	 * the same result as bitmatrix::operator*(). The columns of the 1's of _bv
+	 * are scanned, so the cost is proportional to the 1's of these columns.
+	 * @param _bv a bitvector of size sizeC().
+	 * @return a bitvector of size sizeR().
+	 */
+	bitvector operator*(const bitvector& _bv) const;
+
+	// The transpose only swaps the CSR and the CSC parts
+	sparsematrix transpose() const;
+
+	bitvector diag() const;
+
+	bitmatrix toBitmatrix() const;
+
+	void show() const;
+
+private:
+	size_type m_nRow;
+	size_type m_nColumn;
+	vector<size_type> m_rowPtr;   // The 1's of row i are m_rowIdx[m_rowPtr[i]..m_rowPtr[i+1])
+	vector<index_type> m_rowIdx;
+	vector<size_type> m_colPtr;   // The 1's of column j are m_colIdx[m_colPtr[j]..m_colPtr[j+1])
+	vector<index_type> m_colIdx;
+};
+
+
+sparsematrix::sparsematrix(size_type num_rows, size_type num_columns,
+	const vector< pair<size_type, size_type> >& entries)
+	:m_nRow(num_rows),
+	 m_nColumn(num_columns),
+	 m_rowPtr(num_rows+1, 0),
+	 m_colPtr(num_columns+1, 0)
+{
+	// Sort the entries by (row, column) and remove the duplicated ones
+	vector< pair<size_type, size_type> > _ent(entries);
+	std::sort(_ent.begin(), _ent.end());
+	_ent.erase(std::unique(_ent.begin(), _ent.end()), _ent.end());
+
+	m_rowIdx.resize(_ent.size());
+	m_colIdx.resize(_ent.size());
+
+	for (size_type k = 0; k < _ent.size(); ++k) {
+		assert(_ent[k].first < m_nRow && _ent[k].second < m_nColumn);
+		++m_rowPtr[_ent[k].first + 1];
+		++m_colPtr[_ent[k].second + 1];
+		m_rowIdx[k] = (index_type)_ent[k].second;
+	}
+	for (size_type i = 0; i < m_nRow; ++i)
+		m_rowPtr[i+1] += m_rowPtr[i];
+	for (size_type j = 0; j < m_nColumn; ++j)
+		m_colPtr[j+1] += m_colPtr[j];
+
+	// The entries are sorted by rows, so the rows of each column are sorted
+	vector<size_type> _pos(m_colPtr.begin(), m_colPtr.end() - 1);
+	for (size_type k = 0; k < _ent.size(); ++k)
+		m_colIdx[ _pos[_ent[k].second]++ ] = (index_type)_ent[k].first;
+}
+
+sparsematrix::sparsematrix(const bitmatrix& _bm)
+	:m_nRow(_bm.sizeR()),
+	 m_nColumn(_bm.sizeC()),
+	 m_rowPtr(_bm.sizeR()+1, 0),
+	 m_colPtr(_bm.sizeC()+1, 0)
+{
+	for (size_type i = 0; i < m_nRow; ++i) {
+		const_bitrow _row = _bm[i];
+		for (size_type j = _row.find_first(); j != bitvector::npos; j = _row.find_next(j)) {
+			m_rowIdx.push_back((index_type)j);
+			++m_colPtr[j+1];
+		}
+		m_rowPtr[i+1] = m_rowIdx.size();
+	}
+	for (size_type j = 0; j < m_nColumn; ++j)
+		m_colPtr[j+1] += m_colPtr[j];
+
+	m_colIdx.resize(m_rowIdx.size());
+	vector<size_type> _pos(m_colPtr.begin(), m_colPtr.end() - 1);
+	for (size_type i = 0; i < m_nRow; ++i)
+		for (size_type k = m_rowPtr[i]; k < m_rowPtr[i+1]; ++k)
+			m_colIdx[ _pos[m_rowIdx[k]]++ ] = (index_type)i;
+}
+
+inline
+double sparsematrix::density() const
+{
+	if (m_nRow == 0 || m_nColumn == 0)
+		return 0.0;
+	return (double)nnz() / ((double)m_nRow * (double)m_nColumn);
+}
+
+inline
+bool sparsematrix::test(size_type i, size_type j) const
+{
+	assert(i < m_nRow && j < m_nColumn);
+	return std::binary_search(row_begin(i), row_end(i), (index_type)j);
+}
+
+inline
+bitvector sparsematrix::getBitvector(size_type i) const
+{
+	bitvector _bv(m_nColumn);
+	for (const_iterator it = row_begin(i); it != row_end(i); ++it)
+		_bv.set(*it);
+	return _bv;
+}
+
+bitvector sparsematrix::operator*(const bitvector& _bv) const
+{
+	assert(_bv.size() == m_nColumn);
+	bitvector _res(m_nRow);
+
+	const size_type _bpb = bitvector::bits_per_block;
+	block_type* _out = _res.blocks();
+
+	for (size_type j = _bv.find_first(); j != bitvector::npos; j = _bv.find_next(j)) {
+		for (const_iterator it = col_begin(j), _end = col_end(j); it != _end; ++it)
+			_out[*it / _bpb] |= block_type(1) << (*it % _bpb);
+	}
+
+	return _res;
+}
+
+sparsematrix sparsematrix::transpose() const
+{
+	sparsematrix _sm;
+	_sm.m_nRow = m_nColumn;
+	_sm.m_nColumn = m_nRow;
+	_sm.m_rowPtr = m_colPtr;
+	_sm.m_rowIdx = m_colIdx;
+	_sm.m_colPtr = m_rowPtr;
+	_sm.m_colIdx = m_rowIdx;
+	return _sm;
+}
+
+bitvector sparsematrix::diag() const
+{
+	size_type _sz = min(m_nRow, m_nColumn);
+	bitvector _bv(_sz);
+
+	for (size_type i = 0; i < _sz; ++i)
+		if (test(i, i)) _bv.set(i);
+
+	return _bv;
+}
+
+bitmatrix sparsematrix::toBitmatrix() const
+{
+	bitmatrix _bm(m_nRow, m_nColumn);
+	for (size_type i = 0; i < m_nRow; ++i) {
+		bitrow _row = _bm[i];
+		for (const_iterator it = row_begin(i); it != row_end(i); ++it)
+			_row.set(*it);
+	}
+	return _bm;
+}
+
+void sparsematrix::show() const
+{
+	for (size_type i = 0; i < m_nRow; ++i)
+		std::cout << getBitvector(i) << std::endl;
+}
+
+} // namespace argumatrix
+#endif
@@ -35,6 +35,20 @@ const std::string STR_YES = "YES";
 // const std::string STR_NO = "NO";
 const std::string STR_NO = "NO";
 
+// The density of attacks (|R|/n^2) under which a reasoner stores the attack
+// matrix in sparse form only. A dense row product costs n/64 block operations
+// while a sparse one costs the number of attackers, so the sparse form wins
+// once an argument has fewer than n/64 attackers on average.
+const double SPARSE_DENSITY_THRESHOLD = 1.0/64;
+
+// The maximal number of the nodes of a BddManager (about 20 bytes each with
+// the unique table). The BDDs of a model may grow exponentially with the
+// number of arguments, and the solver stops with an error beyond this limit.
+const unsigned int BDD_MAX_NODES = 1u << 25;
+
+// The bytes buffered by an ExtensionWriter before they are written at once.
+const size_type OUTPUT_BUFFER_SIZE = 1 << 20;
+
 namespace argumatrix{
 using namespace std;
 
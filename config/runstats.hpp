@@ -0,0 +1,250 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// The counters and the timers of a run
+//=======================================================================
+
+#ifndef ARGUMATRIX_RUN_STATS_HPP
+#define ARGUMATRIX_RUN_STATS_HPP
+
+#include <iostream>
+#include <atomic>
+#include <stdint.h>
+
+#include "cptimer.hpp"
+
+#if defined(_WIN32)
+#  include <psapi.h>
+#  pragma comment(lib, "psapi.lib")
+#else
+#  include <sys/resource.h>
+#endif
+
+
+namespace argumatrix{
+
+using namespace std;
+
+// The time spent in the phases of a run
+enum StatTimer {
+	TIMER_PARSE,          /**< Reading the framework */
+	TIMER_ATTACK_MATRIX,  /**< DungAF::getAttackMatrix() and getSparseAttackMatrix() */
+	TIMER_TERM_BUILD,     /**< Building the Prolog matrix terms */
+	TIMER_SOLVE,          /**< Answering the tasks, with their output */
+	TIMER_NUM
+};
+
+// The events of a run
+enum StatCounter {
+	COUNTER_GROUNDED_ITERATIONS,  /**< The IN arguments propagated by groundedLabelling() */
+	COUNTER_TERM_CELLS,           /**< The cells of the Prolog matrix terms */
+	COUNTER_NEXT_SOLUTION,        /**< The calls of next_solution() on a Prolog query */
+	COUNTER_LABELING_SOLUTIONS,   /**< The solutions enumerated by the constraint models */
+	COUNTER_NUM
+};
+
+// The peaks sampled during a run
+enum StatGauge {
+	GAUGE_PL_GLOBAL_USED,  /**< The bytes of the global stack of SWI-Prolog */
+	GAUGE_PL_LOCAL_USED,   /**< The bytes of the local stack of SWI-Prolog */
+	GAUGE_PL_TRAIL_USED,   /**< The bytes of the trail stack of SWI-Prolog */
+	GAUGE_NUM
+};
+
+/**
+ * @brief The counters and the timers of the run of the process, reported by
+ * the -t and -stats options of argmat-clpb. They are recorded only after
+ * enable(), so that the hot paths pay one test of a flag otherwise. The hot
+ * loops count into a local variable and add it once, e.g.,
+ * ~~~~~{.cpp}
+ *   StatTimerScope _timer(TIMER_PARSE);  // Adds the time of the scope
+ *   ...
+ *   RunStats::instance().count(COUNTER_GROUNDED_ITERATIONS, _iters);
+ * ~~~~~
+ * The counters are atomic, and may be recorded by several threads.
+ */
+class RunStats {
+public:
+	static RunStats& instance();
+
+	// Start recording, the total time is counted from here
+	void enable();
+	bool enabled() const { return m_enabled; }
+
+	void count(StatCounter c, uint64_t n = 1)
+	{
+		if (m_enabled)
+			m_counters[c].fetch_add(n, std::memory_order_relaxed);
+	}
+
+	void addTime(StatTimer t, uint64_t ns)
+	{
+		if (m_enabled)
+			m_timers[t].fetch_add(ns, std::memory_order_relaxed);
+	}
+
+	// Keep the maximum of the samples v of the gauge g
+	void peak(StatGauge g, uint64_t v);
+
+	uint64_t getCounter(StatCounter c) const { return m_counters[c].load(); }
+	uint64_t getTime(StatTimer t) const { return m_timers[t].load(); }
+	uint64_t getGauge(StatGauge g) const { return m_gauges[g].load(); }
+
+	// The peak resident set size of the process in bytes, 0 if unknown
+	static uint64_t peakRss();
+
+	/**
+	 * @brief Print the statistics in one line of JSON, e.g.,
+	 * {"parse_ns":1200,...,"peak_rss_bytes":5242880}
+	 */
+	void printJson(std::ostream& os) const;
+
+	// Print the statistics, one per line
+	void printText(std::ostream& os) const;
+
+private:
+	RunStats();
+
+	// Not copyable
+	RunStats(const RunStats&);
+	RunStats& operator=(const RunStats&);
+
+	// The names of the statistics, as the keys of printJson()
+	static const char* timerName(StatTimer t);
+	static const char* counterName(StatCounter c);
+	static const char* gaugeName(StatGauge g);
+
+	bool m_enabled;
+	uint64_t m_start;
+	std::atomic<uint64_t> m_timers[TIMER_NUM];
+	std::atomic<uint64_t> m_counters[COUNTER_NUM];
+	std::atomic<uint64_t> m_gauges[GAUGE_NUM];
+};
+
+/**
+ * @brief Add the time of a scope to a timer of the RunStats.
+ */
+class StatTimerScope {
+public:
+	explicit StatTimerScope(StatTimer t):
+		m_timer(t), m_bgn(RunStats::instance().enabled() ? clock_ns() : 0) {}
+	~StatTimerScope()
+	{
+		if (m_bgn != 0)
+			RunStats::instance().addTime(m_timer, clock_ns() - m_bgn);
+	}
+
+private:
+	StatTimerScope(const StatTimerScope&);
+	StatTimerScope& operator=(const StatTimerScope&);
+
+	StatTimer m_timer;
+	uint64_t m_bgn;
+};
+
+
+RunStats& RunStats::instance()
+{
+	static RunStats _stats;
+	return _stats;
+}
+
+RunStats::RunStats():
+	m_enabled(false),
+	m_start(0)
+{
+	for (int t = 0; t < TIMER_NUM; ++t)
+		m_timers[t] = 0;
+	for (int c = 0; c < COUNTER_NUM; ++c)
+		m_counters[c] = 0;
+	for (int g = 0; g < GAUGE_NUM; ++g)
+		m_gauges[g] = 0;
+}
+
+void RunStats::enable()
+{
+	if (!m_enabled)
+		m_start = clock_ns();
+	m_enabled = true;
+}
+
+void RunStats::peak(StatGauge g, uint64_t v)
+{
+	if (!m_enabled)
+		return;
+	uint64_t _old = m_gauges[g].load();
+	while (_old < v && !m_gauges[g].compare_exchange_weak(_old, v))
+		;
+}
+
+uint64_t RunStats::peakRss()
+{
+#if defined(_WIN32)
+	PROCESS_MEMORY_COUNTERS _pmc;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &_pmc, sizeof(_pmc)))
+		return (uint64_t)_pmc.PeakWorkingSetSize;
+	return 0;
+#else
+	struct rusage _usage;
+	if (getrusage(RUSAGE_SELF, &_usage) != 0)
+		return 0;
+#  if defined(__APPLE__)
+	return (uint64_t)_usage.ru_maxrss;          // In bytes
+#  else
+	return (uint64_t)_usage.ru_maxrss * 1024;   // In kilobytes
+#  endif
+#endif
+}
+
+const char* RunStats::timerName(StatTimer t)
+{
+	static const char* _names[TIMER_NUM] = {
+		"parse_ns", "attack_matrix_ns", "term_build_ns", "solve_ns"
+	};
+	return _names[t];
+}
+
+const char* RunStats::counterName(StatCounter c)
+{
+	static const char* _names[COUNTER_NUM] = {
+		"grounded_iterations", "term_cells", "next_solution_calls", "labeling_solutions"
+	};
+	return _names[c];
+}
+
+const char* RunStats::gaugeName(StatGauge g)
+{
+	static const char* _names[GAUGE_NUM] = {
+		"pl_global_used_bytes", "pl_local_used_bytes", "pl_trail_used_bytes"
+	};
+	return _names[g];
+}
+
+void RunStats::printJson(std::ostream& os) const
+{
+	os << "{\"total_ns\":" << (m_enabled ? clock_ns() - m_start : 0);
+	for (int t = 0; t < TIMER_NUM; ++t)
+		os << ",\"" << timerName((StatTimer)t) << "\":" << getTime((StatTimer)t);
+	for (int c = 0; c < COUNTER_NUM; ++c)
+		os << ",\"" << counterName((StatCounter)c) << "\":" << getCounter((StatCounter)c);
+	for (int g = 0; g < GAUGE_NUM; ++g)
+		os << ",\"" << gaugeName((StatGauge)g) << "\":" << getGauge((StatGauge)g);
+	os << ",\"peak_rss_bytes\":" << peakRss() << "}" << endl;
+}
+
+void RunStats::printText(std::ostream& os) const
+{
+	os << "total_ns: " << (m_enabled ? clock_ns() - m_start : 0) << endl;
+	for (int t = 0; t < TIMER_NUM; ++t)
+		os << timerName((StatTimer)t) << ": " << getTime((StatTimer)t) << endl;
+	for (int c = 0; c < COUNTER_NUM; ++c)
+		os << counterName((StatCounter)c) << ": " << getCounter((StatCounter)c) << endl;
+	for (int g = 0; g < GAUGE_NUM; ++g)
+		os << gaugeName((StatGauge)g) << ": " << getGauge((StatGauge)g) << endl;
+	os << "peak_rss_bytes: " << peakRss() << endl;
+}
+
+} // namespace argumatrix
+
+#endif  // ARGUMATRIX_RUN_STATS_HPP
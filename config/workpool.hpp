@@ -0,0 +1,271 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// A work-stealing thread pool for the recursive searches
+//=======================================================================
+
+#ifndef ARGUMATRIX_WORK_POOL_HPP
+#define ARGUMATRIX_WORK_POOL_HPP
+
+#include <deque>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+
+#include "config.hpp"
+
+namespace argumatrix{
+
+/**
+ * @brief A work-stealing thread pool for recursive searches. Each participant
+ * owns a deque of tasks: it pushes and pops its own tasks at the back (depth
+ * first, like a recursion), and when its deque is empty it steals the oldest
+ * task at the front of another deque, which is usually the largest subtree.
+ * The thread calling wait() takes part in the work as the participant 0, so a
+ * pool of size N starts N-1 threads. The participants without work sleep on
+ * a condition variable, woken up when a task is submitted, and wait() when
+ * the last task is done. If a task throws, the tasks not started yet are
+ * dropped, and wait() rethrows the first exception.
+ * ~~~~~{.cpp}
+ *   WorkStealingPool pool(8);
+ *   pool.submit(root_task);  // tasks may submit further tasks
+ *   pool.wait();             // returns when all tasks are done
+ * ~~~~~
+ */
+class WorkStealingPool {
+public:
+	typedef std::function<void()> task_type;
+
+	explicit WorkStealingPool(size_type num_threads);
+	~WorkStealingPool();
+
+	/**
+	 * @brief Add a task. Called inside a task, the task goes to the deque of
+	 * the calling participant; otherwise it goes to the deque 0.
+	 */
+	void submit(const task_type& task);
+
+	/**
+	 * @brief Run the tasks in the calling thread until all the submitted tasks
+	 * (and the tasks they submit) are done. The first exception thrown by a
+	 * task is rethrown here.
+	 */
+	void wait();
+
+	// The number of participants
+	size_type size() const { return m_queues.size(); }
+
+	/**
+	 * @brief Whether some participant is waiting for work. The producers use
+	 * it to decide whether a branch is worth a task, or should rather be run
+	 * in place.
+	 */
+	bool hungry() const { return m_idle.load(std::memory_order_relaxed) > 0; }
+
+private:
+	struct TaskQueue {
+		std::mutex mtx;
+		std::deque<task_type> tasks;
+	};
+
+	// The participant index of the calling thread in this pool, or npos
+	size_type self() const;
+
+	bool pop(size_type id, task_type& task);
+	bool steal(size_type id, task_type& task);
+	// Run one task if any, return false if none was found
+	bool runOne(size_type id);
+	void workerLoop(size_type id);
+
+	// Sleep until the predicate holds, and count the caller as idle meanwhile
+	template<typename Predicate>
+	void sleep(Predicate pred);
+
+	static const WorkStealingPool*& tlsPool() { static thread_local const WorkStealingPool* p = NULL; return p; }
+	static size_type& tlsId() { static thread_local size_type id = 0; return id; }
+
+	std::vector<TaskQueue*> m_queues;
+	std::vector<std::thread> m_threads;
+	std::atomic<size_type> m_pending;  /**< The submitted tasks not finished yet */
+	std::atomic<size_type> m_queued;   /**< The tasks in the deques */
+	std::atomic<size_type> m_idle;     /**< The participants looking for work */
+	std::atomic<bool> m_stop;
+	std::atomic<bool> m_failed;        /**< Whether a task has thrown */
+	std::exception_ptr m_error;        /**< The first exception of a task */
+	std::mutex m_sleepMtx;             /**< Protect m_error, and the sleeps */
+	std::condition_variable m_sleepCv;
+};
+
+
+WorkStealingPool::WorkStealingPool(size_type num_threads):
+	m_pending(0), m_queued(0), m_idle(0), m_stop(false), m_failed(false)
+{
+	if (num_threads < 1)
+		num_threads = 1;
+
+	for (size_type i = 0; i < num_threads; ++i)
+		m_queues.push_back(new TaskQueue());
+
+	for (size_type i = 1; i < num_threads; ++i)
+		m_threads.push_back(std::thread(&WorkStealingPool::workerLoop, this, i));
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+	{
+		std::lock_guard<std::mutex> _lock(m_sleepMtx);
+		m_stop = true;
+	}
+	m_sleepCv.notify_all();
+	for (size_type i = 0; i < m_threads.size(); ++i)
+		m_threads[i].join();
+	for (size_type i = 0; i < m_queues.size(); ++i)
+		delete m_queues[i];
+}
+
+inline
+size_type WorkStealingPool::self() const
+{
+	return tlsPool() == this ? tlsId() : size_type(-1);
+}
+
+void WorkStealingPool::submit(const task_type& task)
+{
+	size_type id = self();
+	if (id == size_type(-1))
+		id = 0;
+
+	++m_pending;
+	{
+		std::lock_guard<std::mutex> _lock(m_queues[id]->mtx);
+		m_queues[id]->tasks.push_back(task);
+		++m_queued;
+	}
+
+	// A sleeper checks m_queued under m_sleepMtx after counting itself idle,
+	// so that taking the lock here orders the notification after its check
+	if (m_idle.load() > 0) {
+		{ std::lock_guard<std::mutex> _lock(m_sleepMtx); }
+		m_sleepCv.notify_one();
+	}
+}
+
+bool WorkStealingPool::pop(size_type id, task_type& task)
+{
+	TaskQueue& q = *m_queues[id];
+	std::lock_guard<std::mutex> _lock(q.mtx);
+	if (q.tasks.empty())
+		return false;
+
+	task = q.tasks.back();
+	q.tasks.pop_back();
+	--m_queued;
+	return true;
+}
+
+bool WorkStealingPool::steal(size_type id, task_type& task)
+{
+	const size_type n = m_queues.size();
+	for (size_type k = 1; k < n; ++k) {
+		TaskQueue& q = *m_queues[(id + k) % n];
+		std::lock_guard<std::mutex> _lock(q.mtx);
+		if (!q.tasks.empty()) {
+			task = q.tasks.front();
+			q.tasks.pop_front();
+			--m_queued;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool WorkStealingPool::runOne(size_type id)
+{
+	task_type task;
+	if (!pop(id, task) && !steal(id, task))
+		return false;
+
+	// After a failure, the remaining tasks are only counted down
+	if (!m_failed) {
+		try {
+			task();
+		} catch (...) {
+			std::lock_guard<std::mutex> _lock(m_sleepMtx);
+			if (!m_failed) {
+				m_error = std::current_exception();
+				m_failed = true;
+			}
+		}
+	}
+
+	if (--m_pending == 0) {
+		{ std::lock_guard<std::mutex> _lock(m_sleepMtx); }
+		m_sleepCv.notify_all();
+	}
+	return true;
+}
+
+template<typename Predicate>
+void WorkStealingPool::sleep(Predicate pred)
+{
+	++m_idle;
+	{
+		std::unique_lock<std::mutex> _lock(m_sleepMtx);
+		m_sleepCv.wait(_lock, pred);
+	}
+	--m_idle;
+}
+
+void WorkStealingPool::workerLoop(size_type id)
+{
+	tlsPool() = this;
+	tlsId() = id;
+
+	while (!m_stop) {
+		if (runOne(id))
+			continue;
+
+		// Nothing to do, sleep until a task is submitted
+		sleep([this]() { return m_stop || m_queued > 0; });
+	}
+}
+
+void WorkStealingPool::wait()
+{
+	const WorkStealingPool* _oldPool = tlsPool();
+	size_type _oldId = tlsId();
+	tlsPool() = this;
+	tlsId() = 0;
+
+	while (m_pending > 0) {
+		if (runOne(0))
+			continue;
+
+		// The other tasks are running, sleep until one of them submits a
+		// task, or the last one is done
+		sleep([this]() { return m_queued > 0 || m_pending == 0; });
+	}
+
+	tlsPool() = _oldPool;
+	tlsId() = _oldId;
+
+	if (m_failed) {
+		std::exception_ptr _error;
+		{
+			std::lock_guard<std::mutex> _lock(m_sleepMtx);
+			_error = m_error;
+			m_error = std::exception_ptr();
+			m_failed = false;
+		}
+		std::rethrow_exception(_error);
+	}
+}
+
+} // namespace argumatrix
+
+#endif // ARGUMATRIX_WORK_POOL_HPP
@@ -1,60 +1,31 @@
 //=======================================================================
 // Copyright 2015 Tsinghua University.
 // Authors: Fuan Pu (Pu.Fuan@gmail.com)
-// 
+//
 // Dung's abstract argumentation framework
 //=======================================================================
 
 #ifndef DUNG_ARGUMENTATION_FRAMEWORK_HPP
 #define DUNG_ARGUMENTATION_FRAMEWORK_HPP
 
-//boost
-#include <boost/config.hpp>
-//#include <boost/graph/graph_traits.hpp> 
-#include <boost/graph/adjacency_list.hpp>
-#include <boost/graph/iteration_macros.hpp>
-//#include <boost/graph/named_graph.hpp> 
-//#include <boost/property_map/property_map.hpp>
-
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
 #include <iostream>
 #include <string>
-#include <utility>   
-#include <algorithm>   
+#include <vector>
+#include <set>
+#include <utility>
+#include <algorithm>
+#include <atomic>
 
 #include "config/config.hpp"
+#include "config/runstats.hpp"
 #include "ArgumentProperty.hpp"
 #include "AttackProperty.hpp"
 #include "bitmatrix/bitvector.hpp"
 #include "bitmatrix/bitmatrix.hpp"
-
-
-/************************************************************************/
-/* Use the label of ArgumentProperty as a key for indexing Arguments    */
-/* in a graph. This approach is referred from:                          */
-/* [Named vertices](http://svn.boost.org/svn/boost/trunk/libs/graph/test/named_vertices_test.cpp) */
-/* and [Name Graph](http://www.boost.org/doc/libs/1_49_0/boost/graph/named_graph.hpp) */ 
-/************************************************************************/
-namespace boost{
-	namespace graph {
-
-		/// Use the label of ArgumentProperty as a key for indexing Arguments in a graph
-		template<>
-		struct internal_vertex_name<argumatrix::ArgumentProperty>
-		{
-			typedef multi_index::member<argumatrix::ArgumentProperty, 
-				std::string, &argumatrix::ArgumentProperty::label> type;
-		};
-
-		/// Allow the graph to build Arguments given only their labels (filling in
-		/// the defaults for fields).
-		template<>
-		struct internal_vertex_constructor<argumatrix::ArgumentProperty>
-		{
-			typedef vertex_from_name<argumatrix::ArgumentProperty> type;
-		};
-	} // end namespace boost::graph
-}  // end namespace boost
-
+#include "bitmatrix/sparsematrix.hpp"
 
 
 namespace argumatrix{
@@ -62,84 +33,135 @@ namespace argumatrix{
 using namespace std;
 using namespace boost;
 
+// The definition of the argument, i.e., its index. The i-th added argument is i.
+typedef unsigned int Argument;
+
+// The definition of the attack relation, i.e., its index in the order of addition.
+typedef unsigned int Attack;
+
 /**
-* An abstract argumentation framework is a directed graph, called Argument Graph.
-* Here, we use the boost graph to define the argument graph. 
-*   typedef adjacency_list
-*   < setS, // edge container
-*   vecS, // vertex container
-*   undirectedS,
-*   boost::no_property,  // vertex property
-*   boost::no_property // edge property
-*   > graph;
-*/
-typedef boost::adjacency_list<boost::listS, boost::vecS,
-	boost::directedS, ArgumentProperty, AttackProperty> ArgumentGraph;
+ * @brief Notified of the changes of a DungAF, after they are done, e.g., to
+ * maintain the labelling of a semantics incrementally (see
+ * IncrementalGrounded). An observer is registered by
+ * DungAF::addObserver(), and is not copied with the framework.
+ */
+class DungAFObserver {
+public:
+	virtual ~DungAFObserver() {}
 
-// The definition of the argument (descriptor)
-typedef boost::graph_traits<ArgumentGraph>::vertex_descriptor Argument;
+	// The argument _arg is added
+	virtual void argumentAdded(Argument _arg) = 0;
 
-// The definition of the attack relation (descriptor)
-typedef boost::graph_traits<ArgumentGraph>::edge_descriptor Attack;
+	// An attack from _arg1 to _arg2 is added
+	virtual void attackAdded(Argument _arg1, Argument _arg2) = 0;
 
-// Iterators
-typedef boost::graph_traits<ArgumentGraph>::vertex_iterator ArgumentIterator;
-typedef boost::graph_traits<ArgumentGraph>::edge_iterator AttackIterator;
-typedef boost::graph_traits<ArgumentGraph>::adjacency_iterator AdjacencyIterator;
-typedef boost::graph_traits<ArgumentGraph>::out_edge_iterator OutEdgeIterator;
+	// All the attacks from _arg1 to _arg2 are removed
+	virtual void attackRemoved(Argument _arg1, Argument _arg2) = 0;
+
+	/**
+	 * The argument _arg and all its attacks are removed, and the argument
+	 * formerly indexed by _moved (the last one) is now indexed by _arg,
+	 * unless _moved == _arg.
+	 */
+	virtual void argumentRemoved(Argument _arg, Argument _moved) = 0;
 
-// The index property of the vertices. Using to get the index of an vertex.
-typedef boost::property_map<ArgumentGraph, boost::vertex_index_t, size_type>::type IdxMapType;
+	// All the arguments and attacks are removed
+	virtual void cleared() = 0;
+};
 
 /************************************************************************/
 /* The concepts of Dung's argumentation framework.                       */
 /************************************************************************/
+/**
+* An abstract argumentation framework is a directed graph, called Argument Graph.
+* The reasoners only work on the indices of the arguments, so the graph is
+* stored flat, with 32-bit indices:
+*   - the labels are interned in one buffer, and an open addressing hash
+*     table maps them to their indices;
+*   - the attacks are two arrays of their sources and targets;
+*   - the attacked arguments and the attackers of each argument are
+*     contiguous arrays in CSR form (see attacked_begin()), which are built
+*     from the attacks on demand;
+*   - the titles and descriptions of the arguments and the properties of the
+*     attacks are side tables, which are allocated only once some of them is
+*     not the default.
+*/
 class DungAF
 {
 public:
+	typedef const Argument* const_iterator;
+
 	DungAF();
 	~DungAF();
 
 
 	// Note that: this method just copy the properties of an argument
-	// Add a new Argument to the argument graph and copy ap into property 
-	// object for the new argument.
+	// Add a new Argument to the argument graph and copy ap into property
+	// object for the new argument. If the label is already in the graph, the
+	// existing argument is returned.
 	Argument addArgument(const ArgumentProperty& _argProp);
-	Argument addArgument(string _label, string _title="", string _description="");
+	Argument addArgument(const string& _label, const string& _title="", const string& _description="");
 
 	// Add an attack to argument graph with an AttackProperty. Here _arg1 attacks _arg2.
+	// The arguments given by the labels are added if they are not in the graph.
 	Attack addAttack(const std::string& _arg1_label, const std::string& _arg2_label, const AttackProperty& _attProp = AttackProperty());
 	Attack addAttack(const Argument& _arg1, const std::string& _arg2_label, const AttackProperty& _attProp = AttackProperty());
 	Attack addAttack(const std::string& _arg1_label, const Argument& _arg2, const AttackProperty& _attProp = AttackProperty());
 	Attack addAttack(const Argument& _arg1, const Argument& _arg2, const AttackProperty& _attProp = AttackProperty());
 	Attack addAttack(const std::pair<Argument&, Argument&>& _edge, const AttackProperty& _attProp = AttackProperty());
 
+	/**
+	 * Remove all the attacks from _arg1 to _arg2, the indices of the later
+	 * attacks are shifted down. The cost is O(|R|).
+	 * @return the number of the removed attacks.
+	 */
+	size_type removeAttack(const Argument& _arg1, const Argument& _arg2);
+
+	/**
+	 * Remove the argument _arg and all its attacks. The last argument takes
+	 * the index _arg, so that the indices stay contiguous. The cost is
+	 * O(|A|+|R|), since the labels are rehashed.
+	 */
+	void removeArgument(const Argument& _arg);
+
+	// Register an observer of the changes, which must outlive its registration
+	void addObserver(DungAFObserver* _obs);
+	void removeObserver(DungAFObserver* _obs);
+
 
 	/**
 	* Get the Property of the Argument or the Attack
-	* Note that the return value must be const since all external changes
+	* Note that the return value is a copy since all external changes
 	* on properties are not safe. Let the label of argument a is "A" and assume
-	* the returned property is not constant, for instance, if an argument b, 
+	* the returned property could be changed, for instance, if an argument b,
 	* whose label is 'B', then we can modify the label of argument b as "A", which
-	* may contradict with the restriction that each argument has a unique label. 
-	* The return value of constant may avoid this issue. We also provide a series 
-	* of methods to change the property of some argument or attack with safety-check.
-	* 
+	* may contradict with the restriction that each argument has a unique label.
+	* The properties are not stored as objects, they are assembled from the
+	* label table and the side tables.
+	*
 	* @param Argument or Attack, or the unique argument label
-	* @return no return. The results are stored in m_extensions.
+	* @return the property of the argument or the attack.
 	*/
-	const ArgumentProperty& getArgumentProperty(const Argument& _arg) const;
-	const ArgumentProperty& getArgumentProperty(const std::string& _arg_label) const;
+	ArgumentProperty getArgumentProperty(const Argument& _arg) const;
+	ArgumentProperty getArgumentProperty(const std::string& _arg_label) const;
 	size_type getArgumentIdx(const std::string& _arg_label) const;
 	size_type getArgumentIdx(const Argument& _arg) const;
-	const AttackProperty& getAttackProperty(const Attack& _atk) const;
-	
+	// Whether the label is the label of an argument, unlike getArgumentIdx(), which exits
+	bool hasArgument(const std::string& _arg_label) const;
+	AttackProperty getAttackProperty(const Attack& _atk) const;
+
 	// Get a vector of argument labels, vector[i] is the label of the argument indexed by i
 	std::vector<std::string> getArgumentLabels() const;
 
+	// Get the label of the argument indexed by _arg
+	std::string getArgumentLabel(const Argument& _arg) const;
+
 	// Clear the argument graph
 	void clear();
 
+	// Reserve the memory of num_args arguments and num_atks attacks, e.g., before loading a file
+	void reserve(size_type num_args, size_type num_atks = 0);
+
 	// Update the bit matrix when changing (of Argument and Attack) occurs
 	//void update();
 
@@ -147,7 +169,7 @@ public:
 	/**
 	 * Method:    set2bv
 	 * FullName:  argumatrix::DungAF::set2bv
-	 * Access:    public 
+	 * Access:    public
 	 * @param     const set<Argument> & sa
 	 * @return    argumatrix::bitvector
 	 */
@@ -159,25 +181,70 @@ public:
 
 	std::string toString() const;
 
+	/**
+	 * Get the attack matrix, the entry (i,j) is 1 iff the argument j attacks
+	 * the argument i. The matrix set by setAttackMatrix() is returned if the
+	 * framework has not been changed since then, otherwise it is built from
+	 * the attacks.
+	 */
 	bitmatrix getAttackMatrix() const;
 
+	/**
+	 * Keep a precomputed attack matrix of this framework, e.g., the one
+	 * embedded in a binary snapshot, so that getAttackMatrix() does not need
+	 * to rebuild it. It is dropped once an argument or an attack is added.
+	 */
+	void setAttackMatrix(bitmatrix&& _bm);
+	bool hasAttackMatrix() const { return m_hasBm; }
+
+	/**
+	 * Get the attack matrix in sparse form, built directly from the attacks
+	 * without the dense matrix. As for getAttackMatrix(), the entry (i,j) is 1
+	 * iff the argument j attacks the argument i.
+	 */
+	sparsematrix getSparseAttackMatrix() const;
+
+	/**
+	 * A stamp of the content of the framework, which changes with each change
+	 * of the framework and is unique among all the frameworks, so that the
+	 * data derived from the framework (e.g., its Prolog terms) can be cached
+	 * by it. A copy keeps the stamp of its original. The stamp is drawn by the
+	 * first call after a change, which must not run concurrently with other
+	 * calls.
+	 */
+	uint64_t getRevision() const;
+
 	size_type getNumberOfArguments() const;
 
-	void showSet(const set<Argument>& as, std::ostream& os = std::cout) const; 
+	// The number of the attacks, including the repeated ones
+	size_type getNumberOfAttacks() const { return m_atkSource.size(); }
 
 	/**
-	* Output a bitvector. A bitvector represent a set of arguments in bool 
-	* vector form. This function will output a bitvector in string, but not 
-	* the string with 0 and 1. 
+	 * The arguments attacked by _arg (the out-edges), respectively the
+	 * attackers of _arg (the in-edges), in the order of the addition of the
+	 * attacks. The arrays are built by the first call after a change of the
+	 * framework, which must not run concurrently with other calls.
+	 */
+	const_iterator attacked_begin(const Argument& _arg) const;
+	const_iterator attacked_end(const Argument& _arg) const;
+	const_iterator attackers_begin(const Argument& _arg) const;
+	const_iterator attackers_end(const Argument& _arg) const;
+
+	void showSet(const set<Argument>& as, std::ostream& os = std::cout) const;
+
+	/**
+	* Output a bitvector. A bitvector represent a set of arguments in bool
+	* vector form. This function will output a bitvector in string, but not
+	* the string with 0 and 1.
 	* @param bitvector _bv: A bitvector.
 	* @param ostream& os: The out put stream. The default value is cout.
 	* @return no return. The results are stored in m_extensions.
 	*/
-	void outputBv(const bitvector& _bv, std::ostream& os = std::cout) const; 
+	void outputBv(const bitvector& _bv, std::ostream& os = std::cout) const;
 
 	/**
-	* Output a set of bitvector set<bitvector>. We know that one bitvector 
-	* represent a set of arguments in bool vector form. Therefore, a set of bitvector 
+	* Output a set of bitvector set<bitvector>. We know that one bitvector
+	* represent a set of arguments in bool vector form. Therefore, a set of bitvector
 	* may represent a set of a set of arguments. This function will output a set
 	* of bitvector in string.
 	* @param set< bitvector >& _bv_set: A set of bitvector.
@@ -187,144 +254,335 @@ public:
 	void outputBvSet(const std::set< bitvector >& _bv_set, std::ostream& os = std::cout) const;
 
 private:
+	// The label of the argument i in the label buffer
+	const char* labelData(size_type i) const { return m_labelChars.data() + m_labelOff[i]; }
+	size_type labelSize(size_type i) const { return m_labelOff[i+1] - m_labelOff[i]; }
+
+	/**
+	 * The slot of the label [s, s+len) in m_labelTable, which holds the
+	 * index of the argument plus 1, or 0 if the label is not in the graph.
+	 */
+	size_type findSlot(const char* s, size_type len) const;
+
+	// Double m_labelTable and reinsert the arguments
+	void growLabelTable();
+
+	// Reinsert the arguments into m_labelTable of the same size
+	void rehashLabels();
+
+	// Whether _attProp is AttackProperty(), which is not stored
+	static bool isDefaultAttack(const AttackProperty& _attProp);
+
+	// Build the out/in-edge arrays from the attacks
+	void buildAdjacency() const;
+
+	// The changes of the graph drop the derived data
+	void touch() { m_hasBm = false; m_adjValid = false; m_revision = 0; }
+
 	/* Dung'a abstract argumentation framework can be seen as a direct graph.
 	 * */
-	ArgumentGraph	m_ag;
-	IdxMapType	m_idxMap;
-	//bitmatrix	m_bm;  
+	string	m_labelChars;               /**< The labels without terminators */
+	vector<size_type>	m_labelOff;     /**< The label i is [m_labelOff[i], m_labelOff[i+1]) */
+	vector<Argument>	m_labelTable;   /**< Open addressing, the index plus 1, 0 is empty */
+	vector<string>	m_titles;           /**< Empty if all the titles are "" */
+	vector<string>	m_descriptions;     /**< Empty if all the descriptions are "" */
+
+	vector<Argument>	m_atkSource;    /**< The attacker of each attack */
+	vector<Argument>	m_atkTarget;    /**< The attacked argument of each attack */
+	vector<AttackProperty>	m_atkProps; /**< Empty if all the attacks are AttackProperty() */
+
+	// The out/in-edges in CSR form, valid iff m_adjValid
+	mutable vector<Attack>	m_outPtr;
+	mutable vector<Argument>	m_outIdx;
+	mutable vector<Attack>	m_inPtr;
+	mutable vector<Argument>	m_inIdx;
+	mutable bool	m_adjValid;
+
+	bitmatrix	m_bm;     /**< The attack matrix set by setAttackMatrix() */
+	bool	m_hasBm;      /**< Whether m_bm is up to date */
+	mutable uint64_t	m_revision;  /**< See getRevision(), 0 if not drawn yet */
+
+	// The observers, which are not copied with the framework
+	struct ObserverList {
+		vector<DungAFObserver*> list;
+		ObserverList() {}
+		ObserverList(const ObserverList&) {}
+		ObserverList& operator=(const ObserverList&) { return *this; }
+	};
+	ObserverList	m_observers;
 }; // end DungAF
 
-DungAF::DungAF()
+DungAF::DungAF():
+	m_labelOff(1, 0),
+	m_labelTable(16, 0),
+	m_adjValid(false),
+	m_hasBm(false),
+	m_revision(0)
 {
-	m_idxMap = boost::get(boost::vertex_index, m_ag);
+
 }
 
 DungAF::~DungAF()
 {
-	
+
+}
+
+inline
+size_type DungAF::findSlot(const char* s, size_type len) const
+{
+	// FNV-1a
+	size_type _h = 2166136261u;
+	for (size_type k = 0; k < len; ++k)
+		_h = (_h ^ (unsigned char)s[k]) * 16777619u;
+
+	const size_type _mask = m_labelTable.size() - 1;
+	size_type _pos = (_h ^ (_h >> 16)) & _mask;
+	while (m_labelTable[_pos] != 0) {
+		size_type i = m_labelTable[_pos] - 1;
+		if (labelSize(i) == len && memcmp(labelData(i), s, len) == 0)
+			break;
+		_pos = (_pos + 1) & _mask;
+	}
+	return _pos;
+}
+
+void DungAF::growLabelTable()
+{
+	m_labelTable.resize(m_labelTable.size() * 2);
+	rehashLabels();
+}
+
+void DungAF::rehashLabels()
+{
+	m_labelTable.assign(m_labelTable.size(), 0);
+	for (size_type i = 0; i < getNumberOfArguments(); ++i) {
+		m_labelTable[findSlot(labelData(i), labelSize(i))] = (Argument)(i + 1);
+	}
+}
+
+inline
+bool DungAF::isDefaultAttack(const AttackProperty& _attProp)
+{
+	return _attProp.getWeight() == 0 && _attProp.getLabel() == "no_label";
 }
 
 __inline
 Argument DungAF::addArgument(const ArgumentProperty& _ap)
 {
-	return boost::add_vertex(_ap, m_ag);
+	return addArgument(_ap.label, _ap.title, _ap.description);
 }
 
 __inline
-Argument DungAF::addArgument(string _label, string _title/*=""*/, string _description/*=""*/)
+Argument DungAF::addArgument(const string& _label, const string& _title/*=""*/, const string& _description/*=""*/)
 {
-	//// Approach 1
-	//Argument arg = boost::add_vertex( _label, m_ag );
-	//ArgumentProperty& _ap = m_ag[arg];
-	//_ap.description = _description;
-	//_ap.title = _title;
-
-	//return arg;
+	size_type _slot = findSlot(_label.data(), _label.size());
+	if (m_labelTable[_slot] != 0)   // The label is already in the graph
+		return m_labelTable[_slot] - 1;
+
+	touch();
+	Argument _arg = (Argument)getNumberOfArguments();
+	m_labelChars += _label;
+	m_labelOff.push_back(m_labelChars.size());
+	m_labelTable[_slot] = _arg + 1;
+
+	if (!_title.empty() || !m_titles.empty()) {
+		m_titles.resize(_arg);
+		m_titles.push_back(_title);
+	}
+	if (!_description.empty() || !m_descriptions.empty()) {
+		m_descriptions.resize(_arg);
+		m_descriptions.push_back(_description);
+	}
 
-	// This approach maybe more efficient.
-	// Argument arg = boost::add_vertex(m_ag);
-	// ArgumentProperty& _ap = m_ag[arg];
-	// _ap.setLabel(_attack_label);
-	// _ap.setTitle(_title);
-	// _ap.setDescription(_description);
+	// Keep the load factor under 1/2
+	if (2 * getNumberOfArguments() > m_labelTable.size())
+		growLabelTable();
 
-	//return arg;
+	for (size_type k = 0; k < m_observers.list.size(); ++k)
+		m_observers.list[k]->argumentAdded(_arg);
 
-	// Approch 3 
-	ArgumentProperty _ap(_label, _title, _description);
-	return addArgument(_ap);
+	return _arg;
 }
 
 __inline
 Attack DungAF::addAttack(const std::pair<Argument&, Argument&>& _edge,
 			             const AttackProperty& _attProp /*= AttackProperty()*/)
 {
-	Attack atk;
-	bool  inserted = false;
-	boost::tie(atk, inserted) = boost::add_edge(_edge.first, _edge.second, _attProp, m_ag);
-
-	assert(inserted);  // Was this attack inserted?
-
-	return atk;
+	return addAttack(_edge.first, _edge.second, _attProp);
 }
 
 __inline
 Attack DungAF::addAttack(const Argument& _arg1, const std::string& _arg2_label,
 						 const AttackProperty& _attProp /*= AttackProperty()*/)
 {
-	Attack atk;
-	bool  inserted = false;
-	boost::tie(atk, inserted) = add_edge(_arg1, _arg2_label, _attProp, m_ag);
-
-	assert(inserted);  // Was this attack inserted?
-
-	return atk;
+	return addAttack(_arg1, addArgument(_arg2_label), _attProp);
 }
 
 __inline
 Attack DungAF::addAttack(const std::string& _arg1_label, const Argument& _arg2,
 						 const AttackProperty& _attProp /*= AttackProperty()*/)
 {
-	Attack atk;
-	bool  inserted = false;
-	boost::tie(atk, inserted) = add_edge(_arg1_label, _arg2, _attProp, m_ag);
-
-	assert(inserted);  // Was this attack inserted?
-
-	return atk;
+	return addAttack(addArgument(_arg1_label), _arg2, _attProp);
 }
 
 __inline
-Attack DungAF::addAttack(const Argument& _arg1, const Argument& _arg2, 
+Attack DungAF::addAttack(const Argument& _arg1, const Argument& _arg2,
 						 const AttackProperty& _attProp /*= AttackProperty()*/)
 {
-	Attack atk;
-	bool  inserted = false;
-	boost::tie(atk, inserted) = boost::add_edge(_arg1, _arg2, _attProp, m_ag);
+	assert(_arg1 < getNumberOfArguments() && _arg2 < getNumberOfArguments());
 
-	assert(inserted);  // Was this attack inserted?
+	touch();
+	Attack _atk = (Attack)m_atkSource.size();
+	m_atkSource.push_back(_arg1);
+	m_atkTarget.push_back(_arg2);
+
+	if (!m_atkProps.empty() || !isDefaultAttack(_attProp)) {
+		m_atkProps.resize(_atk);
+		m_atkProps.push_back(_attProp);
+	}
 
-	return atk;
+	for (size_type k = 0; k < m_observers.list.size(); ++k)
+		m_observers.list[k]->attackAdded(_arg1, _arg2);
+
+	return _atk;
 }
 
 __inline
-Attack DungAF::addAttack(const std::string& _arg1_label, const std::string& _arg2_label, 
+Attack DungAF::addAttack(const std::string& _arg1_label, const std::string& _arg2_label,
 						 const AttackProperty& _attProp /*= AttackProperty()*/)
 {
-	Attack atk;
-	bool  inserted = false;
-	boost::tie(atk, inserted) = add_edge(_arg1_label, _arg2_label, _attProp, m_ag);
+	// The missing target is added before the missing source, in the same
+	// order as the former Boost named graph, so that the indices are unchanged
+	Argument _arg2 = addArgument(_arg2_label);
+	return addAttack(addArgument(_arg1_label), _arg2, _attProp);
+}
+
+size_type DungAF::removeAttack(const Argument& _arg1, const Argument& _arg2)
+{
+	const size_type m = m_atkSource.size();
+	size_type k = 0;
+	for (size_type j = 0; j < m; ++j) {
+		if (m_atkSource[j] == _arg1 && m_atkTarget[j] == _arg2)
+			continue;
+		m_atkSource[k] = m_atkSource[j];
+		m_atkTarget[k] = m_atkTarget[j];
+		if (!m_atkProps.empty())
+			m_atkProps[k] = m_atkProps[j];
+		++k;
+	}
+	if (k == m)
+		return 0;
+
+	touch();
+	m_atkSource.resize(k);
+	m_atkTarget.resize(k);
+	if (!m_atkProps.empty())
+		m_atkProps.resize(k);
 
-	assert(inserted);  // Was this attack inserted?
+	for (size_type o = 0; o < m_observers.list.size(); ++o)
+		m_observers.list[o]->attackRemoved(_arg1, _arg2);
+
+	return m - k;
+}
+
+void DungAF::removeArgument(const Argument& _arg)
+{
+	assert(_arg < getNumberOfArguments());
+
+	touch();
+	const Argument _last = (Argument)(getNumberOfArguments() - 1);
+
+	// Remove the attacks of _arg, and renumber _last as _arg
+	size_type k = 0;
+	for (size_type j = 0; j < m_atkSource.size(); ++j) {
+		if (m_atkSource[j] == _arg || m_atkTarget[j] == _arg)
+			continue;
+		m_atkSource[k] = (m_atkSource[j] == _last) ? _arg : m_atkSource[j];
+		m_atkTarget[k] = (m_atkTarget[j] == _last) ? _arg : m_atkTarget[j];
+		if (!m_atkProps.empty())
+			m_atkProps[k] = m_atkProps[j];
+		++k;
+	}
+	m_atkSource.resize(k);
+	m_atkTarget.resize(k);
+	if (!m_atkProps.empty())
+		m_atkProps.resize(k);
+
+	// Rebuild the label buffer without the label of _arg
+	string _chars;
+	vector<size_type> _off(1, 0);
+	_chars.reserve(m_labelChars.size());
+	_off.reserve(_last + 1);
+	for (Argument i = 0; i < _last; ++i) {
+		Argument _from = (i == _arg) ? _last : i;
+		_chars.append(labelData(_from), labelSize(_from));
+		_off.push_back(_chars.size());
+	}
+	m_labelChars.swap(_chars);
+	m_labelOff.swap(_off);
+	rehashLabels();
+
+	if (!m_titles.empty()) {
+		m_titles[_arg] = m_titles[_last];
+		m_titles.pop_back();
+	}
+	if (!m_descriptions.empty()) {
+		m_descriptions[_arg] = m_descriptions[_last];
+		m_descriptions.pop_back();
+	}
+
+	for (size_type o = 0; o < m_observers.list.size(); ++o)
+		m_observers.list[o]->argumentRemoved(_arg, _last);
+}
+
+__inline
+void DungAF::addObserver(DungAFObserver* _obs)
+{
+	m_observers.list.push_back(_obs);
+}
 
-	return atk;
+__inline
+void DungAF::removeObserver(DungAFObserver* _obs)
+{
+	m_observers.list.erase(std::remove(m_observers.list.begin(),
+		m_observers.list.end(), _obs), m_observers.list.end());
 }
 
 inline
-const ArgumentProperty& DungAF::getArgumentProperty(const Argument& _arg) const
+ArgumentProperty DungAF::getArgumentProperty(const Argument& _arg) const
 {
-	return m_ag[_arg];
+	assert(_arg < getNumberOfArguments());
+	return ArgumentProperty(getArgumentLabel(_arg),
+		m_titles.empty() ? string() : m_titles[_arg],
+		m_descriptions.empty() ? string() : m_descriptions[_arg]);
 }
 
 __inline
-const ArgumentProperty& DungAF::getArgumentProperty(const std::string& _arg_label) const
+ArgumentProperty DungAF::getArgumentProperty(const std::string& _arg_label) const
+{
+	return getArgumentProperty((Argument)getArgumentIdx(_arg_label));
+}
+
+inline
+AttackProperty DungAF::getAttackProperty(const Attack& _atk) const
 {
-	return m_ag[*find_vertex(_arg_label, m_ag)];
+	assert(_atk < m_atkSource.size());
+	return m_atkProps.empty() ? AttackProperty() : m_atkProps[_atk];
 }
 
 inline
-const AttackProperty& DungAF::getAttackProperty(const Attack& _atk) const
+std::string DungAF::getArgumentLabel(const Argument& _arg) const
 {
-	return m_ag[_atk];
+	return std::string(labelData(_arg), labelSize(_arg));
 }
 
 bitvector DungAF::set2bv(const set<Argument>& sa) const
 {
-	bitvector bv( boost::num_vertices(m_ag), 0 );
+	bitvector bv( getNumberOfArguments(), 0 );
 
 	set<Argument>::iterator sa_itr;
 	for (sa_itr = sa.begin(); sa_itr != sa.end(); sa_itr++)	{
-		bv.set(m_idxMap[*sa_itr], true);
+		bv.set(*sa_itr, true);
 	}
 
 	return bv;
@@ -332,73 +590,152 @@ bitvector DungAF::set2bv(const set<Argument>& sa) const
 
 set<Argument> DungAF::bv2set(const bitvector& bv) const
 {
-	assert(bv.size() == boost::num_vertices(m_ag));
+	assert(bv.size() == getNumberOfArguments());
 	set<Argument> sa;
 	for (size_type i=bv.find_first(); i < bitvector::npos; i=bv.find_next(i)) {
-		sa.insert(boost::get(m_idxMap, i));
+		sa.insert((Argument)i);
 	}
 
 	return sa;
 }
 
+void DungAF::buildAdjacency() const
+{
+	const size_type n = getNumberOfArguments();
+	const size_type m = m_atkSource.size();
+
+	// Counting sort of the attacks by their sources and by their targets,
+	// which keeps the order of addition
+	m_outPtr.assign(n + 1, 0);
+	m_inPtr.assign(n + 1, 0);
+	for (size_type k = 0; k < m; ++k) {
+		++m_outPtr[m_atkSource[k] + 1];
+		++m_inPtr[m_atkTarget[k] + 1];
+	}
+	for (size_type i = 0; i < n; ++i) {
+		m_outPtr[i+1] += m_outPtr[i];
+		m_inPtr[i+1] += m_inPtr[i];
+	}
+
+	// m_outPtr[i] (m_inPtr[i]) moves from the beginning to the end of the
+	// edges of i, and is shifted back afterwards
+	m_outIdx.resize(m);
+	m_inIdx.resize(m);
+	for (size_type k = 0; k < m; ++k) {
+		m_outIdx[m_outPtr[m_atkSource[k]]++] = m_atkTarget[k];
+		m_inIdx[m_inPtr[m_atkTarget[k]]++] = m_atkSource[k];
+	}
+	for (size_type i = n; i > 0; --i) {
+		m_outPtr[i] = m_outPtr[i-1];
+		m_inPtr[i] = m_inPtr[i-1];
+	}
+	m_outPtr[0] = m_inPtr[0] = 0;
+
+	m_adjValid = true;
+}
+
+inline
+DungAF::const_iterator DungAF::attacked_begin(const Argument& _arg) const
+{
+	if (!m_adjValid) buildAdjacency();
+	return m_outIdx.data() + m_outPtr[_arg];
+}
+
+inline
+DungAF::const_iterator DungAF::attacked_end(const Argument& _arg) const
+{
+	if (!m_adjValid) buildAdjacency();
+	return m_outIdx.data() + m_outPtr[_arg + 1];
+}
+
+inline
+DungAF::const_iterator DungAF::attackers_begin(const Argument& _arg) const
+{
+	if (!m_adjValid) buildAdjacency();
+	return m_inIdx.data() + m_inPtr[_arg];
+}
+
+inline
+DungAF::const_iterator DungAF::attackers_end(const Argument& _arg) const
+{
+	if (!m_adjValid) buildAdjacency();
+	return m_inIdx.data() + m_inPtr[_arg + 1];
+}
+
 std::string DungAF::toString() const
 {
 	std::string s("[");
 
 	// arguments to string
 	s += "{";
-	std::pair<ArgumentIterator, ArgumentIterator> ai = vertices(m_ag);
-	if ( ai.first != ai.second )
-	{
-		ArgumentIterator ait = ai.first;
-		s +=  m_ag[*ait].label; 
-
-		for ( ++ait; ait!=ai.second; ++ait) {
-			s += ( "," + m_ag[*ait].label); 
-		}
+	for (size_type i = 0; i < getNumberOfArguments(); ++i) {
+		if (i > 0)
+			s += ",";
+		s.append(labelData(i), labelSize(i));
 	}
 	s += "},";
 
-	// Attacks to string
+	// Attacks to string, grouped by their sources
 	s += "{";
-	std::pair<AttackIterator, AttackIterator> ei = edges(m_ag);
-	if( ei.first != ei.second )
-	{
-		AttackIterator eit = ei.first;
-		s += "(" + m_ag[source(*eit, m_ag)].label + ","
-			 + m_ag[target(*eit, m_ag)].label + ")";
-
-		for (++eit; eit != ei.second; ++eit) {
-			s += ",(" + m_ag[source(*eit, m_ag)].label + ","
-				 + m_ag[target(*eit, m_ag)].label + ")";
+	bool _first = true;
+	for (Argument i = 0; i < getNumberOfArguments(); ++i) {
+		for (const_iterator j = attacked_begin(i); j != attacked_end(i); ++j) {
+			s += _first ? "(" : ",(";
+			s.append(labelData(i), labelSize(i));
+			s += ",";
+			s.append(labelData(*j), labelSize(*j));
+			s += ")";
+			_first = false;
 		}
 	}
 	s += "}";
 
-	s += "]"; 
+	s += "]";
 
 	return s;
 }
 
 bitmatrix DungAF::getAttackMatrix() const
 {
-	bitmatrix bm( boost::num_vertices(m_ag) );
+	StatTimerScope _timer(TIMER_ATTACK_MATRIX);
+	if (m_hasBm)
+		return m_bm;
 
-	std::pair<AttackIterator, AttackIterator> ei = edges(m_ag);
-	for (AttackIterator eit = ei.first; eit != ei.second; ++eit) {
-		size_type i = m_idxMap[target(*eit, m_ag)];
-		size_type j = m_idxMap[source(*eit, m_ag)];
+	bitmatrix bm( getNumberOfArguments() );
 
-		bm[i][j] = true;		
+	for (size_type k = 0; k < m_atkSource.size(); ++k) {
+		bm[m_atkTarget[k]][m_atkSource[k]] = true;
 	}
 
 	return bm;
 }
 
+sparsematrix DungAF::getSparseAttackMatrix() const
+{
+	StatTimerScope _timer(TIMER_ATTACK_MATRIX);
+	size_type n = getNumberOfArguments();
+	vector< pair<size_type, size_type> > _entries;
+	_entries.reserve(m_atkSource.size());
+
+	for (size_type k = 0; k < m_atkSource.size(); ++k) {
+		_entries.push_back(make_pair(m_atkTarget[k], m_atkSource[k]));
+	}
+
+	return sparsematrix(n, n, _entries);
+}
+
+uint64_t DungAF::getRevision() const
+{
+	static std::atomic<uint64_t> _next(1);
+	if (m_revision == 0)
+		m_revision = _next++;
+	return m_revision;
+}
+
 inline
 size_type DungAF::getNumberOfArguments() const
 {
-	return boost::num_vertices(m_ag);
+	return m_labelOff.size() - 1;
 }
 
 void DungAF::showSet(const set<Argument>& sa, std::ostream& os /*= std::cout*/) const
@@ -411,13 +748,13 @@ void DungAF::showSet(const set<Argument>& sa, std::ostream& os /*= std::cout*/)
 	{
 		if (is_first)
 		{
-			os<< m_ag[*sa_itr].label;
 			is_first = false;
 		}
 		else
 		{
-			os << DELIMITER << m_ag[*sa_itr].label;
+			os << DELIMITER;
 		}
+		os.write(labelData(*sa_itr), labelSize(*sa_itr));
 	}
 
 	os << RIGHT_LIMITER << std::endl;
@@ -428,8 +765,8 @@ void DungAF::outputBv(const bitvector& _bv, std::ostream& os /*= std::cout*/) co
 	bool first = true;
 
 	os << LEFT_LIMITER;
-	for ( size_type i = _bv.find_first(); 
-		i != bitvector::npos; 
+	for ( size_type i = _bv.find_first();
+		i != bitvector::npos;
 		i = _bv.find_next(i) )
 	{
 		if(first){
@@ -437,7 +774,7 @@ void DungAF::outputBv(const bitvector& _bv, std::ostream& os /*= std::cout*/) co
 		}else{
 			os << DELIMITER; // ","
 		}
-		os << m_ag[boost::get(m_idxMap, i)].label;
+		os.write(labelData(i), labelSize(i));
 	}
 	os << RIGHT_LIMITER;
 }
@@ -448,7 +785,7 @@ void DungAF::outputBvSet(const std::set< bitvector >& _bv_set, std::ostream& os
 
 	bool first = true;
 
-	std::set<bitvector>::iterator _bv_set_itr = _bv_set.begin();	
+	std::set<bitvector>::iterator _bv_set_itr = _bv_set.begin();
 
 	for ( ; _bv_set_itr != _bv_set.end(); ++_bv_set_itr) {
 		if(first){
@@ -462,10 +799,43 @@ void DungAF::outputBvSet(const std::set< bitvector >& _bv_set, std::ostream& os
 	os << RIGHT_LIMITER;
 }
 
+inline
+void DungAF::reserve(size_type num_args, size_type num_atks /*= 0*/)
+{
+	m_labelOff.reserve(num_args + 1);
+	while (m_labelTable.size() < 2 * num_args)
+		growLabelTable();
+
+	m_atkSource.reserve(num_atks);
+	m_atkTarget.reserve(num_atks);
+}
+
 inline
 void DungAF::clear()
 {
-	m_ag.clear();
+	m_labelChars.clear();
+	m_labelOff.assign(1, 0);
+	m_labelTable.assign(16, 0);
+	m_titles.clear();
+	m_descriptions.clear();
+
+	m_atkSource.clear();
+	m_atkTarget.clear();
+	m_atkProps.clear();
+
+	touch();
+	m_bm = bitmatrix();
+
+	for (size_type k = 0; k < m_observers.list.size(); ++k)
+		m_observers.list[k]->cleared();
+}
+
+inline
+void DungAF::setAttackMatrix(bitmatrix&& _bm)
+{
+	assert(_bm.sizeR() == getNumberOfArguments() && _bm.sizeC() == getNumberOfArguments());
+	m_bm = std::move(_bm);
+	m_hasBm = true;
 }
 
 set<string> DungAF::bv2label_set(const bitvector& _bv) const
@@ -473,7 +843,7 @@ set<string> DungAF::bv2label_set(const bitvector& _bv) const
 	set<string> _ss;
 	for (size_type i = _bv.find_first(); i != bitvector::npos; i = _bv.find_next(i))
 	{
-		_ss.insert( m_ag[boost::get(m_idxMap, i)].label );
+		_ss.insert( getArgumentLabel((Argument)i) );
 	}
 
 	return _ss;
@@ -486,9 +856,6 @@ bitvector DungAF::labelSet2bv(const set<string>& _ls) const
 	for (_ls_itr = _ls.begin(); _ls_itr != _ls.end(); ++_ls_itr)
 	{
 		_bv[getArgumentIdx(*_ls_itr)] = true;
-
-		// This approach is not safe, and can be solved by boost::optional.
-		// _bv[ m_idxMap[*find_vertex(*_ls_itr, m_ag)] ] = true;
 	}
 
 	return _bv;
@@ -509,9 +876,10 @@ set<bitvector> DungAF::label_ext2bv_ext(const set< set<string> >& _le) const
 std::vector<std::string> DungAF::getArgumentLabels() const
 {
 	vector<string> _label_vector;
+	_label_vector.reserve(getNumberOfArguments());
 	for (size_type i=0; i<getNumberOfArguments(); ++i)
 	{
-		_label_vector.push_back(m_ag[boost::get(m_idxMap, i)].label);
+		_label_vector.push_back(getArgumentLabel((Argument)i));
 	}
 
 	return _label_vector;
@@ -519,23 +887,28 @@ std::vector<std::string> DungAF::getArgumentLabels() const
 
 size_type DungAF::getArgumentIdx(const std::string& _arg_label) const
 {
-	// argumatrix::IdxMapType::npos;
-	// boost::vertex_index_t::
-	boost::optional<Argument> opt_arg = find_vertex(_arg_label, m_ag);
-	if ( opt_arg ) { return m_idxMap[*opt_arg]; }
+	size_type _slot = findSlot(_arg_label.data(), _arg_label.size());
+	if ( m_labelTable[_slot] != 0 ) { return m_labelTable[_slot] - 1; }
 	else {
 		std::cerr << "Argument [" << _arg_label << "] is not in this framework." << endl;
 		exit(1);
 	}
 }
 
+inline
 size_type DungAF::getArgumentIdx(const Argument& _arg) const
 {
-	return m_idxMap[_arg];
+	return _arg;
+}
+
+inline
+bool DungAF::hasArgument(const std::string& _arg_label) const
+{
+	return m_labelTable[findSlot(_arg_label.data(), _arg_label.size())] != 0;
 }
 
 } // namespace argumatrix
 
 
 
-#endif  //DUNG_ARGUMENTATION_FRAMEWORK_HPP
\ No newline at end of file
+#endif  //DUNG_ARGUMENTATION_FRAMEWORK_HPP
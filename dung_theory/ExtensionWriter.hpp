@@ -0,0 +1,226 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// The buffered output of the extensions
+//=======================================================================
+
+#ifndef DUNG_EXTENSION_WRITER_HPP
+#define DUNG_EXTENSION_WRITER_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stdlib.h>
+#include <errno.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "config/config.hpp"
+#include "bitmatrix/bitvector.hpp"
+
+
+namespace argumatrix{
+
+using namespace std;
+
+/**
+ * @brief How an extension is printed, e.g., the extension {a,c} of the
+ * arguments a, b, c:
+ *   - FORMAT_LABELS:  [a,c], the labels of the arguments (the default);
+ *   - FORMAT_INDICES: [0,2], the indices of the arguments;
+ *   - FORMAT_BITS:    101, a bit per argument.
+ */
+enum ExtensionFormat { FORMAT_LABELS, FORMAT_INDICES, FORMAT_BITS };
+
+/**
+ * @brief The streambuf of std::cout when the program starts, which writes to
+ * the file descriptor 1. std::cout may be redirected to another streambuf
+ * later, whose bytes must not be written to the file descriptor.
+ */
+static std::streambuf* const STDOUT_STREAMBUF = std::cout.rdbuf();
+
+/**
+ * @brief Format the extensions into a large buffer, and write the buffer
+ * at once when it is full. The labels are copied from a flat buffer of their
+ * bytes, prepared once, instead of being streamed label by label. The buffer
+ * is written by write(2) if the output is the standard output, i.e., the
+ * original streambuf of std::cout (see STDOUT_STREAMBUF), and by the streambuf
+ * of the output otherwise, e.g., after std::cout.rdbuf(buf).
+ * ~~~~~{.cpp}
+ *   ExtensionWriter _writer(m_argLabels, m_output, FORMAT_LABELS);
+ *   _writer.put(LEFT_LIMITER);
+ *   _writer.putExtension(_bv);
+ *   ...
+ * ~~~~~
+ * Nothing else may be written to the output while the writer is alive, and
+ * the remaining bytes are written when it is destroyed.
+ */
+class ExtensionWriter {
+public:
+	ExtensionWriter(const vector<string>& labels, std::ostream& os,
+		ExtensionFormat format = FORMAT_LABELS,
+		size_type capacity = OUTPUT_BUFFER_SIZE);
+	~ExtensionWriter() { flush(); }
+
+	void put(char c);
+	void put(const char* s, size_type len);
+	void put(const string& s) { put(s.data(), s.size()); }
+
+	// Print the extension _bv in the format of the writer
+	void putExtension(const bitvector& _bv);
+
+	// Write the buffered bytes to the output
+	void flush();
+
+private:
+	ExtensionWriter(const ExtensionWriter&);
+	ExtensionWriter& operator=(const ExtensionWriter&);
+
+	void putIndex(size_type i);
+
+	// Write _len bytes of _data to the file descriptor m_fd
+	void writeFd(const char* _data, size_type _len);
+
+	std::ostream& m_os;
+	int m_fd;  /**< The file descriptor of the output, or -1 */
+	ExtensionFormat m_format;
+
+	string m_labelChars;         /**< The bytes of all the labels */
+	vector<size_type> m_labelOff;  /**< The i-th label is m_labelChars[m_labelOff[i], m_labelOff[i+1]) */
+
+	vector<char> m_buffer;
+	size_type m_len;  /**< The number of the buffered bytes */
+};
+
+
+ExtensionWriter::ExtensionWriter(const vector<string>& labels, std::ostream& os,
+	ExtensionFormat format /*= FORMAT_LABELS*/,
+	size_type capacity /*= OUTPUT_BUFFER_SIZE*/):
+	m_os(os),
+	m_fd(-1),
+	m_format(format),
+	m_buffer(capacity < 64 ? 64 : capacity),
+	m_len(0)
+{
+	if (m_format == FORMAT_LABELS) {
+		m_labelOff.reserve(labels.size() + 1);
+		m_labelOff.push_back(0);
+		for (size_type i = 0; i < labels.size(); ++i) {
+			m_labelChars += labels[i];
+			m_labelOff.push_back(m_labelChars.size());
+		}
+	}
+
+	// The bytes written to the stream before must come first
+	m_os.flush();
+	if (m_os.rdbuf() == STDOUT_STREAMBUF)
+		m_fd = 1;
+}
+
+__inline
+void ExtensionWriter::put(char c)
+{
+	if (m_len == m_buffer.size())
+		flush();
+	m_buffer[m_len++] = c;
+}
+
+void ExtensionWriter::put(const char* s, size_type len)
+{
+	if (m_buffer.size() - m_len < len) {
+		flush();
+		if (len > m_buffer.size()) {
+			// Larger than the buffer, write it directly
+			if (m_fd >= 0)
+				writeFd(s, len);
+			else
+				m_os.rdbuf()->sputn(s, len);
+			return;
+		}
+	}
+	std::copy(s, s + len, m_buffer.begin() + m_len);
+	m_len += len;
+}
+
+__inline
+void ExtensionWriter::putIndex(size_type i)
+{
+	char _digits[24];
+	size_type _num = 0;
+	do {
+		_digits[_num++] = (char)('0' + i % 10);
+		i /= 10;
+	} while (i != 0);
+
+	if (m_buffer.size() - m_len < _num)
+		flush();
+	while (_num > 0)
+		m_buffer[m_len++] = _digits[--_num];
+}
+
+void ExtensionWriter::putExtension(const bitvector& _bv)
+{
+	if (m_format == FORMAT_BITS) {
+		for (size_type i = 0; i < _bv.size(); ++i)
+			put(_bv[i] ? '1' : '0');
+		return;
+	}
+
+	bool first = true;
+	put(LEFT_LIMITER);
+	for (size_type i = _bv.find_first(); i != bitvector::npos; i = _bv.find_next(i)) {
+		if(first){
+			first = false;
+		}else{
+			put(DELIMITER); // ","
+		}
+
+		if (m_format == FORMAT_INDICES)
+			putIndex(i);
+		else
+			put(m_labelChars.data() + m_labelOff[i], m_labelOff[i+1] - m_labelOff[i]);
+	}
+	put(RIGHT_LIMITER);
+}
+
+void ExtensionWriter::flush()
+{
+	if (m_len == 0)
+		return;
+
+	if (m_fd >= 0) {
+		writeFd(m_buffer.data(), m_len);
+	} else {
+		m_os.rdbuf()->sputn(m_buffer.data(), m_len);
+		m_os.rdbuf()->pubsync();
+	}
+	m_len = 0;
+}
+
+void ExtensionWriter::writeFd(const char* _data, size_type _len)
+{
+	while (_len > 0) {
+#ifdef _WIN32
+		int _n = _write(m_fd, _data, (unsigned int)_len);
+#else
+		ssize_t _n = ::write(m_fd, _data, _len);
+#endif
+		if (_n < 0) {
+			if (errno == EINTR)
+				continue;
+			cerr << "Error: in ExtensionWriter, can not write the output!" << endl;
+			exit(1);
+		}
+		_data += _n;
+		_len -= _n;
+	}
+}
+
+} // namespace argumatrix
+
+#endif  // DUNG_EXTENSION_WRITER_HPP
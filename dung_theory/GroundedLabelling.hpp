@@ -0,0 +1,102 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// Dung's abstract argumentation framework
+//=======================================================================
+
+#ifndef DUNG_GROUNDED_LABELLING_HPP
+#define DUNG_GROUNDED_LABELLING_HPP
+
+#include <vector>
+
+#include "config/config.hpp"
+#include "config/runstats.hpp"
+#include "bitmatrix/bitvector.hpp"
+#include "bitmatrix/sparsematrix.hpp"
+
+
+namespace argumatrix{
+
+using namespace std;
+
+// The labels of the integer vectors of {0,1,2}, see Reasoner::getGroundedIntVector()
+const int LAB_OUT = 0;
+const int LAB_IN = 1;
+const int LAB_UNDEC = 2;
+
+/**
+ * @brief Compute the grounded labelling by propagating the labels through the
+ * attacks, instead of iterating the characteristic function to its least fixed
+ * point. Each argument keeps the number of its attackers that are not OUT yet.
+ * An argument is labelled IN once this number reaches 0, and all the arguments
+ * it attacks are then labelled OUT, which decreases the counters of the
+ * arguments they attack. Each argument and each attack is processed at most
+ * once, so the cost is O(|A|+|R|).
+ * @param atk the attack matrix, whose entry (i,j) is 1 iff j attacks i.
+ * @param labels the output, labels[i] is LAB_IN if the argument i is in the
+ * grounded extension, LAB_OUT if it is attacked by the grounded extension, and
+ * LAB_UNDEC otherwise.
+ */
+inline
+void groundedLabelling(const sparsematrix& atk, vector<int>& labels)
+{
+	typedef sparsematrix::const_iterator const_iterator;
+	typedef sparsematrix::index_type index_type;
+
+	const size_type n = atk.sizeR();
+	labels.assign(n, LAB_UNDEC);
+
+	// The number of the attackers which are not OUT
+	vector<size_type> _alive(n);
+	// The IN arguments whose attacks are not propagated yet
+	vector<index_type> _worklist;
+	_worklist.reserve(n);
+
+	for (size_type i = 0; i < n; ++i) {
+		_alive[i] = atk.row_count(i);
+		if (_alive[i] == 0) {
+			labels[i] = LAB_IN;
+			_worklist.push_back((index_type)i);
+		}
+	}
+
+	size_type _iters = 0;
+	while (!_worklist.empty()) {
+		index_type x = _worklist.back();
+		_worklist.pop_back();
+		++_iters;
+
+		// The arguments attacked by x are OUT
+		for (const_iterator y = atk.col_begin(x), _ye = atk.col_end(x); y != _ye; ++y) {
+			if (labels[*y] != LAB_UNDEC)
+				continue;
+			labels[*y] = LAB_OUT;
+
+			// y does not attack anymore
+			for (const_iterator z = atk.col_begin(*y), _ze = atk.col_end(*y); z != _ze; ++z) {
+				if (--_alive[*z] == 0 && labels[*z] == LAB_UNDEC) {
+					labels[*z] = LAB_IN;
+					_worklist.push_back(*z);
+				}
+			}
+		}
+	}
+	RunStats::instance().count(COUNTER_GROUNDED_ITERATIONS, _iters);
+}
+
+/**
+ * @brief Get the IN arguments of a labelling.
+ */
+inline
+bitvector labelsIn(const vector<int>& labels)
+{
+	bitvector _bv(labels.size());
+	for (size_type i = 0; i < labels.size(); ++i)
+		if (labels[i] == LAB_IN) _bv.set(i);
+	return _bv;
+}
+
+} // namespace argumatrix
+
+#endif  // DUNG_GROUNDED_LABELLING_HPP
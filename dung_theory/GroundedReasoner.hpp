@@ -116,10 +116,20 @@ public:
 	*/
 	void task_DS(const std::set<string>& argset);
 
+	// The grounded extension is the unique extension
+	size_type enumerateExtensions(const ExtensionVisitor& visit);
+
 private:
 
 };  // class GroundedReasoner
 
+__inline
+size_type GroundedReasoner::enumerateExtensions(const ExtensionVisitor& visit)
+{
+	visit(getGroundedExtension());
+	return 1;
+}
+
 __inline
 void GroundedReasoner::task_EE()
 {
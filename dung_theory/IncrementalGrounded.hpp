@@ -0,0 +1,333 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// Dung's abstract argumentation framework
+//=======================================================================
+
+#ifndef DUNG_INCREMENTAL_GROUNDED_HPP
+#define DUNG_INCREMENTAL_GROUNDED_HPP
+
+#include <vector>
+#include <algorithm>
+
+#include "config/config.hpp"
+#include "bitmatrix/bitvector.hpp"
+#include "DungAF.hpp"
+#include "GroundedLabelling.hpp"
+
+
+namespace argumatrix{
+
+using namespace std;
+
+/**
+ * @brief Maintain the grounded labelling of a framework which is changed
+ * continuously, instead of recomputing it from the empty set after each
+ * change. The maintainer observes the framework (see DungAFObserver), keeps
+ * its own adjacency lists, and repairs the labels after each change:
+ *   - the changes which provably keep the grounded labelling, e.g., an attack
+ *     added against an OUT argument, or removed from an OUT argument, only
+ *     update the adjacency lists;
+ *   - otherwise, the arguments reachable from the changed one are relabelled
+ *     by the propagation of groundedLabelling(), with the labels of the other
+ *     arguments fixed, since they do not depend on the changed attack.
+ * ~~~~~{.cpp}
+ *   IncrementalGrounded _gr(daf);
+ *   daf.addAttack("a", "b");
+ *   if (_gr.getLabel(daf.getArgumentIdx("b")) == LAB_OUT) ...
+ * ~~~~~
+ * The framework must outlive the maintainer, and all its changes must be
+ * made while the maintainer is registered.
+ */
+class IncrementalGrounded : public DungAFObserver {
+public:
+	explicit IncrementalGrounded(DungAF& daf);
+	~IncrementalGrounded();
+
+	// The label LAB_IN, LAB_OUT or LAB_UNDEC of the argument _arg
+	int getLabel(Argument _arg) const { return m_labels[_arg]; }
+	bool isIn(Argument _arg) const { return m_labels[_arg] == LAB_IN; }
+
+	// The grounded labelling, as Reasoner::getGroundedIntVector()
+	const vector<int>& getLabels() const { return m_labels; }
+
+	// The grounded extension in bitvector form
+	bitvector getGroundedExtension() const { return labelsIn(m_labels); }
+
+	// The number of the arguments relabelled by the last repair, 0 if the last
+	// change kept the labelling
+	size_type getLastRepairSize() const { return m_lastRepair; }
+
+	// The changes of the framework
+	void argumentAdded(Argument _arg);
+	void attackAdded(Argument _arg1, Argument _arg2);
+	void attackRemoved(Argument _arg1, Argument _arg2);
+	void argumentRemoved(Argument _arg, Argument _moved);
+	void cleared();
+
+private:
+	// Not copyable, since it is registered by its address
+	IncrementalGrounded(const IncrementalGrounded&);
+	IncrementalGrounded& operator=(const IncrementalGrounded&);
+
+	/**
+	 * @brief Relabel the arguments reachable from the arguments _seeds. The
+	 * arguments out of this region are not attacked from the region, so that
+	 * their labels are kept.
+	 */
+	void repair(const vector<Argument>& _seeds);
+
+	// Label the argument y of the region OUT, and propagate it
+	void setOut(Argument y);
+
+	// The argument y of the region is OUT, decrease the counters of the
+	// arguments it attacks
+	void propagateOut(Argument y);
+
+	// Replace all the occurrences of _from in _vec by _to
+	static void replaceAll(vector<Argument>& _vec, Argument _from, Argument _to);
+
+	DungAF& m_daf;
+	vector< vector<Argument> > m_attacked;   /**< The out-edges, with the repeated attacks */
+	vector< vector<Argument> > m_attackers;  /**< The in-edges, with the repeated attacks */
+	vector<int> m_labels;                    /**< The grounded labelling */
+	size_type m_lastRepair;
+
+	// The scratch of repair()
+	vector<size_type> m_alive;  /**< The number of the attackers which are not OUT */
+	vector<bool> m_inRegion;
+	vector<Argument> m_region;
+	vector<Argument> m_worklist;
+};
+
+
+IncrementalGrounded::IncrementalGrounded(DungAF& daf):
+	m_daf(daf),
+	m_lastRepair(0)
+{
+	const size_type n = m_daf.getNumberOfArguments();
+	m_attacked.resize(n);
+	m_attackers.resize(n);
+	for (Argument i = 0; i < n; ++i) {
+		m_attacked[i].assign(m_daf.attacked_begin(i), m_daf.attacked_end(i));
+		m_attackers[i].assign(m_daf.attackers_begin(i), m_daf.attackers_end(i));
+	}
+	m_labels.assign(n, LAB_UNDEC);
+	m_alive.resize(n);
+	m_inRegion.assign(n, false);
+
+	// The whole framework is the region of the first labelling
+	vector<Argument> _all(n);
+	for (Argument i = 0; i < n; ++i)
+		_all[i] = i;
+	repair(_all);
+
+	m_daf.addObserver(this);
+}
+
+IncrementalGrounded::~IncrementalGrounded()
+{
+	m_daf.removeObserver(this);
+}
+
+void IncrementalGrounded::argumentAdded(Argument /*_arg*/)
+{
+	// An unattacked argument is IN
+	m_attacked.push_back(vector<Argument>());
+	m_attackers.push_back(vector<Argument>());
+	m_labels.push_back(LAB_IN);
+	m_alive.push_back(0);
+	m_inRegion.push_back(false);
+	m_lastRepair = 0;
+}
+
+void IncrementalGrounded::attackAdded(Argument _arg1, Argument _arg2)
+{
+	m_attacked[_arg1].push_back(_arg2);
+	m_attackers[_arg2].push_back(_arg1);
+
+	// The labelling is kept, unless _arg2 may not be IN anymore, or an IN
+	// argument attacks an UNDEC one
+	m_lastRepair = 0;
+	if (m_labels[_arg2] == LAB_IN ||
+		(m_labels[_arg1] == LAB_IN && m_labels[_arg2] == LAB_UNDEC)) {
+		repair(vector<Argument>(1, _arg2));
+	}
+}
+
+void IncrementalGrounded::attackRemoved(Argument _arg1, Argument _arg2)
+{
+	m_attacked[_arg1].erase(std::remove(m_attacked[_arg1].begin(),
+		m_attacked[_arg1].end(), _arg2), m_attacked[_arg1].end());
+	m_attackers[_arg2].erase(std::remove(m_attackers[_arg2].begin(),
+		m_attackers[_arg2].end(), _arg1), m_attackers[_arg2].end());
+
+	// The labelling is kept, unless _arg2 loses an IN attacker, or an UNDEC
+	// attacker which may have kept it from being IN
+	m_lastRepair = 0;
+	if (m_labels[_arg1] == LAB_IN ||
+		(m_labels[_arg1] == LAB_UNDEC && m_labels[_arg2] == LAB_UNDEC)) {
+		repair(vector<Argument>(1, _arg2));
+	}
+}
+
+void IncrementalGrounded::argumentRemoved(Argument _arg, Argument _moved)
+{
+	// Remove the attacks of _arg first, and repair the arguments it attacked
+	vector<Argument> _seeds;
+	for (size_type k = 0; k < m_attacked[_arg].size(); ++k) {
+		Argument y = m_attacked[_arg][k];
+		if (y == _arg)
+			continue;
+		m_attackers[y].erase(std::remove(m_attackers[y].begin(),
+			m_attackers[y].end(), _arg), m_attackers[y].end());
+		_seeds.push_back(y);
+	}
+	for (size_type k = 0; k < m_attackers[_arg].size(); ++k) {
+		Argument x = m_attackers[_arg][k];
+		m_attacked[x].erase(std::remove(m_attacked[x].begin(),
+			m_attacked[x].end(), _arg), m_attacked[x].end());
+	}
+	m_attacked[_arg].clear();
+	m_attackers[_arg].clear();
+
+	m_lastRepair = 0;
+	if (m_labels[_arg] != LAB_OUT) {
+		m_labels[_arg] = LAB_IN;  // It is unattacked now
+		repair(_seeds);
+	}
+
+	// Renumber _moved as _arg
+	if (_moved != _arg) {
+		replaceAll(m_attacked[_moved], _moved, _arg);
+		replaceAll(m_attackers[_moved], _moved, _arg);
+		for (size_type k = 0; k < m_attacked[_moved].size(); ++k)
+			replaceAll(m_attackers[m_attacked[_moved][k]], _moved, _arg);
+		for (size_type k = 0; k < m_attackers[_moved].size(); ++k)
+			replaceAll(m_attacked[m_attackers[_moved][k]], _moved, _arg);
+
+		m_attacked[_arg].swap(m_attacked[_moved]);
+		m_attackers[_arg].swap(m_attackers[_moved]);
+		m_labels[_arg] = m_labels[_moved];
+	}
+
+	m_attacked.pop_back();
+	m_attackers.pop_back();
+	m_labels.pop_back();
+	m_alive.pop_back();
+	m_inRegion.pop_back();
+}
+
+void IncrementalGrounded::cleared()
+{
+	m_attacked.clear();
+	m_attackers.clear();
+	m_labels.clear();
+	m_alive.clear();
+	m_inRegion.clear();
+	m_lastRepair = 0;
+}
+
+inline
+void IncrementalGrounded::replaceAll(vector<Argument>& _vec, Argument _from, Argument _to)
+{
+	std::replace(_vec.begin(), _vec.end(), _from, _to);
+}
+
+inline
+void IncrementalGrounded::setOut(Argument y)
+{
+	m_labels[y] = LAB_OUT;
+	propagateOut(y);
+}
+
+inline
+void IncrementalGrounded::propagateOut(Argument y)
+{
+	// y does not attack anymore
+	for (size_type k = 0; k < m_attacked[y].size(); ++k) {
+		Argument z = m_attacked[y][k];
+		if (--m_alive[z] == 0 && m_labels[z] == LAB_UNDEC) {
+			m_labels[z] = LAB_IN;
+			m_worklist.push_back(z);
+		}
+	}
+}
+
+void IncrementalGrounded::repair(const vector<Argument>& _seeds)
+{
+	// The region: the arguments reachable from the seeds
+	m_region.clear();
+	for (size_type k = 0; k < _seeds.size(); ++k) {
+		if (!m_inRegion[_seeds[k]]) {
+			m_inRegion[_seeds[k]] = true;
+			m_region.push_back(_seeds[k]);
+		}
+	}
+	for (size_type k = 0; k < m_region.size(); ++k) {
+		const vector<Argument>& _out = m_attacked[m_region[k]];
+		for (size_type j = 0; j < _out.size(); ++j) {
+			if (!m_inRegion[_out[j]]) {
+				m_inRegion[_out[j]] = true;
+				m_region.push_back(_out[j]);
+			}
+		}
+	}
+
+	for (size_type k = 0; k < m_region.size(); ++k)
+		m_labels[m_region[k]] = LAB_UNDEC;
+
+	// The attackers out of the region keep their labels: an IN one makes the
+	// argument OUT, an UNDEC one is never OUT
+	vector<Argument> _outs;
+	for (size_type k = 0; k < m_region.size(); ++k) {
+		Argument y = m_region[k];
+		size_type _alive = 0;
+		bool _attacked = false;
+		for (size_type j = 0; j < m_attackers[y].size(); ++j) {
+			Argument x = m_attackers[y][j];
+			if (m_inRegion[x] || m_labels[x] == LAB_UNDEC)
+				++_alive;
+			else if (m_labels[x] == LAB_IN)
+				_attacked = true;
+		}
+		m_alive[y] = _alive;
+		if (_attacked)
+			_outs.push_back(y);
+	}
+
+	// They are all labelled OUT before the propagation, which could label
+	// them IN otherwise, since their IN attackers are not counted
+	m_worklist.clear();
+	for (size_type k = 0; k < _outs.size(); ++k)
+		m_labels[_outs[k]] = LAB_OUT;
+	for (size_type k = 0; k < _outs.size(); ++k)
+		propagateOut(_outs[k]);
+	for (size_type k = 0; k < m_region.size(); ++k) {
+		Argument y = m_region[k];
+		if (m_alive[y] == 0 && m_labels[y] == LAB_UNDEC) {
+			m_labels[y] = LAB_IN;
+			m_worklist.push_back(y);
+		}
+	}
+
+	while (!m_worklist.empty()) {
+		Argument x = m_worklist.back();
+		m_worklist.pop_back();
+
+		// The arguments attacked by x are OUT
+		for (size_type j = 0; j < m_attacked[x].size(); ++j) {
+			if (m_labels[m_attacked[x][j]] == LAB_UNDEC)
+				setOut(m_attacked[x][j]);
+		}
+	}
+
+	for (size_type k = 0; k < m_region.size(); ++k)
+		m_inRegion[m_region[k]] = false;
+	m_lastRepair = m_region.size();
+}
+
+} // namespace argumatrix
+
+#endif  // DUNG_INCREMENTAL_GROUNDED_HPP
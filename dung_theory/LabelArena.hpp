@@ -0,0 +1,83 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// Dung's abstract argumentation framework
+//=======================================================================
+
+#ifndef DUNG_LABEL_ARENA_HPP
+#define DUNG_LABEL_ARENA_HPP
+
+#include <string.h>
+#include <vector>
+
+#include "config/config.hpp"
+#include "bitmatrix/bitvector.hpp"
+#include "bitmatrix/bitrow.hpp"
+
+
+namespace argumatrix{
+
+using namespace std;
+
+/**
+ * @brief The labellings of a depth-first labelling search, one per depth. The
+ * labelling of a depth is a slab of ROWS_PER_DEPTH contiguous rows of the
+ * same number of bits, the labels BLANK, IN, OUT, UNDEC and MUST_OUT, and a
+ * scratch row for the temporary sets. The slab of a depth is allocated at the
+ * first visit of the depth and it is reused by all the branches below, so
+ * that a branch is a memcpy of the labels of its parent (see push()) instead
+ * of five bitvector copies. The rows are accessed by the views bitrow, which
+ * stay valid until the arena is destroyed.
+ * ~~~~~{.cpp}
+ *   LabelArena _arena(m_argNum);
+ *   _arena.push(d);  // The labelling of d+1 is a copy of the labelling of d
+ *   bitrow _in_new = _arena.row(d+1, LabelArena::ROW_IN);
+ * ~~~~~
+ */
+class LabelArena {
+public:
+	enum ROWS { ROW_BLANK = 0, ROW_IN, ROW_OUT, ROW_UNDEC, ROW_MUST_OUT,
+		ROW_TMP, ROWS_PER_DEPTH };
+
+	explicit LabelArena(size_type _nbits): m_nbits(_nbits),
+		m_stride((_nbits + bitvector::bits_per_block - 1) / bitvector::bits_per_block) {}
+
+	// The row _r of the labelling of depth _d
+	bitrow row(size_type _d, size_type _r)
+	{
+		return bitrow(slab(_d) + _r * m_stride, m_nbits);
+	}
+
+	// Copy the labels of depth _d to depth _d+1
+	void push(size_type _d)
+	{
+		block_type* _to = slab(_d + 1);  // May allocate the slab of _d+1
+		memcpy(_to, slab(_d), ROW_TMP * m_stride * sizeof(block_type));
+	}
+
+	// Copy the labels of depth _d+1 back to depth _d
+	void adopt(size_type _d)
+	{
+		memcpy(slab(_d), slab(_d + 1), ROW_TMP * m_stride * sizeof(block_type));
+	}
+
+private:
+	block_type* slab(size_type _d)
+	{
+		while (m_slabs.size() <= _d)
+			m_slabs.push_back(vector<block_type>(ROWS_PER_DEPTH * m_stride + 1, 0));  // Never empty
+		return m_slabs[_d].data();
+	}
+
+	size_type m_nbits;   /**< The number of bits of a row */
+	size_type m_stride;  /**< The number of blocks of a row */
+
+	// The slabs of the depths. Moving a slab keeps its blocks, so the views of
+	// the rows are not invalidated when the stack grows.
+	vector< vector<block_type> > m_slabs;
+};
+
+} // namespace argumatrix
+
+#endif  // DUNG_LABEL_ARENA_HPP
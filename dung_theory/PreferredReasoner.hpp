@@ -12,6 +12,7 @@
 #include <string>
 #include <utility>   
 #include <algorithm>   
+#include <mutex>
 
 //boost
 #include <boost/graph/graph_traits.hpp> 
@@ -22,8 +23,12 @@
 #include "AttackProperty.hpp"
 #include "bitmatrix/bitvector.hpp"
 #include "bitmatrix/bitmatrix.hpp"
+#include "bitmatrix/sparsematrix.hpp"
+#include "bitmatrix/fixed_bitvector.hpp"
 #include "DungAF.hpp"
 #include "Reasoner.hpp"
+#include "LabelArena.hpp"
+#include "config/workpool.hpp"
 
 
 namespace argumatrix{
@@ -31,17 +36,26 @@ namespace argumatrix{
 using namespace std;
 
 /**
-* This reasoner for Dung theories performs inference on the preferred extension.
-* Computes the (unique) grounded extension, i.e., the least fixpoint of 
-* the characteristic function.
+* This reasoner for Dung theories performs inference on the preferred extensions,
+* i.e., the maximal admissible sets w.r.t. set inclusion, by a labelling search.
+* The enumeration tasks search all the preferred extensions, while the other
+* tasks search a few admissible sets from a labelling fixed in part, e.g., 
+* DC-PR searches an admissible set containing the query.
+* The frameworks of the fixed_bitvector labels use the dense attack matrix,
+* and the larger ones choose it by the density of attacks (see MatrixStorage),
+* so that the search of a large and sparse framework walks the lists of the
+* sparse matrix instead of allocating n^2 bits.
 */
 class PreferredReasoner : public Reasoner {
 public:
 	PreferredReasoner(const DungAF& daf, streambuf* osbuff = std::cout.rdbuf())
-		: Reasoner(daf, osbuff) {
+		: Reasoner(daf, osbuff, fixed_width_for(daf.getNumberOfArguments()) > 0 ?
+			DENSE_MATRIX : AUTO_MATRIX), m_pool(NULL) {
 		// m_argNum = m_daf.getNumberOfArguments();
 		// m_BmAtkMtx = m_daf.getAttackMatrix();
-		m_attackedBy = m_BmAtkMtx.transpose();
+		if (m_isDense && m_argNum > 0)  // An empty matrix can not be transposed
+			m_attackedBy = m_BmAtkMtx.transpose();
+		m_fixedWidth = fixed_width_for(m_argNum);
 	}
 
 	/**
@@ -49,9 +63,14 @@ public:
 	 * of arguments. Here, we use a bitvector to represent an extension. The results
 	 * are stored in m_extensions. When a new extension bv is computed, it can be added
 	 * to m_extensions by m_extensions.push_back(bv).
+	 * If more than one thread is set (see setThreadNum()), the branches of the
+	 * search become tasks of a work-stealing pool.
 	 * @return no return. The results are stored in m_extensions.
 	 */
-	void computeExtensions();
+	virtual void computeExtensions();
+
+	// Compute the extensions, and then visit them
+	size_type enumerateExtensions(const ExtensionVisitor& visit);
 
 	/**
 	 * Get attackers of arguments in _bv, R^-(S) 
@@ -62,7 +81,29 @@ public:
 	 */
 	bitvector getAttackers(const bitvector& _bv);
 
-private:
+public:
+	// Problems
+	void task_EE();
+	void task_EX();
+	void task_EC(const std::set<string>& argset);
+
+	// Extend the admissible set containing argset found as DC-PR does
+	void task_SC(const std::set<string>& argset);
+	void task_SE();
+
+	// argset is admissible, and it has no admissible strict superset
+	void task_DE(const std::set<string>& argset);
+
+	// Some non-empty admissible set exists
+	void task_DN();
+
+	// Some admissible set contains argset
+	void task_DC(const std::set<string>& argset);
+
+	// No counterexample exists for any argument of argset, see isSkeptical()
+	void task_DS(const std::set<string>& argset);
+
+protected:
 	enum SELECT_TYPE { TYPE_A, TYPE_B };
 	enum LABELS { BLANK = 0, _IN_, _OUT_, MUST_OUT, UNDEC, Label_Num };
 
@@ -74,42 +115,277 @@ private:
 	 * (3) setting all arguments attacked by IN-label arguments with OUT label; 
 	 * Lastly, all arguments labeled IN or OUT will be removed from BLANK.
 	 */
-	void preprocessing(bitvector& _blank, bitvector& _in, bitvector& _out, bitvector& _undec);
+	virtual void preprocessing(bitvector& _blank, bitvector& _in, bitvector& _out, bitvector& _undec);
+
+	/**
+	 * The labelling search. The subclasses searching other extensions with
+	 * the same labels (see SemiStableReasoner and StageReasoner) override it,
+	 * together with preprocessing(), addCandidate() and isPromising().
+	 */
+	virtual void findPreferredExtensions(bitvector& _blank, bitvector& _in, 
+			bitvector& _out, bitvector& _undec, bitvector& _must_out);
+
+	/**
+	 * The body of findPreferredExtensions(), on the labels of type Labels,
+	 * i.e., bitvector or fixed_bitvector<N> (see m_fixedWidth).
+	 */
+	template<class Labels>
+	void searchPreferred(Labels& _blank, Labels& _in, 
+			Labels& _out, Labels& _undec, Labels& _must_out);
+
+	/**
+	 * The body of findPreferredExtensions() on the bitvector labels, from the
+	 * labelling of the depth _d of _arena. The labellings of the branches are
+	 * the next depths of _arena, so that no bitvector is allocated.
+	 */
+	void searchArena(LabelArena& _arena, size_type _d);
 
-	void findPreferredExtensions(bitvector& _blank, bitvector& _in, 
+	/**
+	 * Start the search from the labelling, on the fixed_bitvector of the width
+	 * m_fixedWidth if any. In the parallel mode the root is a task of m_pool.
+	 */
+	void startSearch(bitvector& _blank, bitvector& _in, 
 			bitvector& _out, bitvector& _undec, bitvector& _must_out);
 
-	bool lookAhead(bitvector& _blank_new, bitvector& _tmp_must_out);
+	template<size_type N>
+	void startFixedSearch(const bitvector& _blank, const bitvector& _in, 
+			const bitvector& _out, const bitvector& _undec, const bitvector& _must_out);
+
+	/**
+	 * Run findPreferredExtensions() on a copy of the labelling as a task of
+	 * m_pool, so that an idle thread can take it.
+	 */
+	void spawnSearch(bitvector _blank, bitvector _in, 
+			bitvector _out, bitvector _undec, bitvector _must_out);
+
+	// Run searchPreferred() on a copy of the fixed-width labelling as a task of m_pool
+	template<class Labels>
+	void spawnSearch(Labels _blank, Labels _in, 
+			Labels _out, Labels _undec, Labels _must_out);
+
+	/**
+	 * Add a candidate extension into m_extensions, unless it is a subset of
+	 * some extension already found. The extensions found before which are
+	 * strict subsets of the candidate are removed, since in the parallel mode
+	 * a branch may end before another branch finds a larger extension. 
+	 * This method can be called concurrently.
+	 */
+	virtual void addCandidate(const const_bitrow& _in);
+
+	/**
+	 * Whether the labelling may still lead to a wanted extension, checked
+	 * before each choice of findPreferredExtensions(). The branch is pruned
+	 * if not. All the preferred extensions are wanted. The labels are given
+	 * as views, whatever the type of the labels of the search.
+	 */
+	virtual bool isPromising(const const_bitrow& /*_blank*/, const const_bitrow& /*_in*/, 
+		const const_bitrow& /*_out*/, const const_bitrow& /*_undec*/, const const_bitrow& /*_must_out*/) { return true; }
+
+	template<class Labels>
+	bool lookAhead(const Labels& _blank_new, const Labels& _tmp_must_out);
+
+	/**
+	 * Label the BLANK argument i IN: the arguments attacked by i are OUT, and
+	 * the attackers of i labelled BLANK or UNDEC are MUST_OUT. The rows of the
+	 * attack matrix are used if it is dense, otherwise the sparse lists.
+	 * @param _tmp a scratch set of the size of the labels.
+	 */
+	template<class Labels>
+	void labelArgumentIn(size_type i, Labels& _blank, Labels& _in, Labels& _out, 
+		Labels& _undec, Labels& _must_out, Labels& _tmp);
+
+	// Whether some attacker of the argument i is in _set
+	template<class Labels>
+	bool intersectsAttackers(size_type i, const Labels& _set);
+
+	// Whether all the attackers of the argument i are in _set
+	template<class Labels>
+	bool attackersSubsetOf(size_type i, const Labels& _set);
 
-	pair<size_type, SELECT_TYPE> selectArgument(const bitvector& _blank, const bitvector& _in, 
-		const bitvector& _out, const bitvector& _undec, const bitvector& _must_out);
+	// Whether some argument attacked by the argument i is in _set
+	template<class Labels>
+	bool intersectsAttacked(size_type i, const Labels& _set);
+
+	// The number of the attacks from and to the argument i
+	size_type degree(size_type i) const {
+		return m_SpAtkMtx.row_count(i) + m_SpAtkMtx.col_count(i);
+	}
+
+	/**
+	 * Select the BLANK argument of the next choice: one whose attackers are
+	 * all in _decided, the OUT and MUST_OUT arguments, is IN (TYPE_A);
+	 * otherwise the one with most attacks is branched on (TYPE_B).
+	 */
+	template<class Labels, class Decided>
+	pair<size_type, SELECT_TYPE> selectArgument(const Labels& _blank, const Decided& _decided);
+
+	// The labelling after preprocessing(), where all the arguments are BLANK
+	void initLabelling(bitvector& _blank, bitvector& _in, 
+		bitvector& _out, bitvector& _undec, bitvector& _must_out);
+
+	/**
+	 * Label the arguments of _set IN, with the same propagation as
+	 * findPreferredExtensions().
+	 * @return false if some of them can not be IN in the labelling.
+	 */
+	bool labelIn(const bitvector& _set, bitvector& _blank, bitvector& _in, 
+		bitvector& _out, bitvector& _undec, bitvector& _must_out);
 
-private:
+	/**
+	 * Search depth first an admissible set by the labelling search of 
+	 * findPreferredExtensions(), and stop at the first one which is not a
+	 * subset of any set of _blocked. A branch is pruned as soon as its IN and
+	 * BLANK arguments are all in some set of _blocked.
+	 * @param _found the admissible set found.
+	 * @return whether such an admissible set exists.
+	 */
+	bool findAdmissible(bitvector& _blank, bitvector& _in, bitvector& _out, 
+		bitvector& _undec, bitvector& _must_out, const vector<bitvector>& _blocked,
+		bitvector& _found);
+
+	// Search an admissible set containing _set
+	bool findCredulous(const bitvector& _set, bitvector& _found);
+
+	// A preferred extension containing the admissible set _adm
+	bitvector maximize(const bitvector& _adm);
+
+	/**
+	 * Decide whether the argument _arg is in all the preferred extensions by 
+	 * searching a counterexample, i.e., a preferred extension without _arg:
+	 * first an admissible set attacking _arg, which is extended to one; 
+	 * otherwise each admissible set excluding _arg (UNDEC) is made maximal
+	 * among them, and it is preferred unless some admissible set contains it
+	 * and _arg. Such an admissible set is then blocked from the search.
+	 */
+	bool isSkeptical(size_type _arg);
+
+protected:
 	/**
 	 * The transpose of the attack matrix, it provides an effective way to
 	 * access all attacked arguments of a given argument. The attacked arguments
-	 * of the argument with index i is m_attackedBy[i].	
+	 * of the argument with index i is m_attackedBy[i]. It is empty unless
+	 * isDense().
 	 */
 	bitmatrix m_attackedBy;
 
+	WorkStealingPool* m_pool;  /**< The pool of the parallel mode, NULL if sequential */
+
+	/**
+	 * The width of the fixed_bitvector labels of the search, chosen by the
+	 * number of the arguments (64, 128 or 256), or 0 for the bitvector labels.
+	 * A subclass overriding findPreferredExtensions() sets it to 0.
+	 */
+	size_type m_fixedWidth;
+
+	std::mutex m_extMutex;   /**< Protect m_extensions in the parallel mode */
 };  // class GroundedReasoner
 
 void PreferredReasoner::computeExtensions()
 {
 	m_extensions.clear();
 
-	// We using five bitvector to encode the labellings of all arguments. 
-	// Each argument is merely labeled with one of the following five labellings.
-	bitvector _blank = bitvector::UniversalSet(m_argNum);  // At beginning, all arguments are labeled BLANK
-	bitvector _out = bitvector::EmptySet(m_argNum);   // Empty set
-	bitvector _in = bitvector::EmptySet(m_argNum);
-	bitvector _must_out = bitvector::EmptySet(m_argNum);
-	bitvector _undec = bitvector::EmptySet(m_argNum);
+	bitvector _blank, _in, _out, _undec, _must_out;
+	initLabelling(_blank, _in, _out, _undec, _must_out);
+
+	if (m_threadNum > 1) {
+		WorkStealingPool _pool(m_threadNum);
+		m_pool = &_pool;
+		startSearch(_blank, _in, _out, _undec, _must_out);
+		_pool.wait();
+		m_pool = NULL;
+	} else {
+		startSearch(_blank, _in, _out, _undec, _must_out);
+	}
+}
 
-	// Preprocessing
-	preprocessing(_blank, _in, _out, _undec);
+void PreferredReasoner::startSearch(bitvector& _blank, bitvector& _in, 
+	bitvector& _out, bitvector& _undec, bitvector& _must_out)
+{
+	switch (m_fixedWidth) {
+	case 64:
+		startFixedSearch<64>(_blank, _in, _out, _undec, _must_out);
+		break;
+	case 128:
+		startFixedSearch<128>(_blank, _in, _out, _undec, _must_out);
+		break;
+	case 256:
+		startFixedSearch<256>(_blank, _in, _out, _undec, _must_out);
+		break;
+	default:
+		if (m_pool != NULL)
+			spawnSearch(_blank, _in, _out, _undec, _must_out);
+		else
+			findPreferredExtensions(_blank, _in, _out, _undec, _must_out);
+	}
+}
+
+template<size_type N>
+void PreferredReasoner::startFixedSearch(const bitvector& _blank, const bitvector& _in, 
+	const bitvector& _out, const bitvector& _undec, const bitvector& _must_out)
+{
+	fixed_bitvector<N> _blank_fx(_blank), _in_fx(_in), _out_fx(_out), 
+		_undec_fx(_undec), _must_out_fx(_must_out);
+
+	if (m_pool != NULL)
+		spawnSearch(_blank_fx, _in_fx, _out_fx, _undec_fx, _must_out_fx);
+	else
+		searchPreferred(_blank_fx, _in_fx, _out_fx, _undec_fx, _must_out_fx);
+}
+
+size_type PreferredReasoner::enumerateExtensions(const ExtensionVisitor& visit)
+{
+	computeExtensions();
+
+	size_type _num = 0;
+	std::set<bitvector>::const_iterator sa_itr = m_extensions.begin();
+	for ( ; sa_itr != m_extensions.end(); ++sa_itr) {
+		++_num;
+		if (!visit(*sa_itr))
+			break;
+	}
+	return _num;
+}
+
+void PreferredReasoner::spawnSearch(bitvector _blank, bitvector _in, 
+	bitvector _out, bitvector _undec, bitvector _must_out)
+{
+	m_pool->submit([=]() mutable {
+		findPreferredExtensions(_blank, _in, _out, _undec, _must_out);
+	});
+}
+
+template<class Labels>
+void PreferredReasoner::spawnSearch(Labels _blank, Labels _in, 
+	Labels _out, Labels _undec, Labels _must_out)
+{
+	m_pool->submit([=]() mutable {
+		searchPreferred(_blank, _in, _out, _undec, _must_out);
+	});
+}
+
+void PreferredReasoner::addCandidate(const const_bitrow& _in_row)
+{
+	bitvector _in(_in_row);
+
+	std::lock_guard<std::mutex> _lock(m_extMutex);
+
+	std::set<bitvector>::iterator sa_itr = m_extensions.begin();
+	while (sa_itr != m_extensions.end())
+	{
+		if (_in.is_subset_of( *sa_itr ))
+		{
+			//cout << "duplicate: " << _in << "is subset of" << *sa_itr << endl;
+			return;
+		}
+
+		if (sa_itr->is_proper_subset_of( _in )) {
+			m_extensions.erase(sa_itr++);
+		} else {
+			++sa_itr;
+		}
+	}
 
-	findPreferredExtensions(_blank, _in, _out, _undec, _must_out);
+	m_extensions.insert( _in );
 }
 
 void PreferredReasoner::preprocessing(bitvector& _blank, bitvector& _in, bitvector& _out, bitvector& _undec)
@@ -129,42 +405,133 @@ void PreferredReasoner::preprocessing(bitvector& _blank, bitvector& _in, bitvect
 	_blank -= _in;
 	_blank -= _out;
 	_blank -= _undec;
+
+	// A self-attacking argument attacked by an IN argument is OUT, not UNDEC
+	_undec -= _out;
 }
 
 void PreferredReasoner::findPreferredExtensions(bitvector& _blank, 
 		bitvector& _in, bitvector& _out, bitvector& _undec, bitvector& _must_out)
 {
+	LabelArena _arena(m_argNum);
+	_arena.row(0, LabelArena::ROW_BLANK) = _blank;
+	_arena.row(0, LabelArena::ROW_IN) = _in;
+	_arena.row(0, LabelArena::ROW_OUT) = _out;
+	_arena.row(0, LabelArena::ROW_UNDEC) = _undec;
+	_arena.row(0, LabelArena::ROW_MUST_OUT) = _must_out;
+
+	searchArena(_arena, 0);
+}
+
+void PreferredReasoner::searchArena(LabelArena& _arena, size_type _d)
+{
+	bitrow _blank = _arena.row(_d, LabelArena::ROW_BLANK);
+	bitrow _in = _arena.row(_d, LabelArena::ROW_IN);
+	bitrow _out = _arena.row(_d, LabelArena::ROW_OUT);
+	bitrow _undec = _arena.row(_d, LabelArena::ROW_UNDEC);
+	bitrow _must_out = _arena.row(_d, LabelArena::ROW_MUST_OUT);
+	bitrow _decided = _arena.row(_d, LabelArena::ROW_TMP);
+
+	bitrow _blank_new = _arena.row(_d+1, LabelArena::ROW_BLANK);
+	bitrow _in_new = _arena.row(_d+1, LabelArena::ROW_IN);
+	bitrow _out_new = _arena.row(_d+1, LabelArena::ROW_OUT);
+	bitrow _undec_new = _arena.row(_d+1, LabelArena::ROW_UNDEC);
+	bitrow _must_out_new = _arena.row(_d+1, LabelArena::ROW_MUST_OUT);
+	bitrow _tmp_must_out = _arena.row(_d+1, LabelArena::ROW_TMP);
+
 	size_type i;
 	SELECT_TYPE _s_type;
 
-	boost::tie(i, _s_type) = selectArgument(_blank, _in, _out, _undec, _must_out);
+	_decided = _out;  _decided |= _must_out;
+	boost::tie(i, _s_type) = selectArgument(_blank, _decided);
 
 	while (i != bitvector::npos)
 	{
-		bitvector _blank_new(_blank);
-		bitvector _out_new(_out);
-		bitvector _in_new(_in);
-		bitvector _must_out_new(_must_out);
-		bitvector _undec_new(_undec);
+		if ( !isPromising(_blank, _in, _out, _undec, _must_out) )
+			return;
 
-		_in_new[i] = true; _blank_new[i] = false;  // label i with IN
+		_arena.push(_d);
 
-		_out_new |= m_attackedBy[i];
-		_blank_new -= m_attackedBy[i];
-		_undec_new -= m_attackedBy[i];
-		_must_out_new -= m_attackedBy[i];
+		labelArgumentIn(i, _blank_new, _in_new, _out_new, _undec_new, 
+			_must_out_new, _tmp_must_out);
 
-		// get argument i's attackers which are labeled by BLANK or UNDEC
-		bitvector _tmp_must_out( m_BmAtkMtx[i]&(_blank_new|_undec_new) );
-		_must_out_new |= _tmp_must_out;
-		_blank_new -= _tmp_must_out;
-		_undec_new -= _tmp_must_out;
+		bool forwardCheck = lookAhead(_blank_new, _must_out_new);
+		if ( forwardCheck )
+		{
+			// The spawned task copies the labels, since the rows of the 
+			// depth _d+1 are reused by the next branch
+			if (m_pool != NULL && _s_type == TYPE_B && m_pool->hungry()) {
+				spawnSearch(bitvector(_blank_new), bitvector(_in_new), bitvector(_out_new), 
+					bitvector(_undec_new), bitvector(_must_out_new));
+			} else if (_s_type == TYPE_B) {
+				searchArena(_arena, _d+1);
+			}
+		}
+
+		if (_s_type == TYPE_B)
+		{
+			_undec[i] = true;  _blank[i] = false;
+			if ( !lookAhead(_blank, _must_out) )
+				return;
+		}
+		else   // TYPE_A
+		{
+			if ( !forwardCheck )
+				return;
+
+			// The choice is not a branch, the labelling is adopted
+			_arena.adopt(_d);
+		}
+
+		_decided = _out;  _decided |= _must_out;
+		boost::tie(i, _s_type) = selectArgument(_blank, _decided);
+	}
+
+	// if there are no argument labeled MUST_OUT, then inserts the argument 
+	// set labeled IN into extensions
+	if ( _must_out.none() )
+	{
+		addCandidate( _in );
+	}
+}
+
+template<class Labels>
+void PreferredReasoner::searchPreferred(Labels& _blank, 
+		Labels& _in, Labels& _out, Labels& _undec, Labels& _must_out)
+{
+	size_type i;
+	SELECT_TYPE _s_type;
+
+	boost::tie(i, _s_type) = selectArgument(_blank, _out | _must_out);
+
+	while (i != bitvector::npos)
+	{
+		if ( !isPromising(const_bitrow(_blank), const_bitrow(_in), const_bitrow(_out), 
+				const_bitrow(_undec), const_bitrow(_must_out)) )
+			return;
+
+		Labels _blank_new(_blank);
+		Labels _out_new(_out);
+		Labels _in_new(_in);
+		Labels _must_out_new(_must_out);
+		Labels _undec_new(_undec);
+		Labels _tmp_must_out(m_argNum);
+
+		labelArgumentIn(i, _blank_new, _in_new, _out_new, _undec_new, 
+			_must_out_new, _tmp_must_out);
 
 		//bool forwardCheck = lookAhead(_blank_new, _tmp_must_out);
 		bool forwardCheck = lookAhead(_blank_new, _must_out_new);
 		if ( forwardCheck )
 		{
-			findPreferredExtensions(_blank_new, _in_new, _out_new, _undec_new, _must_out_new);
+			// In the parallel mode, the IN branch of a choice point becomes a 
+			// task when some thread is idle, and this thread goes on with the
+			// UNDEC branch.
+			if (m_pool != NULL && _s_type == TYPE_B && m_pool->hungry()) {
+				spawnSearch(_blank_new, _in_new, _out_new, _undec_new, _must_out_new);
+			} else if (_s_type == TYPE_B) {
+				searchPreferred(_blank_new, _in_new, _out_new, _undec_new, _must_out_new);
+			}
 		}
 		
 		if (_s_type == TYPE_B)
@@ -185,48 +552,114 @@ void PreferredReasoner::findPreferredExtensions(bitvector& _blank,
 			_undec = _undec_new;
 		}
 
-		boost::tie(i, _s_type) = selectArgument(_blank, _in, _out, _undec, _must_out);
+		boost::tie(i, _s_type) = selectArgument(_blank, _out | _must_out);
 	}
 
 	// if there are no argument labeled MUST_OUT, then inserts the argument 
 	// set labeled IN into extensions
 	if ( _must_out.is_emptyset() )
 	{
-		std::set<bitvector>::iterator sa_itr;
-
-		for (sa_itr = m_extensions.begin(); sa_itr != m_extensions.end(); sa_itr++)
-		{
-			if (_in.is_subset_of( *sa_itr ))
-			{
-				//cout << "duplicate: " << _in << "is subset of" << *sa_itr << endl;
-				return;
-			}
-		}
-
-		m_extensions.insert( _in );
+		addCandidate( const_bitrow(_in) );
 	}
 }
 
-bool PreferredReasoner::lookAhead(bitvector& _blank_new, bitvector& _tmp_must_out)
+template<class Labels>
+bool PreferredReasoner::lookAhead(const Labels& _blank_new, const Labels& _tmp_must_out)
 {
 	for (size_type i = _tmp_must_out.find_first(); i != bitvector::npos; i = _tmp_must_out.find_next(i))
 	{
-		if ( !m_BmAtkMtx[i].intersects(_blank_new) )
+		if ( !intersectsAttackers(i, _blank_new) )
 			return false;
 	}
 
 	return true;
 }
 
+template<class Labels>
+void PreferredReasoner::labelArgumentIn(size_type i, Labels& _blank, Labels& _in, 
+	Labels& _out, Labels& _undec, Labels& _must_out, Labels& _tmp)
+{
+	_in[i] = true; _blank[i] = false;  // label i with IN
+
+	if (m_isDense) {
+		_out |= m_attackedBy[i];
+		_blank -= m_attackedBy[i];
+		_undec -= m_attackedBy[i];
+		_must_out -= m_attackedBy[i];
+
+		// get argument i's attackers which are labeled by BLANK or UNDEC
+		_tmp = _blank;  _tmp |= _undec;
+		_tmp &= m_BmAtkMtx[i];
+		_must_out |= _tmp;
+		_blank -= _tmp;
+		_undec -= _tmp;
+		return;
+	}
+
+	sparsematrix::const_iterator it, _end;
+	for (it = m_SpAtkMtx.col_begin(i), _end = m_SpAtkMtx.col_end(i); it != _end; ++it) {
+		_out[*it] = true;
+		_blank[*it] = false;  _undec[*it] = false;  _must_out[*it] = false;
+	}
+	for (it = m_SpAtkMtx.row_begin(i), _end = m_SpAtkMtx.row_end(i); it != _end; ++it) {
+		if (_blank[*it] || _undec[*it]) {
+			_must_out[*it] = true;
+			_blank[*it] = false;  _undec[*it] = false;
+		}
+	}
+}
+
+template<class Labels>
+bool PreferredReasoner::intersectsAttackers(size_type i, const Labels& _set)
+{
+	if (m_isDense)
+		return m_BmAtkMtx[i].intersects(_set);
+
+	sparsematrix::const_iterator it = m_SpAtkMtx.row_begin(i), _end = m_SpAtkMtx.row_end(i);
+	for ( ; it != _end; ++it) {
+		if (_set[*it])
+			return true;
+	}
+	return false;
+}
+
+template<class Labels>
+bool PreferredReasoner::attackersSubsetOf(size_type i, const Labels& _set)
+{
+	if (m_isDense)
+		return m_BmAtkMtx[i].is_subset_of(_set);
+
+	sparsematrix::const_iterator it = m_SpAtkMtx.row_begin(i), _end = m_SpAtkMtx.row_end(i);
+	for ( ; it != _end; ++it) {
+		if (!_set[*it])
+			return false;
+	}
+	return true;
+}
+
+template<class Labels>
+bool PreferredReasoner::intersectsAttacked(size_type i, const Labels& _set)
+{
+	if (m_isDense)
+		return m_attackedBy[i].intersects(_set);
+
+	sparsematrix::const_iterator it = m_SpAtkMtx.col_begin(i), _end = m_SpAtkMtx.col_end(i);
+	for ( ; it != _end; ++it) {
+		if (_set[*it])
+			return true;
+	}
+	return false;
+}
+
+template<class Labels, class Decided>
 pair<size_type, PreferredReasoner::SELECT_TYPE> PreferredReasoner::selectArgument(
-	const bitvector& _blank, const bitvector& _in, const bitvector& _out,
-	const bitvector& _undec, const bitvector& _must_out) 
+	const Labels& _blank, const Decided& _decided) 
 {
 	size_type i = bitvector::npos;
 	for (size_type j = _blank.find_first(); j != bitvector::npos; j = _blank.find_next(j))
 	{
 		//bool _m_in = true;
-		if( m_BmAtkMtx[j].is_subset_of(_out|_must_out) )
+		if( attackersSubsetOf(j, _decided) )
 		//if ( !m_attackMatrix[j].intersects(_blank|_undec) )
 		{
 			return make_pair(j, TYPE_A);
@@ -234,8 +667,7 @@ pair<size_type, PreferredReasoner::SELECT_TYPE> PreferredReasoner::selectArgumen
 		
 		if ( i == bitvector::npos) 	{
 			i = j;
-		} else if (m_attackedBy[j].count()+m_BmAtkMtx[j].count() >
-			m_attackedBy[i].count()+m_BmAtkMtx[i].count()) {
+		} else if (degree(j) > degree(i)) {
 			i = j;
 		}
 	}
@@ -243,11 +675,294 @@ pair<size_type, PreferredReasoner::SELECT_TYPE> PreferredReasoner::selectArgumen
 	return make_pair(i, TYPE_B);
 }
 
+void PreferredReasoner::initLabelling(bitvector& _blank, bitvector& _in, 
+	bitvector& _out, bitvector& _undec, bitvector& _must_out)
+{
+	// We using five bitvector to encode the labellings of all arguments. 
+	// Each argument is merely labeled with one of the following five labellings.
+	_blank = bitvector::UniversalSet(m_argNum);  // At beginning, all arguments are labeled BLANK
+	_out = bitvector::EmptySet(m_argNum);   // Empty set
+	_in = bitvector::EmptySet(m_argNum);
+	_must_out = bitvector::EmptySet(m_argNum);
+	_undec = bitvector::EmptySet(m_argNum);
+
+	// Preprocessing
+	preprocessing(_blank, _in, _out, _undec);
+}
+
+bool PreferredReasoner::labelIn(const bitvector& _set, bitvector& _blank, bitvector& _in, 
+	bitvector& _out, bitvector& _undec, bitvector& _must_out)
+{
+	bitvector _tmp_must_out(m_argNum);
+	for (size_type i = _set.find_first(); i != bitvector::npos; i = _set.find_next(i))
+	{
+		if (_in[i])
+			continue;
+		if (!_blank[i])  // OUT, MUST_OUT or UNDEC
+			return false;
+
+		labelArgumentIn(i, _blank, _in, _out, _undec, _must_out, _tmp_must_out);
+	}
+
+	// An argument of _set may attack another one
+	return !_set.intersects(_out) && lookAhead(_blank, _must_out);
+}
+
+bool PreferredReasoner::findAdmissible(bitvector& _blank, bitvector& _in, 
+	bitvector& _out, bitvector& _undec, bitvector& _must_out, 
+	const vector<bitvector>& _blocked, bitvector& _found)
+{
+	size_type i;
+	SELECT_TYPE _s_type;
+
+	boost::tie(i, _s_type) = selectArgument(_blank, _out | _must_out);
+
+	while (i != bitvector::npos)
+	{
+		bitvector _reach(_in | _blank);
+		for (size_type k = 0; k < _blocked.size(); ++k) {
+			if (_reach.is_subset_of(_blocked[k]))
+				return false;
+		}
+
+		bitvector _blank_new(_blank);
+		bitvector _out_new(_out);
+		bitvector _in_new(_in);
+		bitvector _must_out_new(_must_out);
+		bitvector _undec_new(_undec);
+		bitvector _tmp_must_out(m_argNum);
+
+		labelArgumentIn(i, _blank_new, _in_new, _out_new, _undec_new, 
+			_must_out_new, _tmp_must_out);
+
+		bool forwardCheck = lookAhead(_blank_new, _must_out_new);
+		if (_s_type == TYPE_B)
+		{
+			if ( forwardCheck && findAdmissible(_blank_new, _in_new, _out_new, 
+					_undec_new, _must_out_new, _blocked, _found) )
+				return true;
+
+			_undec[i] = true;  _blank[i] = false;
+			if ( !lookAhead(_blank, _must_out) )
+				return false;
+		}
+		else   // TYPE_A
+		{
+			if ( !forwardCheck )
+				return false;
+
+			_blank = _blank_new;
+			_in = _in_new;
+			_out = _out_new;
+			_must_out = _must_out_new;
+			_undec = _undec_new;
+		}
+
+		boost::tie(i, _s_type) = selectArgument(_blank, _out | _must_out);
+	}
+
+	if ( !_must_out.is_emptyset() )
+		return false;
+	for (size_type k = 0; k < _blocked.size(); ++k) {
+		if (_in.is_subset_of(_blocked[k]))
+			return false;
+	}
+
+	_found = _in;
+	return true;
+}
+
+bool PreferredReasoner::findCredulous(const bitvector& _set, bitvector& _found)
+{
+	bitvector _blank, _in, _out, _undec, _must_out;
+	initLabelling(_blank, _in, _out, _undec, _must_out);
+
+	return labelIn(_set, _blank, _in, _out, _undec, _must_out) &&
+		findAdmissible(_blank, _in, _out, _undec, _must_out, vector<bitvector>(), _found);
+}
+
+bitvector PreferredReasoner::maximize(const bitvector& _adm)
+{
+	// Each admissible strict superset of the set found is searched in turn
+	vector<bitvector> _blocked(1, _adm);
+	bitvector _bigger;
+	for (;;) {
+		bitvector _blank, _in, _out, _undec, _must_out;
+		initLabelling(_blank, _in, _out, _undec, _must_out);
+		if ( !labelIn(_blocked[0], _blank, _in, _out, _undec, _must_out) ||
+			!findAdmissible(_blank, _in, _out, _undec, _must_out, _blocked, _bigger) )
+			return _blocked[0];
+		_blocked[0] = _bigger;
+	}
+}
+
+bool PreferredReasoner::isSkeptical(size_type _arg)
+{
+	if (getGroundedExtension()[_arg])
+		return true;
+
+	bitvector _blank, _in, _out, _undec, _must_out, _found;
+	initLabelling(_blank, _in, _out, _undec, _must_out);
+
+	// _arg is attacked by an unattacked argument, or it attacks itself
+	if (!_blank[_arg])
+		return false;
+
+	// An admissible set attacking _arg, i.e., _arg is MUST_OUT
+	bitvector _blank_atk(_blank), _in_atk(_in), _out_atk(_out), _undec_atk(_undec), 
+		_must_out_atk(_must_out);
+	_must_out_atk[_arg] = true; _blank_atk[_arg] = false;
+	if ( lookAhead(_blank_atk, _must_out_atk) && findAdmissible(_blank_atk, _in_atk, 
+			_out_atk, _undec_atk, _must_out_atk, vector<bitvector>(), _found) )
+		return false;
+
+	// The admissible sets excluding _arg, i.e., _arg is UNDEC
+	_undec[_arg] = true; _blank[_arg] = false;
+	vector<bitvector> _blocked;
+	for (;;) {
+		bitvector _blank_ex(_blank), _in_ex(_in), _out_ex(_out), _undec_ex(_undec), 
+			_must_out_ex(_must_out);
+		if ( !findAdmissible(_blank_ex, _in_ex, _out_ex, _undec_ex, _must_out_ex, 
+				_blocked, _found) )
+			return true;
+
+		// Maximal among the admissible sets excluding _arg
+		vector<bitvector> _smaller(1, _found);
+		for (;;) {
+			bitvector _blank_mx(_blank), _in_mx(_in), _out_mx(_out), _undec_mx(_undec), 
+				_must_out_mx(_must_out), _bigger;
+			if ( !labelIn(_smaller[0], _blank_mx, _in_mx, _out_mx, _undec_mx, _must_out_mx) ||
+				!findAdmissible(_blank_mx, _in_mx, _out_mx, _undec_mx, _must_out_mx, 
+					_smaller, _bigger) )
+				break;
+			_smaller[0] = _bigger;
+		}
+
+		// A preferred extension without _arg, unless it extends with _arg
+		bitvector _with(_smaller[0]);
+		_with[_arg] = true;
+		if ( !findCredulous(_with, _found) )
+			return false;
+
+		_blocked.push_back(_smaller[0]);
+	}
+}
+
+void PreferredReasoner::task_EE()
+{
+	printExtList([&](const ExtensionVisitor& _print) {
+		enumerateExtensions(_print);
+	});
+}
+
+void PreferredReasoner::task_EX()
+{
+	task_EE();
+}
+
+void PreferredReasoner::task_EC(const std::set<string>& argset)
+{
+	bitvector _arg_bv = m_daf.labelSet2bv(argset);
+	printExtList([&](const ExtensionVisitor& _print) {
+		enumerateExtensions([&](const bitvector& _bv) {
+			return !_arg_bv.is_subset_of(_bv) || _print(_bv);
+		});
+	});
+}
+
+void PreferredReasoner::task_SC(const std::set<string>& argset)
+{
+	if(argset.empty()) {
+		cerr << "The task SC needs additional argument (see option -a)" << endl;
+		exit(1);
+	}
+
+	bitvector _found;
+	if ( findCredulous(m_daf.labelSet2bv(argset), _found) ) {
+		printLabSet( maximize(_found) );
+		m_output << endl;
+	} else {
+		m_output << STR_NO << endl;
+	}
+}
+
+void PreferredReasoner::task_SE()
+{
+	// The empty set is admissible
+	printLabSet( maximize(bitvector::EmptySet(m_argNum)) );
+	m_output << endl;
+}
+
+void PreferredReasoner::task_DE(const std::set<string>& argset)
+{
+	bitvector _arg_bv = m_daf.labelSet2bv(argset);
+	bool _is_ext = false;
+	if ( is_admissible(_arg_bv) ) {
+		bitvector _blank, _in, _out, _undec, _must_out, _bigger;
+		initLabelling(_blank, _in, _out, _undec, _must_out);
+		_is_ext = !labelIn(_arg_bv, _blank, _in, _out, _undec, _must_out) ||
+			!findAdmissible(_blank, _in, _out, _undec, _must_out, 
+				vector<bitvector>(1, _arg_bv), _bigger);
+	}
+
+	m_output << (_is_ext ? STR_YES : STR_NO) << endl;
+}
+
+void PreferredReasoner::task_DN()
+{
+	bitvector _blank, _in, _out, _undec, _must_out, _found;
+	initLabelling(_blank, _in, _out, _undec, _must_out);
+
+	bool _found_ne = findAdmissible(_blank, _in, _out, _undec, _must_out, 
+		vector<bitvector>(1, bitvector::EmptySet(m_argNum)), _found);
+	m_output << (_found_ne ? STR_YES : STR_NO) << endl;
+}
+
+void PreferredReasoner::task_DC(const std::set<string>& argset)
+{
+	if(argset.empty()) {
+		cerr << "The task DC needs additional argument (see option -a)" << endl;
+		exit(1);
+	}
+
+	bitvector _found;
+	bool _credulous = findCredulous(m_daf.labelSet2bv(argset), _found);
+	m_output << (_credulous ? STR_YES : STR_NO) << endl;
+}
+
+void PreferredReasoner::task_DS(const std::set<string>& argset)
+{
+	if(argset.empty()) {
+		cerr << "The task DS needs additional argument (see option -a)" << endl;
+		exit(1);
+	}
+
+	bitvector _arg_bv = m_daf.labelSet2bv(argset);
+	bool _skeptical = true;
+	for (size_type i = _arg_bv.find_first(); _skeptical && i != bitvector::npos; 
+		i = _arg_bv.find_next(i))
+	{
+		_skeptical = isSkeptical(i);
+	}
+
+	m_output << (_skeptical ? STR_YES : STR_NO) << endl;
+}
+
 bitvector PreferredReasoner::getAttackers(const bitvector& _bv)
 {
 	assert( _bv.size() == m_argNum );
 
-	return m_attackedBy * _bv;
+	if (m_isDense)
+		return m_attackedBy * _bv;
+
+	// The union of the attackers of the arguments of _bv
+	bitvector _res(m_argNum);
+	for (size_type j = _bv.find_first(); j != bitvector::npos; j = _bv.find_next(j)) {
+		sparsematrix::const_iterator it = m_SpAtkMtx.row_begin(j), _end = m_SpAtkMtx.row_end(j);
+		for ( ; it != _end; ++it)
+			_res.set(*it);
+	}
+	return _res;
 }
 
 } // namespace argumatrix
@@ -14,6 +14,7 @@
 #include <utility>   
 #include <algorithm>   
 #include <iosfwd>
+#include <functional>
 
 //boost
 #include <boost/graph/graph_traits.hpp> 
@@ -24,16 +25,35 @@
 #include "AttackProperty.hpp"
 #include "bitmatrix/bitvector.hpp"
 #include "bitmatrix/bitmatrix.hpp"
+#include "bitmatrix/sparsematrix.hpp"
 #include "DungAF.hpp"
+#include "GroundedLabelling.hpp"
+#include "ExtensionWriter.hpp"
 
 
 namespace argumatrix{
 
 using namespace std;
 
+/**
+ * @brief How a reasoner stores the attack matrix. The sparse matrix is always
+ * built; the dense bitmatrix m_BmAtkMtx is built for DENSE_MATRIX, or for 
+ * AUTO_MATRIX if the density of attacks reaches SPARSE_DENSITY_THRESHOLD.
+ * Reasoners working on the rows of m_BmAtkMtx must require DENSE_MATRIX, or
+ * fall back to the lists of m_SpAtkMtx unless isDense().
+ */
+enum MatrixStorage { AUTO_MATRIX, DENSE_MATRIX, SPARSE_MATRIX };
+
+/**
+ * @brief Called with each extension enumerated by a reasoner, returns false
+ * to stop the enumeration.
+ */
+typedef std::function<bool(const bitvector&)> ExtensionVisitor;
+
 class Reasoner {
 public:
-	Reasoner(const DungAF& daf, streambuf* osbuff = std::cout.rdbuf());
+	Reasoner(const DungAF& daf, streambuf* osbuff = std::cout.rdbuf(),
+		MatrixStorage storage = AUTO_MATRIX);
 	virtual ~Reasoner() {}
 	/**
 	 * @brief Get the attacked arguments by arguments in _bv, \f$R^+(S)\f$ 
@@ -45,6 +65,12 @@ public:
 	bitvector getAttacked(const bitvector& _bv);
 	//bitvector R_plus(const bitvector& _bv);	
 
+	/**
+	 * @brief Whether the dense attack matrix m_BmAtkMtx is available. If not,
+	 * only the sparse attack matrix m_SpAtkMtx is.
+	 */
+	bool isDense() const { return m_isDense; }
+
 	/**
 	 * @brief The characteristic function of an abstract argumentation framework: 
 	 * \f$F_{AF}(S) = {A|A is acceptable wrt. S}\f$.
@@ -155,13 +181,30 @@ public:
 	 */
 	const set<bitvector>& getBvExtensions();
 
+	/**
+	 * @brief Enumerate the extensions of the semantics of the reasoner, e.g.,
+	 * to combine them with the extensions of other frameworks (see SccReasoner).
+	 * @param visit called with each extension, returns false to stop.
+	 * @return the number of the extensions visited. A reasoner which does not
+	 * implement it exits, since no extension would be taken as an answer.
+	 */
+	virtual size_type enumerateExtensions(const ExtensionVisitor& /*visit*/)
+	{ cerr << "Unimplemented!" << endl; exit(1); }
+
 
 	/**
 	 * @brief Get a vector of integers {0, 1, 2}: 2 -- Unknown, 1 -- in grounded
 	 * extension, and 0 -- attacked by the grounded extension.
+	 * The grounded labelling is computed once, by groundedLabelling().
 	 * @return a vector of integers {0, 1, 2}.
 	 */
-	vector<int> getGroundedIntVector();
+	const vector<int>& getGroundedIntVector();
+
+	/**
+	 * @brief Take the grounded labelling of the framework computed elsewhere,
+	 * e.g., maintained by IncrementalGrounded, instead of computing it.
+	 */
+	void setGroundedIntVector(const vector<int>& labels);
 
 	/**
 	 * @brief Redirect the output stream to streambuf* strbuf or ostream& os. If strbuf = cout.rdbuf(),
@@ -191,6 +234,36 @@ public:
 	 */
 	streambuf* setOutput(ostream& os = std::cout);
 
+	/**
+	 * @brief Set the number of threads the reasoner may use. The reasoners
+	 * without a parallel mode ignore it.
+	 * @param _num the number of threads, 1 (the default) means sequential.
+	 */
+	virtual void setThreadNum(size_type _num) { m_threadNum = _num < 1 ? 1 : _num; }
+
+	/**
+	 * @brief Set the window of the extensions printed by the enumeration tasks
+	 * (e.g., EE, EX and EC): the first _offset extensions are skipped, and at
+	 * most _limit extensions are printed, 0 for no limit. The enumeration
+	 * stops as soon as the window is printed.
+	 */
+	void setEnumerationWindow(size_type _offset, size_type _limit)
+	{ m_offset = _offset; m_limit = _limit; }
+
+	/**
+	 * @brief Flush the output after every _num extensions printed by the
+	 * enumeration tasks, so that a consumer reads them as they are found. 0
+	 * (the default) leaves the flushing to the stream.
+	 */
+	void setFlushInterval(size_type _num) { m_flushEvery = _num; }
+
+	/**
+	 * @brief Set how the enumeration tasks print an extension, e.g., the
+	 * compact FORMAT_INDICES or FORMAT_BITS for the large outputs (see
+	 * ExtensionFormat).
+	 */
+	void setOutputFormat(ExtensionFormat _format) { m_outputFormat = _format; }
+
 	/**
 	 * @brief Print an extension with the form of bitvector. Assume the bitvector 
 	 * is [0, 1, 0, 1], the arguments corresponding to entry 1 will
@@ -330,14 +403,51 @@ public:
 	virtual void task_DS(const std::set<string>& argset) 
 	{ cerr << "Unimplemented!" << endl; }
 
+	/**
+	 * @brief Decide a batch of the problems DC-$\sigma$ (or DS-$\sigma$ if
+	 * skeptical), e.g., the queries of a batch file, and print the answers in
+	 * order, as task_DC() (or task_DS()) does for each of them. The reasoners
+	 * which decide the queries concurrently override it.
+	 */
+	virtual void task_DBatch(const vector< std::set<string> >& queries, bool skeptical);
+
 protected:
+	/**
+	 * @brief Print the extensions visited by produce in the form of
+	 * [[a,b],[c]], followed by a new line. The extensions are printed as they
+	 * are visited by an ExtensionWriter in the format of setOutputFormat(),
+	 * within the window of setEnumerationWindow() and with the flush policy
+	 * of setFlushInterval(), and are not stored.
+	 * @param produce called with the ExtensionVisitor printing an extension,
+	 * which returns false when the window is printed.
+	 */
+	template<class Producer>
+	void printExtList(Producer produce);
+
 	bitmatrix m_BmAtkMtx;  /**< The bitmatrix of the Dung Abstract argumentation framework. We can 
 	* access all attackers of an argument. The attackers of the argument 
-	* with index i is m_BmAtkMtx[i].
+	* with index i is m_BmAtkMtx[i]. It is empty unless isDense().
 	*/
 
+	sparsematrix m_SpAtkMtx;  /**< The attack matrix in sparse form, always available. 
+	* The attackers of the argument with index i are in the i-th row, and the 
+	* arguments attacked by the argument with index j are in the j-th column.
+	*/
+
+	bool m_isDense;  /**< Whether m_BmAtkMtx is built */
+
+	vector<int> m_grLabels;  /**< The grounded labelling, see getGroundedIntVector() */
+	bool m_grComputed;       /**< Whether m_grLabels is computed */
+
 	size_type m_argNum; /**< The number of arguments */
 
+	size_type m_threadNum; /**< The number of threads, see setThreadNum() */
+
+	size_type m_offset;     /**< The extensions skipped, see setEnumerationWindow() */
+	size_type m_limit;      /**< The extensions printed at most, 0 for no limit */
+	size_type m_flushEvery; /**< See setFlushInterval() */
+	ExtensionFormat m_outputFormat; /**< See setOutputFormat() */
+
 
 	const DungAF&	  m_daf;  /**< Dung's abstract argumentation framework */
 
@@ -348,11 +458,24 @@ protected:
 	std::ostream m_output; /**< Where to output */
 };
 
-Reasoner::Reasoner(const DungAF& daf, streambuf* osbuff /*= std::cout.rdbuf()*/):
-	m_daf(daf), m_output(osbuff)
+Reasoner::Reasoner(const DungAF& daf, streambuf* osbuff /*= std::cout.rdbuf()*/,
+	MatrixStorage storage /*= AUTO_MATRIX*/):
+	m_grComputed(false), m_daf(daf), m_output(osbuff)
 { 
 	m_argNum = m_daf.getNumberOfArguments();
-	m_BmAtkMtx = m_daf.getAttackMatrix();
+	m_threadNum = 1;
+	m_offset = 0;
+	m_limit = 0;
+	m_flushEvery = 0;
+	m_outputFormat = FORMAT_LABELS;
+	m_SpAtkMtx = m_daf.getSparseAttackMatrix();
+	m_isDense = (storage == DENSE_MATRIX) || (storage == AUTO_MATRIX &&
+		m_SpAtkMtx.density() >= SPARSE_DENSITY_THRESHOLD);
+	if (m_isDense) {
+		// Reuse the matrix of the framework, e.g., loaded from a snapshot
+		m_BmAtkMtx = m_daf.hasAttackMatrix() ? m_daf.getAttackMatrix()
+			: m_SpAtkMtx.toBitmatrix();
+	}
 	m_argLabels = m_daf.getArgumentLabels();
 }
 
@@ -361,7 +484,7 @@ argumatrix::bitvector Reasoner::getAttacked(const bitvector& _bv)
 {
 	//assert( _bv.size() == m_argNum );
 
-	return m_BmAtkMtx * _bv;
+	return m_isDense ? m_BmAtkMtx * _bv : m_SpAtkMtx * _bv;
 }
 
 __inline
@@ -407,7 +530,7 @@ bool Reasoner::is_self_attacking(size_type idx)
 {
 	// assert(idx < m_argNum);
 
-	return m_BmAtkMtx[idx][idx];
+	return m_SpAtkMtx.test(idx, idx);
 }
 
 __inline
@@ -421,7 +544,7 @@ argumatrix::bitvector Reasoner::getSelfAttackingArguments()
 
 	//return _bv;
 
-	return m_BmAtkMtx.diag();
+	return m_SpAtkMtx.diag();
 }
 
 __inline
@@ -469,6 +592,45 @@ void Reasoner::printLabSet(const std::set<string>& labset)
 	m_output << RIGHT_LIMITER;
 }
 
+void Reasoner::task_DBatch(const vector< std::set<string> >& queries, bool skeptical)
+{
+	for (size_type q = 0; q < queries.size(); ++q) {
+		if (skeptical)
+			task_DS(queries[q]);
+		else
+			task_DC(queries[q]);
+	}
+}
+
+template<class Producer>
+void Reasoner::printExtList(Producer produce)
+{
+	bool first = true;
+	size_type _visited = 0, _printed = 0;
+	ExtensionWriter _writer(m_argLabels, m_output, m_outputFormat);
+	ExtensionVisitor _print = [&](const bitvector& _bv) {
+		if (_visited++ < m_offset)
+			return true;
+
+		if(first){
+			first = false;
+		} else {
+			_writer.put(DELIMITER); // ","
+		}
+		_writer.putExtension(_bv);
+
+		++_printed;
+		if (m_flushEvery != 0 && _printed % m_flushEvery == 0)
+			_writer.flush();
+		return m_limit == 0 || _printed < m_limit;
+	};
+
+	_writer.put(LEFT_LIMITER);  // [
+	produce(_print);
+	_writer.put(RIGHT_LIMITER);
+	_writer.put('\n');
+}
+
 __inline
 streambuf* Reasoner::setOutput(streambuf* strbuf)
 {
@@ -483,44 +645,25 @@ streambuf* Reasoner::setOutput(ostream& os /*= std::cout*/)
 
 argumatrix::bitvector Reasoner::getGroundedExtension()
 {
-	bitvector _bv = bitvector::EmptySet(m_argNum);
-	bitvector _bv_next = characteristic(_bv);
-
-	while (_bv != _bv_next)
-	{
-		_bv = _bv_next;
-		_bv_next = characteristic(_bv);
-	}
-
-	return _bv_next;
+	return labelsIn( getGroundedIntVector() );
 }
 
 
-vector<int> Reasoner::getGroundedIntVector()
+const vector<int>& Reasoner::getGroundedIntVector()
 {
-	// create m_argNum length vector with initial value 2 -- Unknown
-	vector<int> vecii(m_argNum, 2);
-
-	bitvector gr_ext = bitvector::EmptySet(m_argNum);
-	bitvector gr_out;
-	bitvector _bv_last;
-	do {
-		_bv_last = gr_ext;
-		//gr_out = (m_BmAtkMtx * _bv_last); // S =  R^+(X)
-		//gr_ext = ~(m_BmAtkMtx * (~gr_out)); // G = ~R^+(~S)
-		gr_out = getAttacked( _bv_last ); // S =  R^+(X)
-		gr_ext = neutrality( ~gr_out ); // G = ~R^+(~S)
-	} while (gr_ext != _bv_last);
-
-	// cout << "gr_ext" << gr_ext << endl;
-
-	for(size_type i=0; i<m_argNum; ++i)
-	{
-		if( gr_ext[i] ) { vecii[i] = 1; }
-		else if ( gr_out[i] ) { vecii[i] = 0; }
+	if (!m_grComputed) {
+		groundedLabelling(m_SpAtkMtx, m_grLabels);
+		m_grComputed = true;
 	}
 
-	return vecii;
+	return m_grLabels;
+}
+
+void Reasoner::setGroundedIntVector(const vector<int>& labels)
+{
+	assert(labels.size() == m_argNum);
+	m_grLabels = labels;
+	m_grComputed = true;
 }
 
 vector<int> Reasoner::labelSet2IntVector(const std::set<string>& label_set)
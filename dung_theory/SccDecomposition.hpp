@@ -0,0 +1,152 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// The strongly connected components of an argumentation framework
+//=======================================================================
+
+#ifndef DUNG_SCC_DECOMPOSITION_HPP
+#define DUNG_SCC_DECOMPOSITION_HPP
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+#include "config/config.hpp"
+#include "DungAF.hpp"
+
+
+namespace argumatrix{
+
+using namespace std;
+
+/**
+ * @brief The strongly connected components (SCCs) of the argument graph, in a
+ * topological order: the attackers of the arguments of the k-th component
+ * are in the components 0, ..., k. The components are computed by Tarjan's
+ * algorithm, with an explicit stack instead of the recursion, in O(|A|+|R|).
+ * ~~~~~{.cpp}
+ *   SccDecomposition _scc(daf);
+ *   for (size_type k = 0; k < _scc.size(); ++k)
+ *       for (SccDecomposition::const_iterator a = _scc.begin(k); a != _scc.end(k); ++a)
+ *           ...
+ * ~~~~~
+ */
+class SccDecomposition {
+public:
+	typedef DungAF::const_iterator const_iterator;
+
+	explicit SccDecomposition(const DungAF& daf);
+
+	// The number of the components
+	size_type size() const { return m_sccPtr.size() - 1; }
+
+	// The arguments of the k-th component
+	const_iterator begin(size_type k) const { return m_args.data() + m_sccPtr[k]; }
+	const_iterator end(size_type k) const { return m_args.data() + m_sccPtr[k+1]; }
+	size_type count(size_type k) const { return m_sccPtr[k+1] - m_sccPtr[k]; }
+
+	// The component of the argument _arg
+	size_type component(size_type _arg) const { return m_comp[_arg]; }
+
+	// The number of the arguments of the largest component
+	size_type maxCount() const;
+
+private:
+	vector<Argument> m_args;    /**< The arguments grouped by their components */
+	vector<Argument> m_sccPtr;  /**< The k-th component is m_args[m_sccPtr[k], m_sccPtr[k+1]) */
+	vector<Argument> m_comp;    /**< The component of each argument */
+};
+
+
+SccDecomposition::SccDecomposition(const DungAF& daf)
+{
+	const size_type n = daf.getNumberOfArguments();
+	const Argument _none = (Argument)-1;
+
+	// The discovery order and the lowest reachable discovery order
+	vector<Argument> _index(n, _none);
+	vector<Argument> _low(n);
+	vector<bool> _onStack(n, false);
+	vector<Argument> _stack;
+	// The explicit call stack, an argument and its next attacked argument
+	vector< pair<Argument, const_iterator> > _calls;
+	Argument _counter = 0;
+
+	// The components in the order found by Tarjan's algorithm, i.e., the
+	// reverse of a topological order
+	vector<Argument> _args;
+	vector<Argument> _ptr(1, 0);
+	_args.reserve(n);
+
+	for (Argument r = 0; r < n; ++r) {
+		if (_index[r] != _none)
+			continue;
+
+		_index[r] = _low[r] = _counter++;
+		_stack.push_back(r);
+		_onStack[r] = true;
+		_calls.push_back(make_pair(r, daf.attacked_begin(r)));
+
+		while (!_calls.empty()) {
+			Argument v = _calls.back().first;
+			if (_calls.back().second != daf.attacked_end(v)) {
+				Argument w = *_calls.back().second++;
+				if (_index[w] == _none) {
+					_index[w] = _low[w] = _counter++;
+					_stack.push_back(w);
+					_onStack[w] = true;
+					_calls.push_back(make_pair(w, daf.attacked_begin(w)));
+				} else if (_onStack[w]) {
+					_low[v] = min(_low[v], _index[w]);
+				}
+				continue;
+			}
+
+			// All the arguments attacked by v are visited
+			_calls.pop_back();
+			if (!_calls.empty()) {
+				Argument u = _calls.back().first;
+				_low[u] = min(_low[u], _low[v]);
+			}
+
+			// v is the root of a component
+			if (_low[v] == _index[v]) {
+				Argument w;
+				do {
+					w = _stack.back();
+					_stack.pop_back();
+					_onStack[w] = false;
+					_args.push_back(w);
+				} while (w != v);
+				_ptr.push_back((Argument)_args.size());
+			}
+		}
+	}
+
+	// Reverse the order of the components, and sort the arguments of each
+	// component by their indices
+	const size_type _num = _ptr.size() - 1;
+	m_args.reserve(n);
+	m_sccPtr.assign(1, 0);
+	m_comp.resize(n);
+	for (size_type k = _num; k > 0; --k) {
+		m_args.insert(m_args.end(), _args.begin() + _ptr[k-1], _args.begin() + _ptr[k]);
+		std::sort(m_args.begin() + m_sccPtr.back(), m_args.end());
+		for (size_type j = m_sccPtr.back(); j < m_args.size(); ++j)
+			m_comp[m_args[j]] = (Argument)(m_sccPtr.size() - 1);
+		m_sccPtr.push_back((Argument)m_args.size());
+	}
+}
+
+size_type SccDecomposition::maxCount() const
+{
+	size_type _max = 0;
+	for (size_type k = 0; k < size(); ++k)
+		_max = max(_max, count(k));
+	return _max;
+}
+
+} // namespace argumatrix
+
+#endif  // DUNG_SCC_DECOMPOSITION_HPP
@@ -0,0 +1,416 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// A reasoner splitting the framework by its strongly connected components
+//=======================================================================
+
+#ifndef DUNG_SCC_REASONER_HPP
+#define DUNG_SCC_REASONER_HPP
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <functional>
+
+#include "config/config.hpp"
+#include "bitmatrix/bitvector.hpp"
+#include "DungAF.hpp"
+#include "Reasoner.hpp"
+#include "GroundedLabelling.hpp"
+#include "SccDecomposition.hpp"
+
+
+namespace argumatrix{
+
+using namespace std;
+
+/**
+ * @brief The semantics which can be computed component by component.
+ */
+enum SccSemantics { SCC_COMPLETE, SCC_STABLE, SCC_PREFERRED };
+
+/**
+ * @brief Create a reasoner of the semantics for a component, see SccReasoner.
+ */
+typedef std::function<Reasoner*(const DungAF&)> ReasonerFactory;
+
+/**
+ * @brief This reasoner splits the framework into its strongly connected
+ * components (SCCs), and computes the extensions of the components in a
+ * topological order (Baroni et al., SCC-recursiveness): each labelling of the
+ * upstream components fixes the input of a component, whose extensions are
+ * computed by a reasoner of the same semantics on the component alone. So that
+ * the solver only sees one component at a time, instead of the whole framework.
+ *
+ * The input of a component is encoded into its local framework by two
+ * auxiliary arguments: an unattacked argument attacking the arguments attacked
+ * by an upstream IN argument, and a self-attacking argument attacking the
+ * arguments attacked by an upstream UNDEC argument (and by no upstream IN
+ * argument). The extensions of a local framework are cached by its input,
+ * since many upstream labellings give the same input. The singleton components
+ * without self-attack have a unique labelling, and are labelled directly.
+ *
+ * Note that the local extensions of the preferred semantics must be computed
+ * under the complete semantics restricted to the maximal ones, which is what
+ * a preferred reasoner does on the local framework.
+ */
+class SccReasoner : public Reasoner {
+public:
+	/**
+	 * @param sem the semantics of the reasoners created by factory.
+	 * @param factory create a reasoner of the semantics sem for a local
+	 * framework, whose extensions are enumerated by enumerateExtensions().
+	 */
+	SccReasoner(const DungAF& daf, SccSemantics sem, const ReasonerFactory& factory,
+		streambuf* osbuff = std::cout.rdbuf());
+
+	const SccDecomposition& getDecomposition() const { return m_scc; }
+
+	// Enumerate the extensions component by component
+	size_type enumerateExtensions(const ExtensionVisitor& visit);
+
+	void task_EE();
+	void task_SE();
+	void task_EC(const std::set<string>& argset);
+	void task_SC(const std::set<string>& argset);
+	void task_DC(const std::set<string>& argset);
+	void task_DS(const std::set<string>& argset);
+	void task_DN();
+	void task_DE(const std::set<string>& argset);
+
+private:
+	/**
+	 * @brief Extend the labelling of the components 0, ..., k-1 to the
+	 * components k, ... . The components with a unique labelling are labelled
+	 * in a loop, only a component with several local extensions recurses, so
+	 * that the depth is bounded by the number of such components.
+	 * @return false if the enumeration was stopped by visit.
+	 */
+	bool search(size_type k, const ExtensionVisitor& visit);
+
+	// The label of the singleton component {_arg}, given the upstream labels
+	int labelSingleton(Argument _arg) const;
+
+	/**
+	 * @brief The input of the k-th component: the character j is '1' if its
+	 * j-th argument is attacked by an upstream IN argument, '2' if by an
+	 * upstream UNDEC argument only, and '0' otherwise.
+	 */
+	string getInput(size_type k) const;
+
+	// The local extensions of the k-th component with the input _input
+	const vector<bitvector>& solveComponent(size_type k, const string& _input);
+
+	// Label the k-th component by the local extension _ext
+	void applyExtension(size_type k, const string& _input, const bitvector& _ext);
+
+	SccSemantics m_semantics;
+	ReasonerFactory m_factory;
+	SccDecomposition m_scc;
+
+	vector<int> m_labels;       /**< The labels of the current branch, LAB_* */
+	bitvector m_ext;            /**< The IN arguments of the current branch */
+	vector<Argument> m_trail;   /**< The IN arguments in the order they were set */
+	vector<Argument> m_local;   /**< The index of each argument in its component */
+	vector< map<string, vector<bitvector> > > m_cache;  /**< The local extensions by input */
+};
+
+
+SccReasoner::SccReasoner(const DungAF& daf, SccSemantics sem, const ReasonerFactory& factory,
+	streambuf* osbuff /*= std::cout.rdbuf()*/):
+	Reasoner(daf, osbuff, SPARSE_MATRIX),
+	m_semantics(sem),
+	m_factory(factory),
+	m_scc(daf)
+{
+	m_labels.assign(m_argNum, LAB_UNDEC);
+	m_ext = bitvector::EmptySet(m_argNum);
+	m_cache.resize(m_scc.size());
+
+	m_local.resize(m_argNum);
+	for (size_type k = 0; k < m_scc.size(); ++k) {
+		Argument j = 0;
+		for (SccDecomposition::const_iterator a = m_scc.begin(k); a != m_scc.end(k); ++a)
+			m_local[*a] = j++;
+	}
+}
+
+__inline
+int SccReasoner::labelSingleton(Argument _arg) const
+{
+	bool _undec = false;
+	for (sparsematrix::const_iterator b = m_SpAtkMtx.row_begin(_arg);
+		b != m_SpAtkMtx.row_end(_arg); ++b) {
+		// A self-attacking argument is never IN
+		if (*b == _arg)
+			_undec = true;
+		else if (m_labels[*b] == LAB_IN)
+			return LAB_OUT;
+		else if (m_labels[*b] == LAB_UNDEC)
+			_undec = true;
+	}
+	return _undec ? LAB_UNDEC : LAB_IN;
+}
+
+string SccReasoner::getInput(size_type k) const
+{
+	string _input(m_scc.count(k), '0');
+	for (SccDecomposition::const_iterator a = m_scc.begin(k); a != m_scc.end(k); ++a) {
+		char& _c = _input[m_local[*a]];
+		for (sparsematrix::const_iterator b = m_SpAtkMtx.row_begin(*a);
+			b != m_SpAtkMtx.row_end(*a); ++b) {
+			if (m_scc.component(*b) == k)
+				continue;
+			if (m_labels[*b] == LAB_IN) {
+				_c = '1';
+				break;
+			}
+			if (m_labels[*b] == LAB_UNDEC)
+				_c = '2';
+		}
+	}
+	return _input;
+}
+
+const vector<bitvector>& SccReasoner::solveComponent(size_type k, const string& _input)
+{
+	map<string, vector<bitvector> >::iterator _itr = m_cache[k].find(_input);
+	if (_itr != m_cache[k].end())
+		return _itr->second;
+
+	const size_type m = m_scc.count(k);
+	DungAF _local;
+	_local.reserve(m + 2);
+	for (size_type j = 0; j < m; ++j)
+		_local.addArgument(to_string(j));
+
+	for (SccDecomposition::const_iterator a = m_scc.begin(k); a != m_scc.end(k); ++a) {
+		for (sparsematrix::const_iterator b = m_SpAtkMtx.row_begin(*a);
+			b != m_SpAtkMtx.row_end(*a); ++b) {
+			if (m_scc.component(*b) == k)
+				_local.addAttack(m_local[*b], m_local[*a]);
+		}
+	}
+
+	// The auxiliary arguments of the input
+	if (_input.find('1') != string::npos) {
+		Argument _in = _local.addArgument("#in");
+		for (size_type j = 0; j < m; ++j)
+			if (_input[j] == '1')
+				_local.addAttack(_in, (Argument)j);
+	}
+	if (_input.find('2') != string::npos) {
+		Argument _undec = _local.addArgument("#undec");
+		_local.addAttack(_undec, _undec);
+		for (size_type j = 0; j < m; ++j)
+			if (_input[j] == '2')
+				_local.addAttack(_undec, (Argument)j);
+	}
+
+	vector<bitvector>& _exts = m_cache[k][_input];
+	std::unique_ptr<Reasoner> _rsner(m_factory(_local));
+	_rsner->enumerateExtensions([&](const bitvector& _bv) {
+		bitvector _ext = bitvector::EmptySet(m);
+		for (size_type j = 0; j < m; ++j)
+			if (_bv[j])
+				_ext.set(j);
+		_exts.push_back(_ext);
+		return true;
+	});
+	return _exts;
+}
+
+void SccReasoner::applyExtension(size_type k, const string& _input, const bitvector& _ext)
+{
+	for (SccDecomposition::const_iterator a = m_scc.begin(k); a != m_scc.end(k); ++a) {
+		if (_ext[m_local[*a]]) {
+			m_labels[*a] = LAB_IN;
+			m_ext.set(*a);
+			m_trail.push_back(*a);
+		}
+	}
+
+	for (SccDecomposition::const_iterator a = m_scc.begin(k); a != m_scc.end(k); ++a) {
+		if (_ext[m_local[*a]])
+			continue;
+		m_labels[*a] = (_input[m_local[*a]] == '1') ? LAB_OUT : LAB_UNDEC;
+		for (sparsematrix::const_iterator b = m_SpAtkMtx.row_begin(*a);
+			m_labels[*a] == LAB_UNDEC && b != m_SpAtkMtx.row_end(*a); ++b) {
+			if (m_scc.component(*b) == k && _ext[m_local[*b]])
+				m_labels[*a] = LAB_OUT;
+		}
+	}
+}
+
+bool SccReasoner::search(size_type k, const ExtensionVisitor& visit)
+{
+	// The labels of the later components are overwritten before they are
+	// read, only the IN arguments of this call are undone on return.
+	const size_type _mark = m_trail.size();
+	bool _continue = true;
+	bool _dead = false;
+
+	for ( ; k < m_scc.size() && !_dead; ++k) {
+		if (m_scc.count(k) == 1) {
+			Argument _arg = *m_scc.begin(k);
+			int _lab = labelSingleton(_arg);
+			if (_lab == LAB_UNDEC && m_semantics == SCC_STABLE) {
+				_dead = true;
+				continue;
+			}
+			m_labels[_arg] = _lab;
+			if (_lab == LAB_IN) {
+				m_ext.set(_arg);
+				m_trail.push_back(_arg);
+			}
+			continue;
+		}
+
+		const string _input = getInput(k);
+		const vector<bitvector>& _exts = solveComponent(k, _input);
+		if (_exts.empty()) {
+			_dead = true;
+			continue;
+		}
+		if (_exts.size() == 1) {
+			applyExtension(k, _input, _exts[0]);
+			continue;
+		}
+
+		// Branch on the local extensions
+		for (size_type e = 0; e < _exts.size() && _continue; ++e) {
+			const size_type _branch = m_trail.size();
+			applyExtension(k, _input, _exts[e]);
+			_continue = search(k + 1, visit);
+			for ( ; m_trail.size() > _branch; m_trail.pop_back())
+				m_ext.reset(m_trail.back());
+		}
+		_dead = true;  // All the branches are done
+	}
+
+	if (!_dead)
+		_continue = visit(m_ext);
+
+	for ( ; m_trail.size() > _mark; m_trail.pop_back())
+		m_ext.reset(m_trail.back());
+	return _continue;
+}
+
+size_type SccReasoner::enumerateExtensions(const ExtensionVisitor& visit)
+{
+	size_type _num = 0;
+	search(0, [&](const bitvector& _bv) {
+		++_num;
+		return visit(_bv);
+	});
+	return _num;
+}
+
+void SccReasoner::task_EE()
+{
+	printExtList([&](const ExtensionVisitor& _print) {
+		enumerateExtensions(_print);
+	});
+}
+
+void SccReasoner::task_SE()
+{
+	bool _found = false;
+	enumerateExtensions([&](const bitvector& _bv) {
+		printLabSet(_bv);
+		m_output << endl;
+		_found = true;
+		return false;  // Stop at the first one
+	});
+
+	if (!_found)
+		m_output << STR_NO << endl;
+}
+
+void SccReasoner::task_EC(const std::set<string>& argset)
+{
+	bitvector _arg_bv = m_daf.labelSet2bv(argset);
+	printExtList([&](const ExtensionVisitor& _print) {
+		enumerateExtensions([&](const bitvector& _bv) {
+			return !_arg_bv.is_subset_of(_bv) || _print(_bv);
+		});
+	});
+}
+
+void SccReasoner::task_SC(const std::set<string>& argset)
+{
+	bitvector _arg_bv = m_daf.labelSet2bv(argset);
+	bool _found = false;
+	enumerateExtensions([&](const bitvector& _bv) {
+		if (!_arg_bv.is_subset_of(_bv))
+			return true;
+		printLabSet(_bv);
+		m_output << endl;
+		_found = true;
+		return false;
+	});
+
+	if (!_found)
+		m_output << STR_NO << endl;
+}
+
+void SccReasoner::task_DC(const std::set<string>& argset)
+{
+	bitvector _arg_bv = m_daf.labelSet2bv(argset);
+	bool _found = false;
+	enumerateExtensions([&](const bitvector& _bv) {
+		_found = _arg_bv.is_subset_of(_bv);
+		return !_found;
+	});
+
+	m_output << (_found ? STR_YES : STR_NO) << endl;
+}
+
+void SccReasoner::task_DS(const std::set<string>& argset)
+{
+	// There must be an extension, and all the extensions contain argset
+	bitvector _arg_bv = m_daf.labelSet2bv(argset);
+	bool _skeptical = true;
+	size_type _num = enumerateExtensions([&](const bitvector& _bv) {
+		_skeptical = _arg_bv.is_subset_of(_bv);
+		return _skeptical;
+	});
+
+	m_output << ((_num > 0 && _skeptical) ? STR_YES : STR_NO) << endl;
+}
+
+void SccReasoner::task_DN()
+{
+	bool _found = false;
+	enumerateExtensions([&](const bitvector& _bv) {
+		_found = _bv.any();
+		return !_found;
+	});
+
+	m_output << (_found ? STR_YES : STR_NO) << endl;
+}
+
+void SccReasoner::task_DE(const std::set<string>& argset)
+{
+	bitvector _arg_bv = m_daf.labelSet2bv(argset);
+	bool _is_ext = false;
+	if (m_semantics == SCC_COMPLETE) {
+		_is_ext = is_complete(_arg_bv);
+	} else if (m_semantics == SCC_STABLE) {
+		_is_ext = is_stable(_arg_bv);
+	} else if (is_complete(_arg_bv)) {
+		enumerateExtensions([&](const bitvector& _bv) {
+			_is_ext = (_bv == _arg_bv);
+			return !_is_ext;
+		});
+	}
+
+	m_output << (_is_ext ? STR_YES : STR_NO) << endl;
+}
+
+} // namespace argumatrix
+
+#endif  // DUNG_SCC_REASONER_HPP
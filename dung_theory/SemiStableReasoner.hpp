@@ -0,0 +1,218 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// Dung's abstract argumentation framework
+//=======================================================================
+
+#ifndef DUNG_SEMI_STABLE_REASONER_HPP
+#define DUNG_SEMI_STABLE_REASONER_HPP
+
+#include <iostream>
+#include <string>
+#include <map>
+#include <mutex>
+
+#include "config/config.hpp"
+#include "bitmatrix/bitvector.hpp"
+#include "DungAF.hpp"
+#include "PreferredReasoner.hpp"
+
+
+namespace argumatrix{
+
+using namespace std;
+
+/**
+* This reasoner for Dung theories performs inference on the semi-stable
+* extensions, i.e., the complete extensions \f$S\f$ whose range
+* \f$S \cup S^+\f$ is maximal w.r.t. set inclusion. A semi-stable extension
+* is preferred, hence the labelling search of PreferredReasoner finds them
+* all; its candidates are compared by their ranges, getAttacked(_in) | _in,
+* and a branch is pruned as soon as the largest range it can reach is a
+* strict subset of the range of some admissible set found before.
+*/
+class SemiStableReasoner : public PreferredReasoner {
+public:
+	SemiStableReasoner(const DungAF& daf, streambuf* osbuff = std::cout.rdbuf())
+		: PreferredReasoner(daf, osbuff) { }
+
+	void computeExtensions();
+
+	// Problems, by the enumeration of the extensions instead of the searches
+	// of PreferredReasoner
+	void task_EE();
+	void task_SC(const std::set<string>& argset);
+	void task_SE();
+	void task_DE(const std::set<string>& argset);
+	void task_DN();
+	void task_DC(const std::set<string>& argset);
+	void task_DS(const std::set<string>& argset);
+
+	// The range S \cup S^+ of the set of arguments _bv
+	bitvector getRange(const bitvector& _bv) { return getAttacked(_bv) | _bv; }
+
+protected:
+	/**
+	 * Add a candidate extension, unless its range is a strict subset of the
+	 * range of some candidate, or it is a subset of a candidate of the same
+	 * range (which is then not complete). The candidates it beats in the
+	 * same way are removed. This method can be called concurrently.
+	 */
+	void addCandidate(const const_bitrow& _in);
+
+	/**
+	 * An argument labelled UNDEC is out of the range of every extension of the
+	 * branch unless some BLANK argument attacks it, which bounds the ranges
+	 * of the branch.
+	 */
+	bool isPromising(const const_bitrow& _blank, const const_bitrow& _in,
+		const const_bitrow& _out, const const_bitrow& _undec, const const_bitrow& _must_out);
+
+protected:
+	std::map<bitvector, bitvector> m_ranges;  /**< The candidates and their ranges */
+};  // class SemiStableReasoner
+
+void SemiStableReasoner::computeExtensions()
+{
+	m_ranges.clear();
+	PreferredReasoner::computeExtensions();
+}
+
+void SemiStableReasoner::addCandidate(const const_bitrow& _in_row)
+{
+	bitvector _in(_in_row);
+	bitvector _range = getRange(_in);
+
+	std::lock_guard<std::mutex> _lock(m_extMutex);
+
+	std::map<bitvector, bitvector>::iterator rg_itr = m_ranges.begin();
+	for ( ; rg_itr != m_ranges.end(); ++rg_itr) {
+		if (_range.is_proper_subset_of(rg_itr->second))
+			return;
+		if (_range == rg_itr->second && _in.is_subset_of(rg_itr->first))
+			return;
+	}
+
+	rg_itr = m_ranges.begin();
+	while (rg_itr != m_ranges.end()) {
+		if (rg_itr->second.is_proper_subset_of(_range) ||
+			(rg_itr->second == _range && rg_itr->first.is_proper_subset_of(_in))) {
+			m_extensions.erase(rg_itr->first);
+			m_ranges.erase(rg_itr++);
+		} else {
+			++rg_itr;
+		}
+	}
+
+	m_ranges.insert(make_pair(_in, _range));
+	m_extensions.insert(_in);
+}
+
+bool SemiStableReasoner::isPromising(const const_bitrow& _blank, const const_bitrow& /*_in*/,
+	const const_bitrow& /*_out*/, const const_bitrow& _undec, const const_bitrow& /*_must_out*/)
+{
+	bitvector _bound = bitvector::UniversalSet(m_argNum);
+	_bound -= _undec;
+	_bound |= getAttacked(_blank);
+
+	std::lock_guard<std::mutex> _lock(m_extMutex);
+
+	std::map<bitvector, bitvector>::const_iterator rg_itr = m_ranges.begin();
+	for ( ; rg_itr != m_ranges.end(); ++rg_itr) {
+		if (_bound.is_proper_subset_of(rg_itr->second))
+			return false;
+	}
+	return true;
+}
+
+void SemiStableReasoner::task_EE()
+{
+	printExtList([&](const ExtensionVisitor& _print) {
+		enumerateExtensions(_print);
+	});
+}
+
+void SemiStableReasoner::task_SC(const std::set<string>& argset)
+{
+	bitvector _arg_bv = m_daf.labelSet2bv(argset);
+	bool _found = false;
+	enumerateExtensions([&](const bitvector& _bv) {
+		if (!_arg_bv.is_subset_of(_bv))
+			return true;
+		printLabSet(_bv);
+		m_output << endl;
+		_found = true;
+		return false;
+	});
+
+	if (!_found)
+		m_output << STR_NO << endl;
+}
+
+void SemiStableReasoner::task_DE(const std::set<string>& argset)
+{
+	bitvector _arg_bv = m_daf.labelSet2bv(argset);
+	bool _is_ext = false;
+	enumerateExtensions([&](const bitvector& _bv) {
+		_is_ext = (_bv == _arg_bv);
+		return !_is_ext;
+	});
+
+	m_output << (_is_ext ? STR_YES : STR_NO) << endl;
+}
+
+void SemiStableReasoner::task_DN()
+{
+	bool _found = false;
+	enumerateExtensions([&](const bitvector& _bv) {
+		_found = _bv.any();
+		return !_found;
+	});
+
+	m_output << (_found ? STR_YES : STR_NO) << endl;
+}
+
+void SemiStableReasoner::task_SE()
+{
+	bool _found = false;
+	enumerateExtensions([&](const bitvector& _bv) {
+		printLabSet(_bv);
+		m_output << endl;
+		_found = true;
+		return false;  // Stop at the first one
+	});
+
+	if (!_found)
+		m_output << STR_NO << endl;
+}
+
+void SemiStableReasoner::task_DC(const std::set<string>& argset)
+{
+	bitvector _arg_bv = m_daf.labelSet2bv(argset);
+	bool _found = false;
+	enumerateExtensions([&](const bitvector& _bv) {
+		_found = _arg_bv.is_subset_of(_bv);
+		return !_found;
+	});
+
+	m_output << (_found ? STR_YES : STR_NO) << endl;
+}
+
+void SemiStableReasoner::task_DS(const std::set<string>& argset)
+{
+	// There must be an extension, and all the extensions contain argset
+	bitvector _arg_bv = m_daf.labelSet2bv(argset);
+	bool _skeptical = true;
+	size_type _num = enumerateExtensions([&](const bitvector& _bv) {
+		_skeptical = _arg_bv.is_subset_of(_bv);
+		return _skeptical;
+	});
+
+	m_output << ((_num > 0 && _skeptical) ? STR_YES : STR_NO) << endl;
+}
+
+} // namespace argumatrix
+
+
+#endif  //DUNG_SEMI_STABLE_REASONER_HPP
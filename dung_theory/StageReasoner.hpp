@@ -0,0 +1,156 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// Dung's abstract argumentation framework
+//=======================================================================
+
+#ifndef DUNG_STAGE_REASONER_HPP
+#define DUNG_STAGE_REASONER_HPP
+
+#include <iostream>
+#include <string>
+#include <utility>
+
+#include "config/config.hpp"
+#include "bitmatrix/bitvector.hpp"
+#include "DungAF.hpp"
+#include "SemiStableReasoner.hpp"
+
+
+namespace argumatrix{
+
+using namespace std;
+
+/**
+* This reasoner for Dung theories performs inference on the stage extensions,
+* i.e., the conflict-free sets \f$S\f$ whose range \f$S \cup S^+\f$ is
+* maximal w.r.t. set inclusion. The labelling search of PreferredReasoner is
+* relaxed to conflict-free sets: the attackers of an IN argument are labelled
+* UNDEC instead of MUST_OUT, and an argument is UNDEC if it can not be IN.
+* The candidates and the pruning by range are those of SemiStableReasoner.
+*/
+class StageReasoner : public SemiStableReasoner {
+public:
+	StageReasoner(const DungAF& daf, streambuf* osbuff = std::cout.rdbuf())
+		: SemiStableReasoner(daf, osbuff) {
+		m_fixedWidth = 0;  // findPreferredExtensions() is overridden
+	}
+
+protected:
+	/**
+	 * Only the self-attacking arguments are labelled (UNDEC) before the search,
+	 * since an unattacked argument may be out of some stage extension.
+	 */
+	void preprocessing(bitvector& _blank, bitvector& _in, bitvector& _out, bitvector& _undec);
+
+	// Search the conflict-free sets, _must_out stays empty
+	void findPreferredExtensions(bitvector& _blank, bitvector& _in,
+			bitvector& _out, bitvector& _undec, bitvector& _must_out);
+
+	/**
+	 * An argument in conflict with no BLANK argument is IN (TYPE_A), since
+	 * adding it to a conflict-free set of the branch enlarges the range.
+	 * Otherwise the BLANK argument with most conflicts is chosen (TYPE_B).
+	 */
+	pair<size_type, SELECT_TYPE> selectStageArgument(const bitvector& _blank);
+};  // class StageReasoner
+
+void StageReasoner::preprocessing(bitvector& _blank, bitvector& /*_in*/, bitvector& /*_out*/, bitvector& _undec)
+{
+	_undec |= getSelfAttackingArguments();
+	_blank -= _undec;
+}
+
+void StageReasoner::findPreferredExtensions(bitvector& _blank,
+		bitvector& _in, bitvector& _out, bitvector& _undec, bitvector& _must_out)
+{
+	size_type i;
+	SELECT_TYPE _s_type;
+
+	boost::tie(i, _s_type) = selectStageArgument(_blank);
+
+	while (i != bitvector::npos)
+	{
+		if ( !isPromising(const_bitrow(_blank), const_bitrow(_in), const_bitrow(_out), 
+				const_bitrow(_undec), const_bitrow(_must_out)) )
+			return;
+
+		bitvector _blank_new(_blank);
+		bitvector _out_new(_out);
+		bitvector _in_new(_in);
+		bitvector _undec_new(_undec);
+
+		_in_new[i] = true; _blank_new[i] = false;  // label i with IN
+
+		if (m_isDense) {
+			_out_new |= m_attackedBy[i];
+			_blank_new -= m_attackedBy[i];
+			_undec_new -= m_attackedBy[i];
+
+			// The attackers of i which are labeled by BLANK can not be IN
+			bitvector _tmp_undec( m_BmAtkMtx[i]&_blank_new );
+			_undec_new |= _tmp_undec;
+			_blank_new -= _tmp_undec;
+		} else {
+			sparsematrix::const_iterator it, _end;
+			for (it = m_SpAtkMtx.col_begin(i), _end = m_SpAtkMtx.col_end(i); it != _end; ++it) {
+				_out_new[*it] = true;
+				_blank_new[*it] = false;  _undec_new[*it] = false;
+			}
+			for (it = m_SpAtkMtx.row_begin(i), _end = m_SpAtkMtx.row_end(i); it != _end; ++it) {
+				if (_blank_new[*it]) {
+					_undec_new[*it] = true;  _blank_new[*it] = false;
+				}
+			}
+		}
+
+		if (_s_type == TYPE_B)
+		{
+			if (m_pool != NULL && m_pool->hungry()) {
+				spawnSearch(_blank_new, _in_new, _out_new, _undec_new, _must_out);
+			} else {
+				findPreferredExtensions(_blank_new, _in_new, _out_new, _undec_new, _must_out);
+			}
+
+			_undec[i] = true;  _blank[i] = false;
+		}
+		else   // TYPE_A
+		{
+			_blank = _blank_new;
+			_in = _in_new;
+			_out = _out_new;
+			_undec = _undec_new;
+		}
+
+		boost::tie(i, _s_type) = selectStageArgument(_blank);
+	}
+
+	addCandidate( const_bitrow(_in) );
+}
+
+pair<size_type, StageReasoner::SELECT_TYPE> StageReasoner::selectStageArgument(
+	const bitvector& _blank)
+{
+	size_type i = bitvector::npos;
+	for (size_type j = _blank.find_first(); j != bitvector::npos; j = _blank.find_next(j))
+	{
+		if ( !intersectsAttackers(j, _blank) && !intersectsAttacked(j, _blank) )
+		{
+			return make_pair(j, TYPE_A);
+		}
+
+		if ( i == bitvector::npos) 	{
+			i = j;
+		} else if (degree(j) > degree(i)) {
+			i = j;
+		}
+	}
+
+	return make_pair(i, TYPE_B);
+}
+
+} // namespace argumatrix
+
+
+#endif  //DUNG_STAGE_REASONER_HPP
@@ -1,4 +1,5 @@
 #include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include <string.h>
@@ -11,6 +12,9 @@
 #include "Reasoner.hpp"
 #include "GroundedReasoner.hpp"
 #include "PreferredReasoner.hpp"
+#include "GroundedLabelling.hpp"
+#include "IncrementalGrounded.hpp"
+#include "SccReasoner.hpp"
 
 using namespace std;
 using namespace argumatrix;
@@ -66,8 +70,144 @@ void Test2_ElementsOfArgumentation()
 }
 
 
+/**
+ * Apply random changes to a framework, and compare the labelling kept by
+ * IncrementalGrounded with groundedLabelling() from scratch after each one.
+ * @return the number of the changes after which they differ.
+ */
+size_type Test3_IncrementalGrounded(unsigned int seed, size_type n, size_type steps)
+{
+	srand(seed);
+	DungAF daf;
+	for (size_type i = 0; i < n; ++i)
+		daf.addArgument("a" + std::to_string(i));
+	for (size_type k = 0; k < 2 * n; ++k)
+		daf.addAttack(Argument(rand() % n), Argument(rand() % n));
+
+	IncrementalGrounded _gr(daf);
+	size_type _errors = 0;
+	vector<int> _labels;
+	for (size_type s = 0; s < steps; ++s) {
+		const size_type _num = daf.getNumberOfArguments();
+		const int _op = rand() % 8;
+		if (_op == 0 || _num < 2) {
+			daf.addArgument("b" + std::to_string(s));
+		} else
+		if (_op == 1) {
+			daf.removeArgument(Argument(rand() % _num));
+		} else
+		if (_op < 5) {
+			daf.addAttack(Argument(rand() % _num), Argument(rand() % _num));
+		} else {
+			// An attack of a random argument, if any
+			Argument x = Argument(rand() % _num);
+			size_type _out = daf.attacked_end(x) - daf.attacked_begin(x);
+			if (_out > 0)
+				daf.removeAttack(x, daf.attacked_begin(x)[rand() % _out]);
+		}
+
+		groundedLabelling(daf.getSparseAttackMatrix(), _labels);
+		if (_labels != _gr.getLabels())
+			++_errors;
+	}
+
+	cout << "IncrementalGrounded: " << steps << " changes, "
+		<< _errors << " mismatches with groundedLabelling()" << endl;
+	return _errors;
+}
+
+
+/**
+ * A reasoner enumerating the complete or stable extensions of a small
+ * framework by checking all the subsets of its arguments.
+ */
+class BruteForceReasoner : public Reasoner {
+public:
+	BruteForceReasoner(const DungAF& daf, SccSemantics sem):
+		Reasoner(daf), m_semantics(sem) {}
+
+	size_type enumerateExtensions(const ExtensionVisitor& visit)
+	{
+		size_type _num = 0;
+		for (unsigned long m = 0; m < (1UL << m_argNum); ++m) {
+			bitvector _bv = bitvector::EmptySet(m_argNum);
+			for (size_type j = 0; j < m_argNum; ++j)
+				if (m >> j & 1)
+					_bv.set(j);
+			if (m_semantics == SCC_STABLE ? !is_stable(_bv) : !is_complete(_bv))
+				continue;
+			++_num;
+			if (!visit(_bv))
+				break;
+		}
+		return _num;
+	}
+
+private:
+	SccSemantics m_semantics;
+};
+
+/**
+ * Compare the extensions of SccReasoner with the ones of the reasoner of the
+ * whole framework on random frameworks, for the complete, stable and
+ * preferred semantics. The components are solved by the same reasoners.
+ * @return the number of the pairs of framework and semantics on which they
+ * differ.
+ */
+size_type Test4_SccReasoner(unsigned int seed, size_type rounds)
+{
+	srand(seed);
+	size_type _errors = 0;
+	for (size_type r = 0; r < rounds; ++r) {
+		DungAF daf;
+		const size_type n = rand() % 11;
+		for (size_type i = 0; i < n; ++i)
+			daf.addArgument("a" + std::to_string(i));
+		// Mostly forward attacks, so that there are several components
+		for (size_type k = 0; n > 0 && k < 3 * n / 2; ++k) {
+			Argument x = Argument(rand() % n), y = Argument(rand() % n);
+			if (x > y && rand() % 4 != 0)
+				std::swap(x, y);
+			daf.addAttack(x, y);
+		}
+
+		const SccSemantics _sems[] = { SCC_COMPLETE, SCC_STABLE, SCC_PREFERRED };
+		for (SccSemantics _sem : _sems) {
+			ReasonerFactory _factory = [=](const DungAF& _local) -> Reasoner* {
+				if (_sem == SCC_PREFERRED)
+					return new PreferredReasoner(_local);
+				return new BruteForceReasoner(_local, _sem);
+			};
+			std::unique_ptr<Reasoner> _whole(_factory(daf));
+			SccReasoner _scc(daf, _sem, _factory);
+
+			set<bitvector> _expected, _exts;
+			_whole->enumerateExtensions([&](const bitvector& _bv) {
+				_expected.insert(_bv);
+				return true;
+			});
+			_scc.enumerateExtensions([&](const bitvector& _bv) {
+				_exts.insert(_bv);
+				return true;
+			});
+			if (_exts != _expected)
+				++_errors;
+		}
+	}
+
+	cout << "SccReasoner: " << rounds << " frameworks, "
+		<< _errors << " mismatches with the whole frameworks" << endl;
+	return _errors;
+}
+
+
 int main(int argc, char* argv[])
 {
+	if (Test3_IncrementalGrounded(2016, 40, 2000) > 0)
+		return 1;
+	if (Test4_SccReasoner(2016, 300) > 0)
+		return 1;
+
 	DungAF daf;
 	
 	Argument a = daf.addArgument("A");
@@ -0,0 +1,66 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// The layout of the binary snapshots of abstract argumentation frameworks
+//=======================================================================
+
+#ifndef ARGUMATRIX_BINARY_AF_HPP
+#define ARGUMATRIX_BINARY_AF_HPP
+
+#include <stdint.h>
+
+#include "config/config.hpp"
+
+namespace argumatrix{
+
+/**
+ * @brief The header of a binary snapshot of a DungAF (the file format "bin").
+ * A snapshot is written by parser::DungAF2Binary() and loaded by
+ * parser::Binary2DungAF(). The header is followed by the sections below, each
+ * of which starts at a multiple of 8 bytes, so that the arrays can be read in
+ * place from the mapped file:
+ *   1. uint64_t label_offsets[num_args+1]: the label of the argument i is
+ *      labels[label_offsets[i], label_offsets[i+1]).
+ *   2. char labels[label_bytes]: the labels without terminators.
+ *   3. uint64_t attack_ptr[num_args+1], uint32_t attack_idx[num_attacks]: the
+ *      attacks in CSR form, the argument i attacks the arguments
+ *      attack_idx[attack_ptr[i], attack_ptr[i+1]).
+ *   4. if (flags & BIN_DENSE_MATRIX), uint64_t matrix[num_args*matrix_blocks]:
+ *      the rows of the dense attack matrix (see DungAF::getAttackMatrix()),
+ *      the bit j of the row i is the bit j%64 of matrix[i*matrix_blocks+j/64].
+ * The numbers are stored in the byte order of the writer, and a snapshot from
+ * another byte order is rejected by its byte_order field.
+ */
+struct BinaryAFHeader {
+	char     magic[8];       /**< BIN_MAGIC */
+	uint32_t version;        /**< BIN_VERSION */
+	uint32_t flags;          /**< The flags BIN_* of the optional sections */
+	uint64_t num_args;
+	uint64_t num_attacks;
+	uint64_t label_bytes;
+	uint64_t matrix_blocks;  /**< The 64-bit blocks per row of the matrix, or 0 */
+	uint64_t byte_order;     /**< BIN_BYTE_ORDER as written */
+};
+
+// The magic number of the snapshots
+const char BIN_MAGIC[8] = { 'A', 'R', 'G', 'M', 'A', 'T', 'A', 'F' };
+
+// The version of the layout, increased by each incompatible change
+const uint32_t BIN_VERSION = 1;
+
+// The snapshot embeds the dense attack matrix
+const uint32_t BIN_DENSE_MATRIX = 0x1;
+
+// Read back as another value on a machine with another byte order
+const uint64_t BIN_BYTE_ORDER = 0x0102030405060708ULL;
+
+// The size of a section rounded up to a multiple of 8 bytes
+inline size_type binaryAlign(size_type _bytes)
+{
+	return (_bytes + 7) & ~size_type(7);
+}
+
+} // namespace argumatrix
+
+#endif  // ARGUMATRIX_BINARY_AF_HPP
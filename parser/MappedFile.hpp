@@ -0,0 +1,197 @@
+//=======================================================================
+// Copyright 2015 Tsinghua University.
+// Authors: Fuan Pu (Pu.Fuan@gmail.com)
+//
+// A read-only memory mapped file
+//=======================================================================
+
+#ifndef ARGUMATRIX_MAPPED_FILE_HPP
+#define ARGUMATRIX_MAPPED_FILE_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  include <windows.h>
+#else
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+#include "config/config.hpp"
+
+namespace argumatrix{
+
+using namespace std;
+
+/**
+ * @brief Map a whole file into memory for reading, so that a parser can scan
+ * it in place without copying it line by line. The files which can not be
+ * mapped (e.g., pipes) are read into a buffer instead.
+ * ~~~~~{.cpp}
+ *   MappedFile _mf;
+ *   if (_mf.open("af.apx"))
+ *       scan(_mf.begin(), _mf.end());
+ * ~~~~~
+ */
+class MappedFile {
+public:
+	MappedFile();
+	~MappedFile() { close(); }
+
+	/**
+	 * @brief Map the file filePath.
+	 * @return false if the file can not be opened.
+	 */
+	bool open(const std::string& filePath);
+
+	void close();
+
+	const char* begin() const { return m_data; }
+	const char* end() const { return m_data + m_size; }
+	size_type size() const { return m_size; }
+
+private:
+	// Not copyable
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	// Read the file into m_buffer, if it can not be mapped
+	bool readAll(const std::string& filePath);
+
+	const char* m_data;
+	size_type m_size;
+	bool m_mapped;
+	vector<char> m_buffer;
+#if defined(_WIN32)
+	HANDLE m_file;
+	HANDLE m_mapping;
+#endif
+};
+
+
+MappedFile::MappedFile():
+	m_data(NULL),
+	m_size(0),
+	m_mapped(false)
+#if defined(_WIN32)
+	, m_file(INVALID_HANDLE_VALUE),
+	m_mapping(NULL)
+#endif
+{
+
+}
+
+#if defined(_WIN32)
+
+bool MappedFile::open(const std::string& filePath)
+{
+	close();
+
+	m_file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (m_file == INVALID_HANDLE_VALUE)
+		return readAll(filePath);
+
+	LARGE_INTEGER _size;
+	if (!GetFileSizeEx(m_file, &_size) || _size.QuadPart == 0) {
+		CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+		return readAll(filePath);
+	}
+
+	m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m_mapping != NULL)
+		m_data = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	if (m_data == NULL) {
+		close();
+		return readAll(filePath);
+	}
+
+	m_size = (size_type)_size.QuadPart;
+	m_mapped = true;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_mapped)
+		UnmapViewOfFile(m_data);
+	if (m_mapping != NULL)
+		CloseHandle(m_mapping);
+	if (m_file != INVALID_HANDLE_VALUE)
+		CloseHandle(m_file);
+
+	m_mapping = NULL;
+	m_file = INVALID_HANDLE_VALUE;
+	m_data = NULL;
+	m_size = 0;
+	m_mapped = false;
+	vector<char>().swap(m_buffer);
+}
+
+#else
+
+bool MappedFile::open(const std::string& filePath)
+{
+	close();
+
+	int _fd = ::open(filePath.c_str(), O_RDONLY);
+	if (_fd < 0)
+		return false;
+
+	struct stat _st;
+	if (fstat(_fd, &_st) != 0 || !S_ISREG(_st.st_mode) || _st.st_size == 0) {
+		::close(_fd);
+		return readAll(filePath);
+	}
+
+	void* _addr = mmap(NULL, (size_t)_st.st_size, PROT_READ, MAP_PRIVATE, _fd, 0);
+	// The mapping stays valid after the descriptor is closed
+	::close(_fd);
+	if (_addr == MAP_FAILED)
+		return readAll(filePath);
+
+#if defined(MADV_SEQUENTIAL)
+	madvise(_addr, (size_t)_st.st_size, MADV_SEQUENTIAL);
+#endif
+
+	m_data = (const char*)_addr;
+	m_size = (size_type)_st.st_size;
+	m_mapped = true;
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (m_mapped)
+		munmap((void*)m_data, m_size);
+
+	m_data = NULL;
+	m_size = 0;
+	m_mapped = false;
+	vector<char>().swap(m_buffer);
+}
+
+#endif
+
+bool MappedFile::readAll(const std::string& filePath)
+{
+	std::ifstream _infile(filePath.c_str(), ios_base::in | ios_base::binary);
+	if (!_infile)
+		return false;
+
+	m_buffer.assign(std::istreambuf_iterator<char>(_infile), std::istreambuf_iterator<char>());
+	m_data = m_buffer.empty() ? NULL : &m_buffer[0];
+	m_size = m_buffer.size();
+	return true;
+}
+
+} // namespace argumatrix
+
+#endif  // ARGUMATRIX_MAPPED_FILE_HPP
@@ -12,13 +12,17 @@
 #include <string>
 #include <utility>   
 #include <algorithm>   
-// #include <regex>
-#include <boost/regex.hpp>
+#include <vector>
+#include <fstream>
+#include <string.h>
+#include <boost/utility/string_ref.hpp>
 
 #include "config/config.hpp"
 #include "dung_theory/ArgumentProperty.hpp"
 #include "dung_theory/AttackProperty.hpp"
 #include "dung_theory/DungAF.hpp"
+#include "MappedFile.hpp"
+#include "BinaryAF.hpp"
 
 namespace argumatrix{
 
@@ -29,9 +33,16 @@ class parser
 public:
 	/**
 	 * @brief Read Aspartix format from a file to DungAF. We have implemented
-	 * three approaches  to read aspartix format. stl::regex, boost::regex and
-	 * the approach from ArgSemSAT.1.0rc3. By testing, we choose boost::regex
-	 * since it is more stable than stl::regex, and slightly faster than ArgSemSAT.
+	 * several approaches to read aspartix format: stl::regex, boost::regex,
+	 * the approach from ArgSemSAT.1.0rc3, and the hand-written tokenizer below.
+	 * The file is mapped into memory and scanned in place, the tokens point
+	 * into the mapped file, and the framework is built in two passes: the
+	 * statements are collected and counted first, then the arguments are
+	 * reserved and added. Each line is accepted as by the regular expressions
+	 *   att\(\s*([a-zA-Z0-9_]+)\s*,\s*([a-zA-Z0-9_]+)\s*\)
+	 *   arg\(\s*([a-zA-Z0-9_]+)\s*\)
+	 * searched in this order anywhere in the line. The lines of at most 4
+	 * characters are skipped, and the other unmatched lines are reported.
 	 * @param std::string filePath -- the file path of the Aspartix format file.
 	 * @param DungAF& daf -- the output abstract argumentation framework
 	 * @return bool. If the translation is successful return true, else return false.
@@ -39,12 +50,72 @@ public:
 	static bool Aspartix2DungAF(const std::string& filePath, DungAF& daf);
 	
 	/**
-	 * Read Trivial Graph Format from a file to DungAF
+	 * Read Trivial Graph Format from a file to DungAF. The tokens are separated
+	 * by white spaces: the arguments come first, up to the token "#", and then
+	 * the attacks as pairs of arguments.
 	 * @param std::string filePath -- the file path of the Aspartix format file.
 	 * @param DungAF& daf -- the output abstract argumentation framework
 	 * @return bool. If the translation is successful return true, else return false.
 	 */
 	static bool TrivialGraph2DungAF(const std::string& filePath, DungAF& daf);
+
+	/**
+	 * Read a binary snapshot (see BinaryAF.hpp) from a file to DungAF. The
+	 * file is mapped into memory, and the arguments and the attacks are added
+	 * by their indices, without parsing and looking up the labels. The dense
+	 * attack matrix, if embedded, is kept by daf (see DungAF::setAttackMatrix()).
+	 * @param std::string filePath -- the file path of the snapshot.
+	 * @param DungAF& daf -- the output abstract argumentation framework
+	 * @return bool. If the snapshot is valid return true, else return false.
+	 */
+	static bool Binary2DungAF(const std::string& filePath, DungAF& daf);
+
+	/**
+	 * Write DungAF to a file as a binary snapshot, which can be loaded by
+	 * Binary2DungAF() many times at a much lower cost than a text format.
+	 * @param DungAF& daf -- the abstract argumentation framework
+	 * @param std::string filePath -- the file path of the snapshot.
+	 * @param bool withMatrix -- embed the dense attack matrix, which takes
+	 * n*n/8 bytes for n arguments.
+	 * @return bool. If the file is written return true, else return false.
+	 */
+	static bool DungAF2Binary(const DungAF& daf, const std::string& filePath, bool withMatrix = false);
+
+private:
+	// A token of the mapped file
+	typedef boost::string_ref token_type;
+
+	// An argument (the target is empty) or an attack of a file
+	struct Statement {
+		token_type source;
+		token_type target;
+	};
+
+	// The white spaces of \s, and the characters of [a-zA-Z0-9_]
+	static bool isSpace(char c);
+	static bool isLabelChar(char c);
+
+	/**
+	 * @brief Match the pattern "\s*ID\s*" + delim at p, where ID is a label.
+	 * @return the position after delim, or NULL if there is no match.
+	 */
+	static const char* matchLabel(const char* p, const char* end, char delim, token_type& label);
+
+	/**
+	 * @brief Search the leftmost attack "att(a, b)" (respectively, argument
+	 * "arg(a)") in the line [p, end).
+	 */
+	static bool searchAttack(const char* p, const char* end, Statement& stmt);
+	static bool searchArgument(const char* p, const char* end, Statement& stmt);
+
+	/**
+	 * @brief The second pass: reserve the arguments and add the statements
+	 * to daf in their order in the file.
+	 */
+	static void buildDungAF(const vector<Statement>& stmts, size_type num_args, DungAF& daf);
+
+	// Write a section of a binary snapshot, padded to a multiple of 8 bytes
+	static void writeSection(std::ostream& os, const void* data, size_type bytes);
 };
 
 
@@ -108,63 +179,143 @@ public:
 
 
 
-//// The std::regex may result regex_error on linux systems. Thus, we using 
-//// boost::regex to substitute.
+inline
+bool parser::isSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+inline
+bool parser::isLabelChar(char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+		(c >= '0' && c <= '9') || c == '_';
+}
+
+inline
+const char* parser::matchLabel(const char* p, const char* end, char delim, token_type& label)
+{
+	while (p < end && isSpace(*p)) ++p;
+
+	const char* _begin = p;
+	while (p < end && isLabelChar(*p)) ++p;
+	if (p == _begin)
+		return NULL;
+	label = token_type(_begin, p - _begin);
+
+	while (p < end && isSpace(*p)) ++p;
+	if (p == end || *p != delim)
+		return NULL;
+	return p + 1;
+}
+
+bool parser::searchAttack(const char* p, const char* end, Statement& stmt)
+{
+	// Try each "att(" of the line
+	for (; end - p > 4; ++p) {
+		p = (const char*)memchr(p, 'a', end - p);
+		if (p == NULL || end - p <= 4)
+			return false;
+		if (p[1] != 't' || p[2] != 't' || p[3] != '(')
+			continue;
+
+		const char* _q = matchLabel(p + 4, end, ',', stmt.source);
+		if (_q != NULL && matchLabel(_q, end, ')', stmt.target) != NULL)
+			return true;
+	}
+	return false;
+}
+
+bool parser::searchArgument(const char* p, const char* end, Statement& stmt)
+{
+	// Try each "arg(" of the line
+	for (; end - p > 4; ++p) {
+		p = (const char*)memchr(p, 'a', end - p);
+		if (p == NULL || end - p <= 4)
+			return false;
+		if (p[1] != 'r' || p[2] != 'g' || p[3] != '(')
+			continue;
+
+		if (matchLabel(p + 4, end, ')', stmt.source) != NULL) {
+			stmt.target = token_type();
+			return true;
+		}
+	}
+	return false;
+}
+
+void parser::buildDungAF(const vector<Statement>& stmts, size_type num_args, DungAF& daf)
+{
+	daf.reserve(num_args, stmts.size() - num_args);
+
+	// The labels are copied into the same strings, to avoid reallocations
+	string _source, _target;
+	for (size_type i = 0; i < stmts.size(); ++i) {
+		_source.assign(stmts[i].source.data(), stmts[i].source.size());
+		if (stmts[i].target.empty()) {
+			daf.addArgument(_source);
+		} else {
+			_target.assign(stmts[i].target.data(), stmts[i].target.size());
+			daf.addAttack(_source, _target);
+		}
+	}
+}
+
 bool parser::Aspartix2DungAF(const std::string& fileName, DungAF& daf)
 {
 	bool _is_successful = true;
 
-	// The argument and attack regex expressions of Aspartix format
+	// The argument and attack expressions of Aspartix format
 	// arg(a1).
 	// att(a1, a2).
-	const boost::regex rgx_arg("arg\\(\\s*([a-zA-Z0-9_]+)\\s*\\)");
-	const boost::regex rgx_att("att\\(\\s*([a-zA-Z0-9_]+)\\s*,\\s*([a-zA-Z0-9_]+)\\s*\\)");
 
 	// Before parsing, we need to clear the daf.
 	daf.clear();
 
-	std::ifstream _infile;
-	_infile.open(fileName, ios_base::in);
+	MappedFile _infile;
 
 	//check the file
-	if(!_infile)
+	if(!_infile.open(fileName))
 	{
 		cerr << "Can not open the file: " << fileName << endl;
-		exit(1);
+		return false;
 	}
 
-	std::string _line_str;
-	size_type   _line_num = 0;
-	boost::cmatch _result;
-
-	while ( getline(_infile, _line_str) )
-	{
-		//_infile.getline()
-		//_infile >> _line_str;
+	// The first pass: collect and count the statements
+	vector<Statement> _stmts;
+	size_type _num_args = 0;
+	size_type _line_num = 0;
+	Statement _stmt;
+
+	const char* _end = _infile.end();
+	for (const char* _line = _infile.begin(); _line < _end; ) {
+		const char* _line_end = (const char*)memchr(_line, '\n', _end - _line);
+		if (_line_end == NULL)
+			_line_end = _end;
 		++_line_num;
 
-		if(_line_str.length()<=4)
-			continue;
-
-		if (boost::regex_search(_line_str.c_str(), _result, rgx_att))  // Find Attack
-		{
-			daf.addAttack(_result[1], _result[2]);
-			//cout << "Adding Attack: (" << _result[1] << "," << _result[2] << ")" << endl;
-		}
-		else if (boost::regex_search(_line_str.c_str(), _result, rgx_arg)) // Find Argument
-		{
-			daf.addArgument( _result[1] );
-			//cout << "Adding Argument: " << _result[1] << endl;
-		}
-		else
-		{
-			std::cerr << "Ignorance: " << fileName << endl
-				<< "     Line number(" << _line_num << "): " << _line_str << endl;
-			_is_successful = false;
+		if (_line_end - _line > 4) {
+			if (searchAttack(_line, _line_end, _stmt)) {  // Find Attack
+				_stmts.push_back(_stmt);
+			}
+			else if (searchArgument(_line, _line_end, _stmt)) { // Find Argument
+				_stmts.push_back(_stmt);
+				++_num_args;
+			}
+			else
+			{
+				std::cerr << "Ignorance: " << fileName << endl
+					<< "     Line number(" << _line_num << "): "
+					<< string(_line, _line_end) << endl;
+				_is_successful = false;
+			}
 		}
+
+		_line = _line_end + 1;
 	}
 
-	_infile.close();
+	// The second pass
+	buildDungAF(_stmts, _num_args, daf);
 
 	return _is_successful;
 } // Aspartix2DungAF(const std::string& fileName, DungAF& daf)
@@ -236,42 +387,246 @@ bool parser::Aspartix2DungAF(const std::string& fileName, DungAF& daf)
 bool parser::TrivialGraph2DungAF(const std::string& fileName, DungAF& daf)
 {
 	bool _is_successful=true;
-	string arg1, arg2;
 
 	// Before parsing, we need to clear the daf.
 	daf.clear();
 
-	std::ifstream _infile;
-	_infile.open(fileName, ios_base::in);
+	MappedFile _infile;
 
 	//check the file
-	if(!_infile)
+	if(!_infile.open(fileName))
 	{
 		cerr << "Can not open the file: " << fileName << endl;
-		exit(1);
+		return false;
 	}
 
-	// read arguments
-	while(_infile >> arg1) {	
-		if(arg1=="#") {
+	// The first pass: split the file into tokens
+	vector<Statement> _stmts;
+	size_type _num_args = 0;
+	bool _in_attacks = false;  // After the token "#"
+	bool _has_source = false;  // The source of an attack is read
+	Statement _stmt;
+
+	const char* _end = _infile.end();
+	for (const char* p = _infile.begin(); p < _end; ) {
+		while (p < _end && isSpace(*p)) ++p;
+		if (p == _end)
 			break;
+
+		const char* _begin = p;
+		while (p < _end && !isSpace(*p)) ++p;
+		token_type _token(_begin, p - _begin);
+
+		if (!_in_attacks) {
+			// read arguments
+			if (_token == "#") {
+				_in_attacks = true;
+			} else {
+				_stmt.source = _token;
+				_stmt.target = token_type();
+				_stmts.push_back(_stmt);
+				++_num_args;
+			}
+		} else
+		if (!_has_source) {
+			// read attacks, an odd token at the end is ignored
+			_stmt.source = _token;
+			_has_source = true;
 		} else {
-			daf.addArgument(arg1);
-			// cout << arg1 << endl;
+			_stmt.target = _token;
+			_stmts.push_back(_stmt);
+			_has_source = false;
 		}
 	}
 
-	// read attackes
-	while(_infile >> arg1 >> arg2) {  
-		daf.addAttack(arg1, arg2);	
-		// cout << arg1 << " -> " << arg2 << endl;
-	}
-
-	_infile.close();
+	// The second pass
+	buildDungAF(_stmts, _num_args, daf);
 
 	return _is_successful;
 } // TrivialGraph2DungAF(const std::string& fileName, DungAF& daf)
 
+bool parser::Binary2DungAF(const std::string& fileName, DungAF& daf)
+{
+	// Before parsing, we need to clear the daf.
+	daf.clear();
+
+	MappedFile _infile;
+
+	//check the file
+	if(!_infile.open(fileName))
+	{
+		cerr << "Can not open the file: " << fileName << endl;
+		return false;
+	}
+
+	BinaryAFHeader _hd;
+	if (_infile.size() < sizeof(_hd)) {
+		cerr << "Not a binary snapshot: " << fileName << endl;
+		return false;
+	}
+	memcpy(&_hd, _infile.begin(), sizeof(_hd));
+
+	if (memcmp(_hd.magic, BIN_MAGIC, sizeof(BIN_MAGIC)) != 0) {
+		cerr << "Not a binary snapshot: " << fileName << endl;
+		return false;
+	}
+	if (_hd.byte_order != BIN_BYTE_ORDER || _hd.version != BIN_VERSION) {
+		cerr << "The binary snapshot is written by another version or on "
+			 << "another machine: " << fileName << endl;
+		return false;
+	}
+
+	// The indices of the attacks are 32 bits, which also bounds the sizes
+	// of the sections below
+	const uint64_t _n = _hd.num_args;
+	const uint64_t _m = _hd.num_attacks;
+	const bool _has_matrix = (_hd.flags & BIN_DENSE_MATRIX) != 0;
+	const uint64_t _nb = (_n + 63) / 64;
+	if (_n > 0xffffffffULL || _m > 0xffffffffULL || _hd.label_bytes > 0xffffffffULL ||
+		(_has_matrix && _hd.matrix_blocks != _nb))
+	{
+		cerr << "The binary snapshot is corrupted: " << fileName << endl;
+		return false;
+	}
+
+	// The offsets of the sections
+	const size_type _off_labels = binaryAlign(sizeof(_hd)) + binaryAlign((size_type)(_n+1)*8);
+	const size_type _off_ptr = _off_labels + binaryAlign((size_type)_hd.label_bytes);
+	const size_type _off_idx = _off_ptr + binaryAlign((size_type)(_n+1)*8);
+	const size_type _off_matrix = _off_idx + binaryAlign((size_type)_m*4);
+	const size_type _total = _off_matrix + (_has_matrix ? (size_type)(_n*_nb*8) : 0);
+	if (_infile.size() < _total) {
+		cerr << "The binary snapshot is truncated: " << fileName << endl;
+		return false;
+	}
+
+	// The sections are 8-byte aligned in the mapped file
+	const char* _base = _infile.begin();
+	const uint64_t* _label_off = (const uint64_t*)(_base + binaryAlign(sizeof(_hd)));
+	const char* _labels = _base + _off_labels;
+	const uint64_t* _atk_ptr = (const uint64_t*)(_base + _off_ptr);
+	const uint32_t* _atk_idx = (const uint32_t*)(_base + _off_idx);
+
+	// Check the arrays before changing daf
+	if (_label_off[0] != 0 || _label_off[_n] != _hd.label_bytes ||
+		_atk_ptr[0] != 0 || _atk_ptr[_n] != _m)
+	{
+		cerr << "The binary snapshot is corrupted: " << fileName << endl;
+		return false;
+	}
+	for (size_type i = 0; i < _n; ++i) {
+		if (_label_off[i] > _label_off[i+1] || _atk_ptr[i] > _atk_ptr[i+1]) {
+			cerr << "The binary snapshot is corrupted: " << fileName << endl;
+			return false;
+		}
+	}
+	for (size_type k = 0; k < _m; ++k) {
+		if (_atk_idx[k] >= _n) {
+			cerr << "The binary snapshot is corrupted: " << fileName << endl;
+			return false;
+		}
+	}
+
+	daf.reserve((size_type)_n, (size_type)_m);
+	string _label;
+	for (size_type i = 0; i < _n; ++i) {
+		_label.assign(_labels + _label_off[i], (size_type)(_label_off[i+1] - _label_off[i]));
+		daf.addArgument(_label);
+	}
+
+	// A repeated label is added once, and would shift the indices
+	if (daf.getNumberOfArguments() != _n) {
+		cerr << "The binary snapshot is corrupted: " << fileName << endl;
+		daf.clear();
+		return false;
+	}
+
+	// The arguments are indexed by their order
+	for (size_type i = 0; i < _n; ++i) {
+		for (uint64_t k = _atk_ptr[i]; k < _atk_ptr[i+1]; ++k) {
+			daf.addAttack(Argument(i), Argument(_atk_idx[k]));
+		}
+	}
+
+	if (_has_matrix && _n > 0) {
+		assert(bitvector::bits_per_block == 64);
+		const block_type* _rows = (const block_type*)(_base + _off_matrix);
+		bitmatrix _bm((size_type)_n);
+		for (size_type i = 0; i < _n; ++i, _rows += _nb) {
+			memcpy(_bm[i].blocks(), _rows, (size_type)_nb * sizeof(block_type));
+		}
+		daf.setAttackMatrix(std::move(_bm));
+	}
+
+	return true;
+} // Binary2DungAF(const std::string& fileName, DungAF& daf)
+
+inline
+void parser::writeSection(std::ostream& os, const void* data, size_type bytes)
+{
+	static const char _zeros[8] = { 0 };
+	os.write((const char*)data, bytes);
+	os.write(_zeros, binaryAlign(bytes) - bytes);
+}
+
+bool parser::DungAF2Binary(const DungAF& daf, const std::string& fileName, bool withMatrix /*= false*/)
+{
+	std::ofstream _outfile(fileName.c_str(), ios_base::out | ios_base::binary);
+	if (!_outfile) {
+		cerr << "Can not open the file: " << fileName << endl;
+		return false;
+	}
+
+	const size_type _n = daf.getNumberOfArguments();
+	vector<string> _labels = daf.getArgumentLabels();
+	sparsematrix _atk = daf.getSparseAttackMatrix();
+
+	// The labels
+	vector<uint64_t> _label_off(_n + 1, 0);
+	for (size_type i = 0; i < _n; ++i)
+		_label_off[i+1] = _label_off[i] + _labels[i].size();
+
+	// The attacks of the argument i are the column i of the attack matrix
+	vector<uint64_t> _atk_ptr(_n + 1, 0);
+	vector<uint32_t> _atk_idx;
+	_atk_idx.reserve(_atk.nnz());
+	for (size_type i = 0; i < _n; ++i) {
+		_atk_idx.insert(_atk_idx.end(), _atk.col_begin(i), _atk.col_end(i));
+		_atk_ptr[i+1] = _atk_idx.size();
+	}
+
+	BinaryAFHeader _hd;
+	memset(&_hd, 0, sizeof(_hd));
+	memcpy(_hd.magic, BIN_MAGIC, sizeof(BIN_MAGIC));
+	_hd.version = BIN_VERSION;
+	_hd.flags = (withMatrix && _n > 0) ? BIN_DENSE_MATRIX : 0;
+	_hd.num_args = _n;
+	_hd.num_attacks = _atk_idx.size();
+	_hd.label_bytes = _label_off[_n];
+	_hd.matrix_blocks = (_hd.flags & BIN_DENSE_MATRIX) ? (_n + 63) / 64 : 0;
+	_hd.byte_order = BIN_BYTE_ORDER;
+
+	string _label_chars;
+	_label_chars.reserve(_label_off[_n]);
+	for (size_type i = 0; i < _n; ++i)
+		_label_chars += _labels[i];
+
+	writeSection(_outfile, &_hd, sizeof(_hd));
+	writeSection(_outfile, _label_off.data(), _label_off.size() * 8);
+	writeSection(_outfile, _label_chars.data(), _label_chars.size());
+	writeSection(_outfile, _atk_ptr.data(), _atk_ptr.size() * 8);
+	writeSection(_outfile, _atk_idx.data(), _atk_idx.size() * 4);
+
+	if (_hd.flags & BIN_DENSE_MATRIX) {
+		assert(bitvector::bits_per_block == 64);
+		bitmatrix _bm = daf.hasAttackMatrix() ? daf.getAttackMatrix() : _atk.toBitmatrix();
+		for (size_type i = 0; i < _n; ++i)
+			_outfile.write((const char*)_bm[i].blocks(), _hd.matrix_blocks * sizeof(block_type));
+	}
+
+	return (bool)_outfile;
+} // DungAF2Binary(const DungAF& daf, const std::string& fileName, bool withMatrix)
+
 } // namespace argumatrix
 
 
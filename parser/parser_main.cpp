@@ -2,6 +2,9 @@
 #include <fstream>
 #include <string.h>
 #include <iostream> 
+#include <sstream>
+#include <algorithm>
+#include <cstdio>
 
 #include "bitmatrix/bitmatrix.hpp"
 #include "dung_theory/ArgumentProperty.hpp"
@@ -19,8 +22,210 @@ using namespace boost;
 using namespace argumatrix;
 
 
+// Whether the frameworks have the same labels in the same order, and the
+// same attacks
+bool sameDungAF(const DungAF& daf1, const DungAF& daf2)
+{
+	if (daf1.getArgumentLabels() != daf2.getArgumentLabels())
+		return false;
+
+	sparsematrix _atk1 = daf1.getSparseAttackMatrix();
+	sparsematrix _atk2 = daf2.getSparseAttackMatrix();
+	for (size_type i = 0; i < daf1.getNumberOfArguments(); ++i) {
+		vector<size_type> _col1(_atk1.col_begin(i), _atk1.col_end(i));
+		vector<size_type> _col2(_atk2.col_begin(i), _atk2.col_end(i));
+		std::sort(_col1.begin(), _col1.end());
+		std::sort(_col2.begin(), _col2.end());
+		if (_col1 != _col2)
+			return false;
+	}
+	return true;
+}
+
+void writeFile(const string& fileName, const string& content)
+{
+	ofstream _ofs(fileName.c_str(), ios_base::out | ios_base::binary);
+	_ofs << content;
+}
+
+string readFile(const string& fileName)
+{
+	ifstream _ifs(fileName.c_str(), ios_base::in | ios_base::binary);
+	stringstream _ss;
+	_ss << _ifs.rdbuf();
+	return _ss.str();
+}
+
+/**
+ * Write random frameworks in the Aspartix and the trivial graph formats, with
+ * random white spaces and line endings, and read them back; then write each
+ * one as a binary snapshot, with and without the dense matrix, and load it.
+ * @return the number of the files which are not read back as written.
+ */
+size_type Test1_RoundTrip(unsigned int seed, size_type rounds)
+{
+	const char* _spaces[] = { "", " ", "\t", "  " };
+	const char* _label_chars = "abcXYZ019_";
+
+	srand(seed);
+	size_type _errors = 0;
+	for (size_type r = 0; r < rounds; ++r) {
+		DungAF daf;
+		const size_type n = rand() % 40;
+		for (size_type i = 0; i < n; ++i) {
+			string _label = _label_chars[rand() % 10] + std::to_string(i);
+			daf.addArgument(_label);
+		}
+		for (size_type k = 0; n > 0 && k < 2 * n; ++k)
+			daf.addAttack(Argument(rand() % n), Argument(rand() % n));
+
+		vector<string> _labels = daf.getArgumentLabels();
+		sparsematrix _atk = daf.getSparseAttackMatrix();
+
+		string _apx, _tgf;
+		for (size_type i = 0; i < n; ++i) {
+			_apx += string(_spaces[rand() % 4]) + "arg(" + _spaces[rand() % 4]
+				+ _labels[i] + _spaces[rand() % 4] + ")." + (rand() % 2 ? "\r\n" : "\n");
+			_tgf += _labels[i] + "\n";
+		}
+		_apx += "\n";
+		_tgf += "#\n";
+		for (size_type i = 0; i < n; ++i) {
+			for (sparsematrix::const_iterator j = _atk.col_begin(i); j != _atk.col_end(i); ++j) {
+				_apx += "att(" + string(_spaces[rand() % 4]) + _labels[i]
+					+ _spaces[rand() % 4] + "," + _spaces[rand() % 4]
+					+ _labels[*j] + _spaces[rand() % 4] + ")." + (rand() % 2 ? "\r\n" : "\n");
+				_tgf += _labels[i] + _spaces[rand() % 3 + 1] + _labels[*j] + "\n";
+			}
+		}
+
+		DungAF _loaded;
+		writeFile("parser_test.apx", _apx);
+		if (!parser::Aspartix2DungAF("parser_test.apx", _loaded) || !sameDungAF(daf, _loaded))
+			++_errors;
+
+		writeFile("parser_test.tgf", _tgf);
+		if (!parser::TrivialGraph2DungAF("parser_test.tgf", _loaded) || !sameDungAF(daf, _loaded))
+			++_errors;
+
+		for (int _withMatrix = 0; _withMatrix < 2; ++_withMatrix) {
+			if (!parser::DungAF2Binary(daf, "parser_test.bin", _withMatrix != 0) ||
+				!parser::Binary2DungAF("parser_test.bin", _loaded) ||
+				!sameDungAF(daf, _loaded) ||
+				_loaded.hasAttackMatrix() != (_withMatrix && n > 0)) {
+				++_errors;
+				continue;
+			}
+			if (_loaded.hasAttackMatrix()) {
+				bitmatrix _bm = daf.getAttackMatrix(), _bm2 = _loaded.getAttackMatrix();
+				for (size_type i = 0; i < n; ++i)
+					if (memcmp(_bm[i].blocks(), _bm2[i].blocks(),
+						(n + 63) / 64 * sizeof(block_type)) != 0) {
+						++_errors;
+						break;
+					}
+			}
+		}
+	}
+
+	std::remove("parser_test.apx");
+	std::remove("parser_test.tgf");
+	std::remove("parser_test.bin");
+
+	cout << "Round trip: " << rounds << " frameworks, "
+		<< _errors << " files not read back as written" << endl;
+	return _errors;
+}
+
+/**
+ * Corrupt a binary snapshot in several ways, each of which must be rejected
+ * by Binary2DungAF(), as well as a malformed Aspartix file.
+ * @return the number of the corrupted files which are accepted.
+ */
+size_type Test2_MalformedFiles()
+{
+	DungAF daf;
+	const size_type n = 5;
+	for (size_type i = 0; i < n; ++i)
+		daf.addArgument("a" + std::to_string(i));
+	for (size_type i = 0; i < n; ++i)
+		daf.addAttack(Argument(i), Argument((i + 1) % n));
+	const size_type m = n;
+
+	parser::DungAF2Binary(daf, "parser_test.bin", true);
+	const string _valid = readFile("parser_test.bin");
+
+	// The offsets of the sections, as in Binary2DungAF()
+	const size_type _off_label_off = binaryAlign(sizeof(BinaryAFHeader));
+	const size_type _off_labels = _off_label_off + binaryAlign((n+1)*8);
+	const size_type _off_ptr = _off_labels + binaryAlign(2*n);
+	const size_type _off_idx = _off_ptr + binaryAlign((n+1)*8);
+
+	typedef std::function<void(string&)> Corruption;
+	vector< pair<string, Corruption> > _cases;
+	_cases.push_back(make_pair("bad magic", Corruption([](string& s) {
+		s[0] = 'X'; })));
+	_cases.push_back(make_pair("bad version", Corruption([](string& s) {
+		((BinaryAFHeader*)&s[0])->version += 1; })));
+	_cases.push_back(make_pair("bad byte order", Corruption([](string& s) {
+		((BinaryAFHeader*)&s[0])->byte_order = 0x0807060504030201ULL; })));
+	_cases.push_back(make_pair("too many arguments", Corruption([](string& s) {
+		((BinaryAFHeader*)&s[0])->num_args = 0x100000000ULL; })));
+	_cases.push_back(make_pair("bad matrix blocks", Corruption([](string& s) {
+		((BinaryAFHeader*)&s[0])->matrix_blocks = 2; })));
+	_cases.push_back(make_pair("short header", Corruption([](string& s) {
+		s.resize(sizeof(BinaryAFHeader) - 1); })));
+	_cases.push_back(make_pair("truncated", Corruption([](string& s) {
+		s.resize(s.size() - 1); })));
+	_cases.push_back(make_pair("bad label offsets", Corruption([&](string& s) {
+		((uint64_t*)&s[_off_label_off])[n] += 1; })));
+	_cases.push_back(make_pair("decreasing label offsets", Corruption([&](string& s) {
+		((uint64_t*)&s[_off_label_off])[1] = 5; })));
+	_cases.push_back(make_pair("bad attack offsets", Corruption([&](string& s) {
+		((uint64_t*)&s[_off_ptr])[n] = m + 1; })));
+	_cases.push_back(make_pair("decreasing attack offsets", Corruption([&](string& s) {
+		((uint64_t*)&s[_off_ptr])[1] = 3; })));
+	_cases.push_back(make_pair("bad attack index", Corruption([&](string& s) {
+		((uint32_t*)&s[_off_idx])[0] = n; })));
+	_cases.push_back(make_pair("duplicate labels", Corruption([&](string& s) {
+		s[_off_labels + 3] = '0'; })));
+
+	size_type _errors = 0;
+	DungAF _loaded;
+	if (!parser::Binary2DungAF("parser_test.bin", _loaded) || !sameDungAF(daf, _loaded)) {
+		cout << "The valid snapshot is rejected" << endl;
+		++_errors;
+	}
+	for (size_type c = 0; c < _cases.size(); ++c) {
+		string _bytes = _valid;
+		_cases[c].second(_bytes);
+		writeFile("parser_test.bin", _bytes);
+		if (parser::Binary2DungAF("parser_test.bin", _loaded)) {
+			cout << "The snapshot with " << _cases[c].first << " is accepted" << endl;
+			++_errors;
+		}
+	}
+
+	writeFile("parser_test.apx", "arg(a0).\narg(a1).\natt(a0 a1).\n");
+	if (parser::Aspartix2DungAF("parser_test.apx", _loaded)) {
+		cout << "The malformed Aspartix file is accepted" << endl;
+		++_errors;
+	}
+
+	std::remove("parser_test.apx");
+	std::remove("parser_test.bin");
+
+	cout << "Malformed files: " << _cases.size() + 1 << " files, "
+		<< _errors << " accepted" << endl;
+	return _errors;
+}
+
+
 int main(int argc, char* argv[])
 {
+	if (Test1_RoundTrip(2016, 200) > 0 || Test2_MalformedFiles() > 0)
+		return 1;
+
 	uint64_t BegainTime ;     
 	uint64_t EndTime ;     
 